@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "AudioCaptureConverter.h"
+
+namespace WebRTC
+{
+    namespace
+    {
+        const int MaxChannels = 8;
+        //-3dB, the ITU-R BS.775 weight for the center and surround channels
+        const float MinusThreeDb = 0.7071068f;
+    }
+
+    AudioCaptureConverter::AudioCaptureConverter(int outputSampleRate, int outputChannels)
+        : outputSampleRate(outputSampleRate)
+        , outputChannels(outputChannels)
+        , output(outputSampleRate / 100 * outputChannels)
+    {
+    }
+
+    bool AudioCaptureConverter::IsSupportedFormat(int sampleRate, int channels)
+    {
+        //the resampler works on 10ms blocks, which have to hold a whole number of frames
+        return sampleRate >= 8000 && sampleRate <= 384000 && sampleRate % 100 == 0
+            && channels >= 1 && channels <= MaxChannels;
+    }
+
+    bool AudioCaptureConverter::SetInputFormat(int sampleRate, int channels)
+    {
+        if (sampleRate == inputSampleRate && channels == inputChannels)
+        {
+            return true;
+        }
+        if (!IsSupportedFormat(sampleRate, channels))
+        {
+            LogPrint("unsupported audio format %d Hz %d channels", sampleRate, channels);
+            return false;
+        }
+        if (resampler.InitializeIfNeeded(sampleRate, outputSampleRate, outputChannels) != 0)
+        {
+            LogPrint("failed to initialize the resampler for %d Hz", sampleRate);
+            return false;
+        }
+        inputSampleRate = sampleRate;
+        inputChannels = channels;
+        //a partial block of the previous format can't be mixed with the new one
+        inputSize = 0;
+        input.resize(sampleRate / 100 * channels);
+        mixed.resize(sampleRate / 100 * outputChannels);
+        return true;
+    }
+
+    const float* AudioCaptureConverter::ConvertBlock()
+    {
+        const size_t frames = input.size() / inputChannels;
+        const float* src = input.data();
+        if (inputChannels != outputChannels)
+        {
+            MixChannels(input.data(), inputChannels, mixed.data(), outputChannels, frames);
+            src = mixed.data();
+        }
+        resampler.Resample(src, frames * outputChannels, output.data(), output.size());
+        return output.data();
+    }
+
+    void AudioCaptureConverter::MixChannels(const float* src, int srcChannels, float* dst, int dstChannels, size_t frames)
+    {
+        if (srcChannels == dstChannels)
+        {
+            std::copy(src, src + frames * srcChannels, dst);
+            return;
+        }
+        for (size_t i = 0; i < frames; i++, src += srcChannels, dst += dstChannels)
+        {
+            float left = 0.0f;
+            float right = 0.0f;
+            switch (srcChannels)
+            {
+            case 1:
+                left = right = src[0];
+                break;
+            case 2:
+                left = src[0];
+                right = src[1];
+                break;
+            case 4:
+                //FL FR BL BR
+                left = (src[0] + MinusThreeDb * src[2]) / (1.0f + MinusThreeDb);
+                right = (src[1] + MinusThreeDb * src[3]) / (1.0f + MinusThreeDb);
+                break;
+            case 5:
+            {
+                //FL FR FC BL BR, Unity's Surround mode has no LFE
+                const float center = MinusThreeDb * src[2];
+                const float norm = 1.0f + 2.0f * MinusThreeDb;
+                left = (src[0] + center + MinusThreeDb * src[3]) / norm;
+                right = (src[1] + center + MinusThreeDb * src[4]) / norm;
+                break;
+            }
+            default:
+            {
+                //FL FR FC LFE followed by surround pairs, the LFE is dropped as in ITU-R BS.775
+                float surroundLeft = 0.0f;
+                float surroundRight = 0.0f;
+                const int pairs = (srcChannels - 4) / 2;
+                for (int pair = 0; pair < pairs; pair++)
+                {
+                    surroundLeft += src[4 + pair * 2];
+                    surroundRight += src[5 + pair * 2];
+                }
+                if (pairs > 0)
+                {
+                    surroundLeft /= pairs;
+                    surroundRight /= pairs;
+                }
+                const float center = srcChannels > 2 ? MinusThreeDb * src[2] : 0.0f;
+                const float norm = 1.0f + MinusThreeDb + (pairs > 0 ? MinusThreeDb : 0.0f);
+                left = (src[0] + center + MinusThreeDb * surroundLeft) / norm;
+                right = (src[1] + center + MinusThreeDb * surroundRight) / norm;
+                break;
+            }
+            }
+
+            if (dstChannels == 1)
+            {
+                dst[0] = (left + right) * 0.5f;
+            }
+            else
+            {
+                dst[0] = left;
+                dst[1] = right;
+                //upmixing beyond stereo leaves the other speakers silent
+                std::fill(dst + 2, dst + dstChannels, 0.0f);
+            }
+        }
+    }
+}
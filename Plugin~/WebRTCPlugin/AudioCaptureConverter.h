@@ -0,0 +1,69 @@
+#pragma once
+
+#include "common_audio/resampler/include/push_resampler.h"
+
+namespace WebRTC
+{
+    // AudioCaptureConverter turns the audio Unity hands to ProcessAudio, at whatever sample rate
+    // and channel layout the title runs, into the format the recording device delivers to webrtc.
+    // Input is gathered into 10ms blocks, mixed to the output channel count at the input rate,
+    // then resampled by webrtc::PushResampler which keeps its filter state across blocks.
+    class AudioCaptureConverter
+    {
+    public:
+        AudioCaptureConverter(int outputSampleRate, int outputChannels);
+
+        // Sample rates have to be a multiple of 100Hz, 22050 and 11025Hz are not supported.
+        static bool IsSupportedFormat(int sampleRate, int channels);
+
+        // Calls onBlock with every completed 10ms block of interleaved output samples.
+        // Returns false if the input format is not supported, the data is dropped in that case.
+        template<typename OnBlock>
+        bool Process(const float* data, size_t size, int sampleRate, int channels, OnBlock onBlock)
+        {
+            if (!SetInputFormat(sampleRate, channels))
+            {
+                return false;
+            }
+            const size_t blockSize = input.size();
+            while (size > 0)
+            {
+                const size_t count = std::min(size, blockSize - inputSize);
+                std::copy(data, data + count, input.begin() + inputSize);
+                inputSize += count;
+                data += count;
+                size -= count;
+                if (inputSize == blockSize)
+                {
+                    inputSize = 0;
+                    onBlock(ConvertBlock(), output.size());
+                }
+            }
+            return true;
+        }
+
+        // Mixes interleaved frames between channel layouts in Unity's speaker order
+        // (FL, FR, FC, LFE, back and side channels, 5 channels are FL, FR, FC, BL, BR).
+        static void MixChannels(const float* src, int srcChannels, float* dst, int dstChannels, size_t frames);
+
+        int GetOutputSampleRate() const { return outputSampleRate; }
+        int GetInputSampleRate() const { return inputSampleRate; }
+        int GetInputChannels() const { return inputChannels; }
+
+    private:
+        bool SetInputFormat(int sampleRate, int channels);
+        const float* ConvertBlock();
+
+        const int outputSampleRate;
+        const int outputChannels;
+        int inputSampleRate = 0;
+        int inputChannels = 0;
+        webrtc::PushResampler<float> resampler;
+        //10ms of interleaved input, filled across calls
+        std::vector<float> input;
+        size_t inputSize = 0;
+        //10ms of input mixed to the output channel count
+        std::vector<float> mixed;
+        std::vector<float> output;
+    };
+}
@@ -0,0 +1,41 @@
+#include "pch.h"
+#include "AudioPlayoutSink.h"
+
+namespace WebRTC
+{
+    size_t AudioPlayoutSink::MixInto(float* data, size_t size)
+    {
+        output.resize(std::max(output.size(), size));
+        const size_t read = buffer.Read(output.data(), size);
+        for (size_t i = 0; i < read; i++)
+        {
+            data[i] += output[i];
+        }
+        return read;
+    }
+
+    void AudioPlayoutSink::OnData(const void* audio_data, int bits_per_sample, int sample_rate,
+        size_t number_of_channels, size_t number_of_frames)
+    {
+        if (bits_per_sample != 16)
+        {
+            return;
+        }
+        const int16* samples = static_cast<const int16*>(audio_data);
+        const size_t size = number_of_channels * number_of_frames;
+        if (sample_rate == SampleRate && number_of_channels == Channels)
+        {
+            buffer.Write(samples, size);
+            return;
+        }
+        input.resize(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            input[i] = samples[i] / 32768.0f;
+        }
+        converter.Process(input.data(), size, sample_rate, static_cast<int>(number_of_channels), [this](const float* block, size_t blockSize)
+        {
+            buffer.Write(block, blockSize);
+        });
+    }
+}
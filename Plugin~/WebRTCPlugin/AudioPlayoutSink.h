@@ -0,0 +1,35 @@
+#pragma once
+
+#include "api/media_stream_interface.h"
+#include "AudioRingBuffer.h"
+#include "AudioCaptureConverter.h"
+
+namespace WebRTC
+{
+    // AudioPlayoutSink is attached to a remote audio track and buffers its decoded audio as
+    // 48kHz stereo for the context which owns the connection. The audio device pulls the remote
+    // streams of every connection of the factory, each context only reads the sinks of its own.
+    // OnData is called on the playout thread, MixInto on the application's audio thread.
+    class AudioPlayoutSink : public webrtc::AudioTrackSinkInterface
+    {
+    public:
+        static const int SampleRate = 48000;
+        static const int Channels = 2;
+
+        // Adds up to size buffered samples to data, returns how many were added.
+        size_t MixInto(float* data, size_t size);
+
+        //webrtc::AudioTrackSinkInterface
+        void OnData(const void* audio_data, int bits_per_sample, int sample_rate,
+            size_t number_of_channels, size_t number_of_frames) override;
+
+    private:
+        //200ms, the reader drains every audio callback
+        AudioRingBuffer buffer { SampleRate * Channels / 5 };
+        AudioCaptureConverter converter { SampleRate, Channels };
+        //used by the playout thread
+        std::vector<float> input;
+        //used by the reader
+        std::vector<float> output;
+    };
+}
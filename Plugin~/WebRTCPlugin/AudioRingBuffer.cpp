@@ -0,0 +1,179 @@
+#include "pch.h"
+#include "AudioRingBuffer.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WEBRTC_AUDIO_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define WEBRTC_AUDIO_NEON
+#include <arm_neon.h>
+#endif
+
+namespace WebRTC
+{
+#if defined(WEBRTC_AUDIO_NEON)
+    namespace
+    {
+        //rounds to nearest like _mm_cvtps_epi32 and lrintf, vcvtq_s32_f32 would truncate toward zero
+        inline int32x4_t RoundToInt32(float32x4_t value)
+        {
+#if defined(__aarch64__) || defined(_M_ARM64)
+            return vcvtnq_s32_f32(value);
+#else
+            //ARMv7 has no rounding conversion, add a half away from zero before truncating
+            const uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(value), vdupq_n_u32(0x80000000u));
+            const float32x4_t half = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(0.5f)), sign));
+            return vcvtq_s32_f32(vaddq_f32(value, half));
+#endif
+        }
+    }
+#endif
+
+    void ConvertFloatToInt16(const float* src, int16* dst, size_t count)
+    {
+        //scale by 32768 and let the saturating pack clamp 1.0 to 32767
+        const float scale = 32768.0f;
+        size_t i = 0;
+#if defined(WEBRTC_AUDIO_SSE2)
+        const __m128 vscale = _mm_set1_ps(scale);
+        //clamp before converting, out of range floats would otherwise turn into INT_MIN
+        const __m128 vmin = _mm_set1_ps(-1.0f);
+        const __m128 vmax = _mm_set1_ps(1.0f);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128 a = _mm_loadu_ps(src + i);
+            __m128 b = _mm_loadu_ps(src + i + 4);
+            a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(a, vmin), vmax), vscale);
+            b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(b, vmin), vmax), vscale);
+            const __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+        }
+#elif defined(WEBRTC_AUDIO_NEON)
+        const float32x4_t vmin = vdupq_n_f32(-1.0f);
+        const float32x4_t vmax = vdupq_n_f32(1.0f);
+        for (; i + 8 <= count; i += 8)
+        {
+            float32x4_t a = vld1q_f32(src + i);
+            float32x4_t b = vld1q_f32(src + i + 4);
+            a = vmulq_n_f32(vminq_f32(vmaxq_f32(a, vmin), vmax), scale);
+            b = vmulq_n_f32(vminq_f32(vmaxq_f32(b, vmin), vmax), scale);
+            const int16x8_t packed = vcombine_s16(vqmovn_s32(RoundToInt32(a)), vqmovn_s32(RoundToInt32(b)));
+            vst1q_s16(dst + i, packed);
+        }
+#endif
+        for (; i < count; i++)
+        {
+            const float value = std::min(std::max(src[i], -1.0f), 1.0f) * scale;
+            dst[i] = static_cast<int16>(std::min(std::max(std::lrintf(value), static_cast<long>(SHRT_MIN)), static_cast<long>(SHRT_MAX)));
+        }
+    }
+
+    void ConvertInt16ToFloat(const int16* src, float* dst, size_t count)
+    {
+        //simple enough for the compiler to vectorize
+        const float scale = 1.0f / 32768.0f;
+        for (size_t i = 0; i < count; i++)
+        {
+            dst[i] = src[i] * scale;
+        }
+    }
+
+    namespace
+    {
+        void CopySamples(const float* src, int16* dst, size_t count)
+        {
+            ConvertFloatToInt16(src, dst, count);
+        }
+
+        void CopySamples(const int16* src, int16* dst, size_t count)
+        {
+            std::copy(src, src + count, dst);
+        }
+    }
+
+    AudioRingBuffer::AudioRingBuffer(size_t capacity) : buffer(capacity)
+    {
+    }
+
+    size_t AudioRingBuffer::Write(const float* data, size_t count)
+    {
+        return WriteSamples(data, count);
+    }
+
+    size_t AudioRingBuffer::Write(const int16* data, size_t count)
+    {
+        return WriteSamples(data, count);
+    }
+
+    template<typename T>
+    size_t AudioRingBuffer::WriteSamples(const T* data, size_t count)
+    {
+        const uint64 write = writePosition.load(std::memory_order_relaxed);
+        const uint64 read = readPosition.load(std::memory_order_acquire);
+        const size_t space = buffer.size() - static_cast<size_t>(write - read);
+        const size_t written = std::min(count, space);
+        if (written < count)
+        {
+            droppedSamples += count - written;
+        }
+
+        const size_t index = static_cast<size_t>(write % buffer.size());
+        const size_t first = std::min(written, buffer.size() - index);
+        CopySamples(data, buffer.data() + index, first);
+        CopySamples(data + first, buffer.data(), written - first);
+        writePosition.store(write + written, std::memory_order_release);
+        return written;
+    }
+
+    const int16* AudioRingBuffer::Peek(size_t count)
+    {
+        const uint64 read = readPosition.load(std::memory_order_relaxed);
+        const uint64 write = writePosition.load(std::memory_order_acquire);
+        if (write - read < count || count > buffer.size())
+        {
+            return nullptr;
+        }
+        const size_t index = static_cast<size_t>(read % buffer.size());
+        const size_t first = buffer.size() - index;
+        if (count <= first)
+        {
+            return buffer.data() + index;
+        }
+        chunk.resize(count);
+        std::copy(buffer.begin() + index, buffer.end(), chunk.begin());
+        std::copy(buffer.begin(), buffer.begin() + (count - first), chunk.begin() + first);
+        return chunk.data();
+    }
+
+    void AudioRingBuffer::Consume(size_t count)
+    {
+        const uint64 read = readPosition.load(std::memory_order_relaxed);
+        const uint64 write = writePosition.load(std::memory_order_acquire);
+        readPosition.store(read + std::min<uint64>(count, write - read), std::memory_order_release);
+    }
+
+    size_t AudioRingBuffer::Read(float* data, size_t count)
+    {
+        const uint64 read = readPosition.load(std::memory_order_relaxed);
+        const uint64 write = writePosition.load(std::memory_order_acquire);
+        const size_t readable = std::min(count, static_cast<size_t>(write - read));
+
+        const size_t index = static_cast<size_t>(read % buffer.size());
+        const size_t first = std::min(readable, buffer.size() - index);
+        ConvertInt16ToFloat(buffer.data() + index, data, first);
+        ConvertInt16ToFloat(buffer.data(), data + first, readable - first);
+        readPosition.store(read + readable, std::memory_order_release);
+        return readable;
+    }
+
+    size_t AudioRingBuffer::GetReadableSize() const
+    {
+        return static_cast<size_t>(writePosition.load(std::memory_order_acquire) - readPosition.load(std::memory_order_acquire));
+    }
+
+    void AudioRingBuffer::Clear()
+    {
+        //called by the consumer, drops everything buffered so far
+        readPosition.store(writePosition.load(std::memory_order_acquire), std::memory_order_release);
+    }
+}
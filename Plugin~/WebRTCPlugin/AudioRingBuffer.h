@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+namespace WebRTC
+{
+    // Converts float samples in [-1, 1] to int16 with saturation, vectorized with SSE2 or NEON when available.
+    void ConvertFloatToInt16(const float* src, int16* dst, size_t count);
+    void ConvertInt16ToFloat(const int16* src, float* dst, size_t count);
+
+    // AudioRingBuffer is a preallocated single producer, single consumer ring of int16 samples.
+    // On the capture side the producer converts float samples straight into the ring and the consumer
+    // reads fixed size chunks; when the capacity is a multiple of the chunk size, they are read in place.
+    // On the playout side webrtc's int16 chunks go in and the application drains floats in any block size.
+    class AudioRingBuffer
+    {
+    public:
+        explicit AudioRingBuffer(size_t capacity);
+
+        // Producer side, returns the number of samples written; samples which don't fit are dropped.
+        size_t Write(const float* data, size_t count);
+        size_t Write(const int16* data, size_t count);
+
+        // Consumer side, returns nullptr if fewer than count samples are buffered.
+        // The pointer is valid until Consume is called.
+        const int16* Peek(size_t count);
+        void Consume(size_t count);
+        // Consumer side, reads up to count samples and returns how many were read.
+        size_t Read(float* data, size_t count);
+
+        size_t GetReadableSize() const;
+        size_t GetCapacity() const { return buffer.size(); }
+        uint64 GetDroppedSampleCount() const { return droppedSamples; }
+        void Clear();
+
+    private:
+        template<typename T>
+        size_t WriteSamples(const T* data, size_t count);
+
+        std::vector<int16> buffer;
+        //only used when a chunk wraps around the end of the ring
+        std::vector<int16> chunk;
+        //monotonic positions, the index into the ring is the position modulo the capacity
+        std::atomic<uint64> writePosition {0};
+        std::atomic<uint64> readPosition {0};
+        std::atomic<uint64> droppedSamples {0};
+    };
+}
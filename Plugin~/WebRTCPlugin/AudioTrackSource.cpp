@@ -0,0 +1,174 @@
+#include "pch.h"
+#include "AudioTrackSource.h"
+
+namespace WebRTC
+{
+    namespace
+    {
+        const size_t FramesPerChunk = AudioTrackSource::ChunkSize / AudioTrackSource::Channels;
+        //small requests keep the latency of the drift resampler low, they have to exceed its kernel
+        const size_t ResamplerRequestFrames = 160;
+        //the drift between audio clocks is a few hundred ppm, leave room for catching up
+        const double MaxRateAdjustment = 0.005;
+        const double ProportionalGain = 0.005;
+        const double IntegralGain = 0.00002;
+        //smooths the fill level over about 200ms, the application pushes in bursts
+        const double SmoothingFactor = 0.05;
+    }
+
+    rtc::scoped_refptr<AudioTrackSource> AudioTrackSource::Create(const cricket::AudioOptions& options)
+    {
+        return new rtc::RefCountedObject<AudioTrackSource>(options);
+    }
+
+    AudioTrackSource::AudioTrackSource(const cricket::AudioOptions& options)
+        : m_options(options)
+        , leftResampler(1.0, ResamplerRequestFrames, &leftReader)
+        , rightResampler(1.0, ResamplerRequestFrames, &rightReader)
+        , left(FramesPerChunk)
+        , right(FramesPerChunk)
+        , output(ChunkSize)
+    {
+    }
+
+    void AudioTrackSource::AddSink(webrtc::AudioTrackSinkInterface* sink)
+    {
+        std::lock_guard<std::mutex> lock(sinksMutex);
+        if (std::find(sinks.begin(), sinks.end(), sink) == sinks.end())
+        {
+            sinks.push_back(sink);
+        }
+    }
+
+    void AudioTrackSource::RemoveSink(webrtc::AudioTrackSinkInterface* sink)
+    {
+        std::lock_guard<std::mutex> lock(sinksMutex);
+        sinks.erase(std::remove(sinks.begin(), sinks.end(), sink), sinks.end());
+    }
+
+    void AudioTrackSource::EnablePacing(bool enable)
+    {
+        paced = enable;
+    }
+
+    void AudioTrackSource::ProcessAudioData(const float* data, int32 size, int32 sampleRate, int32 channels)
+    {
+        if (sampleRate == SampleRate && channels == Channels)
+        {
+            captureBuffer.Write(data, size);
+        }
+        else
+        {
+            converter.Process(data, size, sampleRate, channels, [this](const float* block, size_t blockSize)
+            {
+                captureBuffer.Write(block, blockSize);
+            });
+        }
+        if (paced)
+        {
+            return;
+        }
+
+        while (const int16* chunk = captureBuffer.Peek(ChunkSize))
+        {
+            DeliverChunk(chunk);
+            captureBuffer.Consume(ChunkSize);
+        }
+    }
+
+    void AudioTrackSource::DeliverChunk(const int16* chunk)
+    {
+        std::lock_guard<std::mutex> lock(sinksMutex);
+        for (auto sink : sinks)
+        {
+            sink->OnData(chunk, 16, SampleRate, Channels, FramesPerChunk);
+        }
+    }
+
+    void AudioTrackSource::DeliverPacedAudio()
+    {
+        if (!paced)
+        {
+            return;
+        }
+        const size_t frames = captureBuffer.GetReadableSize() / Channels;
+        fillFrames = frames;
+        if (!primed)
+        {
+            //wait for the target level before starting, and after running dry
+            if (frames * 1000 < static_cast<size_t>(TargetFillLevelMs * SampleRate))
+            {
+                return;
+            }
+            primed = true;
+        }
+        UpdateRatio(frames);
+
+        leftResampler.Resample(FramesPerChunk, left.data());
+        rightResampler.Resample(FramesPerChunk, right.data());
+        for (size_t i = 0; i < FramesPerChunk; i++)
+        {
+            output[i * 2] = left[i];
+            output[i * 2 + 1] = right[i];
+        }
+        ConvertFloatToInt16(output.data(), pacedChunk, ChunkSize);
+        DeliverChunk(pacedChunk);
+    }
+
+    void AudioTrackSource::UpdateRatio(size_t frames)
+    {
+        const double targetFrames = TargetFillLevelMs * SampleRate / 1000.0;
+        const double error = (frames - targetFrames) / targetFrames;
+        smoothedError += SmoothingFactor * (error - smoothedError);
+        integral = std::min(std::max(integral + IntegralGain * smoothedError, -MaxRateAdjustment), MaxRateAdjustment);
+        const double adjustment = std::min(std::max(ProportionalGain * smoothedError + integral, -MaxRateAdjustment), MaxRateAdjustment);
+        rateAdjustment = adjustment;
+
+        //a ratio above 1 consumes the input faster than real time and drains the buffer
+        leftResampler.SetRatio(1.0 + adjustment);
+        rightResampler.SetRatio(1.0 + adjustment);
+    }
+
+    void AudioTrackSource::ReadChannel(int channel, size_t frames, float* destination)
+    {
+        if (channel == 0)
+        {
+            interleaved.resize(frames * Channels);
+            const size_t read = captureBuffer.Read(interleaved.data(), frames * Channels);
+            if (read < interleaved.size())
+            {
+                underrunSamples += interleaved.size() - read;
+                std::fill(interleaved.begin() + read, interleaved.end(), 0.0f);
+                primed = false;
+            }
+            //both resamplers run with the same ratio and ask for the same frames, keep the right channel for the second one
+            if (pendingRightOffset == pendingRight.size())
+            {
+                pendingRight.clear();
+                pendingRightOffset = 0;
+            }
+            for (size_t i = 0; i < frames; i++)
+            {
+                destination[i] = interleaved[i * 2];
+                pendingRight.push_back(interleaved[i * 2 + 1]);
+            }
+            return;
+        }
+
+        const size_t available = std::min(frames, pendingRight.size() - pendingRightOffset);
+        std::copy(pendingRight.begin() + pendingRightOffset, pendingRight.begin() + pendingRightOffset + available, destination);
+        std::fill(destination + available, destination + frames, 0.0f);
+        pendingRightOffset += available;
+    }
+
+    AudioCaptureStats AudioTrackSource::GetCaptureStats() const
+    {
+        AudioCaptureStats stats;
+        stats.fillLevelMs = fillFrames * 1000.0 / SampleRate;
+        stats.targetFillLevelMs = TargetFillLevelMs;
+        stats.rateAdjustmentPpm = rateAdjustment * 1e6;
+        stats.underrunSamples = underrunSamples;
+        stats.overrunSamples = captureBuffer.GetDroppedSampleCount();
+        return stats;
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <mutex>
+
+#include "api/media_stream_interface.h"
+#include "api/notifier.h"
+#include "common_audio/resampler/sinc_resampler.h"
+#include "AudioRingBuffer.h"
+#include "AudioCaptureConverter.h"
+
+namespace WebRTC
+{
+    struct AudioCaptureStats
+    {
+        //audio buffered between the application's audio thread and the paced delivery
+        double fillLevelMs = 0;
+        double targetFillLevelMs = 0;
+        //how much faster than real time the buffered audio is consumed to hold the fill level
+        double rateAdjustmentPpm = 0;
+        //silence inserted because the application didn't push audio in time
+        uint64 underrunSamples = 0;
+        //samples dropped because the buffer was full
+        uint64 overrunSamples = 0;
+    };
+
+    // AudioTrackSource feeds one local audio track with the samples the application pushes
+    // through ProcessAudio. Each source has its own capture buffer and hands 10ms of 48kHz
+    // stereo to the sinks of its track, so every track is encoded and sent separately.
+    // ProcessAudioData is called on the application's audio thread, sinks are added and
+    // removed on the worker thread.
+    //
+    // By default chunks are delivered as soon as they are complete. When pacing is enabled,
+    // ProcessAudioData only buffers and DeliverPacedAudio, called every 10ms on a steady clock,
+    // delivers one chunk. The application's audio clock drifts against that clock, so the
+    // buffered audio is resampled by a ratio which holds the fill level at the target.
+    class AudioTrackSource : public webrtc::Notifier<webrtc::AudioSourceInterface>
+    {
+    public:
+        static rtc::scoped_refptr<AudioTrackSource> Create(const cricket::AudioOptions& options);
+
+        // data holds interleaved samples in any sample rate and channel layout.
+        void ProcessAudioData(const float* data, int32 size, int32 sampleRate, int32 channels);
+
+        void EnablePacing(bool enable);
+        // Called every 10ms by the capture pacer, does nothing unless pacing is enabled.
+        void DeliverPacedAudio();
+        AudioCaptureStats GetCaptureStats() const;
+
+        //webrtc::AudioSourceInterface
+        SourceState state() const override { return kLive; }
+        bool remote() const override { return false; }
+        const cricket::AudioOptions options() const override { return m_options; }
+        void AddSink(webrtc::AudioTrackSinkInterface* sink) override;
+        void RemoveSink(webrtc::AudioTrackSinkInterface* sink) override;
+
+        static const int SampleRate = 48000;
+        static const int Channels = 2;
+        //10ms of interleaved samples, the unit webrtc consumes audio in
+        static const size_t ChunkSize = SampleRate * Channels / 100;
+        static const int TargetFillLevelMs = 30;
+
+    protected:
+        explicit AudioTrackSource(const cricket::AudioOptions& options);
+
+    private:
+        //pulls the input of the drift resampler of one channel
+        class ChannelReader : public webrtc::SincResamplerCallback
+        {
+        public:
+            ChannelReader(AudioTrackSource* owner, int channel) : owner(owner), channel(channel) {}
+            void Run(size_t frames, float* destination) override { owner->ReadChannel(channel, frames, destination); }
+        private:
+            AudioTrackSource* const owner;
+            const int channel;
+        };
+
+        void ReadChannel(int channel, size_t frames, float* destination);
+        void UpdateRatio(size_t fillFrames);
+        void DeliverChunk(const int16* chunk);
+
+        const cricket::AudioOptions m_options;
+        std::mutex sinksMutex;
+        std::vector<webrtc::AudioTrackSinkInterface*> sinks;
+        //capacity is a multiple of the chunk size so chunks are delivered in place
+        AudioRingBuffer captureBuffer {ChunkSize * 16};
+        AudioCaptureConverter converter {SampleRate, Channels};
+
+        //everything below is only touched by the pacer, except the atomics read by GetCaptureStats
+        std::atomic<bool> paced {false};
+        bool primed = false;
+        ChannelReader leftReader {this, 0};
+        ChannelReader rightReader {this, 1};
+        webrtc::SincResampler leftResampler;
+        webrtc::SincResampler rightResampler;
+        //interleaved input read for the left channel, the right channel is consumed from here
+        std::vector<float> interleaved;
+        std::vector<float> pendingRight;
+        size_t pendingRightOffset = 0;
+        std::vector<float> left;
+        std::vector<float> right;
+        std::vector<float> output;
+        int16 pacedChunk[ChunkSize];
+        double smoothedError = 0;
+        double integral = 0;
+        std::atomic<double> rateAdjustment {0};
+        std::atomic<size_t> fillFrames {0};
+        std::atomic<uint64> underrunSamples {0};
+    };
+}
@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "BroadcastFeedback.h"
+
+namespace WebRTC
+{
+    BroadcastFeedback::BroadcastFeedback(int64 keyFrameIntervalMs) : keyFrameIntervalMs(keyFrameIntervalMs)
+    {
+    }
+
+    void BroadcastFeedback::SetPolicy(BitratePolicy value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        policy = value;
+    }
+
+    BitratePolicy BroadcastFeedback::GetPolicy() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return policy;
+    }
+
+    void BroadcastFeedback::RemoveSubscriber(const void* subscriber)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bitrates.erase(subscriber);
+    }
+
+    size_t BroadcastFeedback::GetSubscriberCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return bitrates.size();
+    }
+
+    void BroadcastFeedback::SetBitrate(const void* subscriber, int layer, uint32 bitrate)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bitrates[subscriber][layer] = bitrate;
+        latestBitrates[layer] = bitrate;
+    }
+
+    uint32 BroadcastFeedback::GetTargetBitrate(int layer) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (policy == BitratePolicy::Latest)
+        {
+            auto latest = latestBitrates.find(layer);
+            return latest == latestBitrates.end() ? 0 : latest->second;
+        }
+
+        std::vector<uint32> rates;
+        std::vector<uint32> topLayerRates;
+        for (const auto& subscriber : bitrates)
+        {
+            auto rate = subscriber.second.find(layer);
+            if (rate == subscriber.second.end() || rate->second == 0)
+            {
+                continue;
+            }
+            rates.push_back(rate->second);
+            //layers are ordered from the lowest, so this is the highest layer the subscriber uses
+            auto top = std::find_if(subscriber.second.rbegin(), subscriber.second.rend(),
+                [](const std::pair<const int, uint32>& item) { return item.second > 0; });
+            if (top->first == layer)
+            {
+                topLayerRates.push_back(rate->second);
+            }
+        }
+        if (rates.empty())
+        {
+            return 0;
+        }
+        switch (policy)
+        {
+        case BitratePolicy::Median:
+        {
+            //lower median, rounding towards the congested half
+            auto median = rates.begin() + (rates.size() - 1) / 2;
+            std::nth_element(rates.begin(), median, rates.end());
+            return *median;
+        }
+        case BitratePolicy::PerLayer:
+            //subscribers only constrain their top layer, unless nobody tops out at this one
+            if (!topLayerRates.empty())
+            {
+                return *std::min_element(topLayerRates.begin(), topLayerRates.end());
+            }
+            return *std::min_element(rates.begin(), rates.end());
+        default:
+            return *std::min_element(rates.begin(), rates.end());
+        }
+    }
+
+    void BroadcastFeedback::RequestKeyFrame()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (keyFramePending)
+        {
+            coalescedKeyFrameRequests++;
+        }
+        keyFramePending = true;
+    }
+
+    bool BroadcastFeedback::ShouldEncodeKeyFrame(int64 nowMs)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!keyFramePending)
+        {
+            return false;
+        }
+        //the first request is served on the next frame, the ones following it within the interval share a key frame
+        if (lastKeyFrameMs && nowMs - *lastKeyFrameMs < keyFrameIntervalMs)
+        {
+            return false;
+        }
+        keyFramePending = false;
+        lastKeyFrameMs = nowMs;
+        return true;
+    }
+
+    uint64 BroadcastFeedback::GetCoalescedKeyFrameRequestCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return coalescedKeyFrameRequests;
+    }
+}
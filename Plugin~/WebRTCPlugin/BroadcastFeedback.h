@@ -0,0 +1,60 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+
+namespace WebRTC
+{
+    enum class BitratePolicy
+    {
+        //the last rate reported by any peer connection wins
+        Latest = 0,
+        //no spectator is sent more than its link can take
+        Minimum = 1,
+        //half of the spectators may be congested, the others get a better picture
+        Median = 2,
+        //each simulcast layer is sized for the spectators it is the top layer of
+        PerLayer = 3,
+    };
+
+    // BroadcastFeedback merges the feedback of the peer connections that share one
+    // capturer, so that many spectators can be served by a single encode.
+    // Bitrates are aggregated per simulcast layer according to the BitratePolicy,
+    // and key frame requests arriving within keyFrameIntervalMs of the last key
+    // frame are coalesced into one.
+    // All methods are thread safe, subscribers are identified by an opaque pointer.
+    class BroadcastFeedback
+    {
+    public:
+        static const int64 DefaultKeyFrameIntervalMs = 500;
+        explicit BroadcastFeedback(int64 keyFrameIntervalMs = DefaultKeyFrameIntervalMs);
+
+        void SetPolicy(BitratePolicy value);
+        BitratePolicy GetPolicy() const;
+
+        void RemoveSubscriber(const void* subscriber);
+        size_t GetSubscriberCount() const;
+
+        // Records the rate a subscriber wants for a layer, 0 means it doesn't use the layer.
+        void SetBitrate(const void* subscriber, int layer, uint32 bitrate);
+        // Returns 0 if no subscriber uses the layer.
+        uint32 GetTargetBitrate(int layer) const;
+
+        void RequestKeyFrame();
+        // Called once per encoded frame, returns true if a key frame has to be encoded now.
+        bool ShouldEncodeKeyFrame(int64 nowMs);
+        uint64 GetCoalescedKeyFrameRequestCount() const;
+
+    private:
+        mutable std::mutex mutex;
+        BitratePolicy policy = BitratePolicy::Latest;
+        //bitrate per layer for each subscriber
+        std::map<const void*, std::map<int, uint32>> bitrates;
+        std::map<int, uint32> latestBitrates;
+
+        const int64 keyFrameIntervalMs;
+        absl::optional<int64> lastKeyFrameMs;
+        bool keyFramePending = false;
+        uint64 coalescedKeyFrameRequests = 0;
+    };
+}
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "Context.h"
+#include "FrameTrace.h"
 #include "IUnityGraphics.h"
 #include "GraphicsDevice/GraphicsDevice.h"
 
@@ -56,12 +57,15 @@ extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UnityPluginUnload()
     s_Graphics->UnregisterDeviceEventCallback(OnGraphicsDeviceEvent);
 }
 
-static void UNITY_INTERFACE_API OnRenderEvent(int eventID)
+//data is the MediaStreamTrackInterface* of the video track the event targets,
+//nullptr targets every video track of the context.
+static void UNITY_INTERFACE_API OnRenderEvent(int eventID, void* data)
 {
     if(s_context == nullptr)
     {
         return;
     }
+    const auto track = static_cast<webrtc::MediaStreamTrackInterface*>(data);
     switch(static_cast<VideoStreamRenderEventID>(eventID))
     {
         case VideoStreamRenderEventID::Initialize:
@@ -69,14 +73,23 @@ static void UNITY_INTERFACE_API OnRenderEvent(int eventID)
                 GraphicsDevice::GetInstance().Init(s_UnityInterfaces);
             }
             s_device = GraphicsDevice::GetInstance().GetDevice();
-            s_context->InitializeEncoder(s_device);
+            s_context->InitializeEncoder(s_device, track);
             return;
         case VideoStreamRenderEventID::Encode:
-            s_context->EncodeFrame();
+        {
+            //stamp the frame as early as possible, this is the capture time reported to WebRTC
+            const int64 captureTimeUs = rtc::TimeMicros();
+            ScopedTrace trace("OnRenderEvent", captureTimeUs);
+            s_context->EncodeFrame(track, captureTimeUs);
             return;
+        }
         case VideoStreamRenderEventID::Finalize:
-            s_context->FinalizeEncoder();
-            GraphicsDevice::GetInstance().Shutdown();
+            s_context->FinalizeEncoder(track);
+            //the device is shared by every track, keep it while other tracks are still encoding
+            if(!s_context->HasInitializedEncoder())
+            {
+                GraphicsDevice::GetInstance().Shutdown();
+            }
             return;
         default:
             LogPrint("Unknown event id %d", eventID);
@@ -84,7 +97,7 @@ static void UNITY_INTERFACE_API OnRenderEvent(int eventID)
     }
 }
 
-extern "C" UnityRenderingEvent UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetRenderEventFunc(Context* context)
+extern "C" UnityRenderingEventAndData UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetRenderEventFunc(Context* context)
 {
     s_context = context;
     return OnRenderEvent;
@@ -11,6 +11,8 @@ namespace WebRTC {
         static bool GetHardwareEncoderSupport();
         bool IsInitialized() const;
         void Init(int width, int height, IGraphicsDevice* device, UnityEncoderType encoderType); //Can throw exception.
+        //Creates an encoder which is owned by the caller, InitV() is not called yet.
+        static std::unique_ptr<IEncoder> Create(int width, int height, IGraphicsDevice* device, UnityEncoderType encoderType); //Can throw exception.
         void Shutdown();
         IEncoder *GetEncoder() const;
     private:
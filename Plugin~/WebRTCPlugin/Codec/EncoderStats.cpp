@@ -0,0 +1,99 @@
+#include "pch.h"
+#include <cmath>
+#include "EncoderStats.h"
+
+namespace WebRTC
+{
+    const int DurationHistogram::SubBucketBits;
+    const size_t DurationHistogram::SubBucketCount;
+    const size_t DurationHistogram::BucketCount;
+
+    size_t DurationHistogram::GetBucketIndex(uint64 durationUs)
+    {
+        if (durationUs < SubBucketCount)
+        {
+            return static_cast<size_t>(durationUs);
+        }
+        int exponent = 0;
+        while ((durationUs >> exponent) >= 2 * SubBucketCount)
+        {
+            exponent++;
+        }
+        //the top bits below the leading one select the bucket within the power of two
+        const size_t index = SubBucketCount * (exponent + 1) + static_cast<size_t>((durationUs >> exponent) - SubBucketCount);
+        return std::min(index, BucketCount - 1);
+    }
+
+    uint64 DurationHistogram::GetBucketUpperBound(size_t index)
+    {
+        if (index < SubBucketCount)
+        {
+            return index;
+        }
+        const int exponent = static_cast<int>(index / SubBucketCount) - 1;
+        const uint64 mantissa = SubBucketCount + index % SubBucketCount;
+        return ((mantissa + 1) << exponent) - 1;
+    }
+
+    void DurationHistogram::Add(int64 durationUs)
+    {
+        const uint64 value = static_cast<uint64>(std::max<int64>(durationUs, 0));
+        buckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        sumUs.fetch_add(value, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    double DurationHistogram::GetAverage() const
+    {
+        const uint64 samples = count.load(std::memory_order_relaxed);
+        return samples > 0 ? static_cast<double>(sumUs.load(std::memory_order_relaxed)) / samples : 0;
+    }
+
+    double DurationHistogram::GetPercentile(double percentile) const
+    {
+        //summed from the buckets, count may already include a sample whose bucket isn't visible yet
+        uint64 counts[BucketCount];
+        uint64 total = 0;
+        for (size_t i = 0; i < BucketCount; i++)
+        {
+            counts[i] = buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if (total == 0)
+        {
+            return 0;
+        }
+        const uint64 rank = std::max<uint64>(static_cast<uint64>(std::ceil(total * percentile / 100)), 1);
+        uint64 seen = 0;
+        for (size_t i = 0; i < BucketCount; i++)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+            {
+                return static_cast<double>(GetBucketUpperBound(i));
+            }
+        }
+        return static_cast<double>(GetBucketUpperBound(BucketCount - 1));
+    }
+
+    void EncoderStatsCounters::OnFrameEncoded(int64 encodeTimeUs)
+    {
+        encodeTime.Add(encodeTimeUs);
+        framesEncoded.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    EncoderStats EncoderStatsCounters::Get() const
+    {
+        EncoderStats stats;
+        stats.framesSubmitted = framesSubmitted.load(std::memory_order_relaxed);
+        stats.framesEncoded = framesEncoded.load(std::memory_order_relaxed);
+        stats.framesDropped = framesDropped.load(std::memory_order_relaxed);
+        stats.forcedIdrFrames = forcedIdrFrames.load(std::memory_order_relaxed);
+        stats.reconfigures = reconfigures.load(std::memory_order_relaxed);
+        stats.averageCopyTimeUs = copyTime.GetAverage();
+        stats.p99CopyTimeUs = copyTime.GetPercentile(99);
+        stats.averageEncodeTimeUs = encodeTime.GetAverage();
+        stats.p99EncodeTimeUs = encodeTime.GetPercentile(99);
+        return stats;
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+
+namespace WebRTC
+{
+    //layout shared with the C# EncoderStats struct
+    struct EncoderStats
+    {
+        uint64 framesSubmitted = 0;
+        uint64 framesEncoded = 0;
+        //submitted while the buffer slot was still being encoded, or rejected by the encoder
+        uint64 framesDropped = 0;
+        uint64 forcedIdrFrames = 0;
+        uint64 reconfigures = 0;
+        //copy of the Unity texture into the encoder input
+        double averageCopyTimeUs = 0;
+        double p99CopyTimeUs = 0;
+        double averageEncodeTimeUs = 0;
+        double p99EncodeTimeUs = 0;
+    };
+
+    // Lock free histogram of durations, recording costs three relaxed increments.
+    // Buckets are log spaced with 8 buckets per power of two, percentiles are within 12.5%.
+    class DurationHistogram
+    {
+    public:
+        void Add(int64 durationUs);
+        double GetAverage() const;
+        // Upper bound of the bucket holding the percentile, 0 when empty.
+        double GetPercentile(double percentile) const;
+
+        static size_t GetBucketIndex(uint64 durationUs);
+        static uint64 GetBucketUpperBound(size_t index);
+
+    private:
+        static const int SubBucketBits = 3;
+        static const size_t SubBucketCount = 1 << SubBucketBits;
+        //up to 2^36us, longer durations go to the last bucket
+        static const size_t BucketCount = SubBucketCount * (36 - SubBucketBits + 1);
+
+        std::atomic<uint64> buckets[BucketCount] = {};
+        std::atomic<uint64> count { 0 };
+        std::atomic<uint64> sumUs { 0 };
+    };
+
+    // Counters of an encoder, written by the encoding thread and read from any thread.
+    class EncoderStatsCounters
+    {
+    public:
+        void OnFrameSubmitted() { framesSubmitted.fetch_add(1, std::memory_order_relaxed); }
+        void OnFrameEncoded(int64 encodeTimeUs);
+        void OnFrameDropped() { framesDropped.fetch_add(1, std::memory_order_relaxed); }
+        void OnForcedIdrFrame() { forcedIdrFrames.fetch_add(1, std::memory_order_relaxed); }
+        void OnReconfigure() { reconfigures.fetch_add(1, std::memory_order_relaxed); }
+        void OnCopy(int64 copyTimeUs) { copyTime.Add(copyTimeUs); }
+        EncoderStats Get() const;
+
+    private:
+        std::atomic<uint64> framesSubmitted { 0 };
+        std::atomic<uint64> framesEncoded { 0 };
+        std::atomic<uint64> framesDropped { 0 };
+        std::atomic<uint64> forcedIdrFrames { 0 };
+        std::atomic<uint64> reconfigures { 0 };
+        DurationHistogram copyTime;
+        DurationHistogram encodeTime;
+    };
+}
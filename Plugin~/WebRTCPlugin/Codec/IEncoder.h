@@ -1,4 +1,5 @@
 ﻿#pragma once
+#include "Codec/EncoderStats.h"
 
 namespace WebRTC {
 
@@ -18,7 +19,8 @@ namespace WebRTC {
         virtual void InitV() = 0;   //Can throw exception. 
         virtual void SetRate(uint32_t rate) = 0;
         virtual void UpdateSettings() = 0;
-        virtual bool CopyBuffer(void* frame) = 0;
+        //captureTimeUs is rtc::TimeMicros() at the moment the render event was issued
+        virtual bool CopyBuffer(void* frame, int64 captureTimeUs) = 0;
         virtual bool EncodeFrame() = 0;
         virtual bool IsSupported() const = 0;
         virtual void SetIdrFrame() = 0;
@@ -26,8 +28,22 @@ namespace WebRTC {
         sigslot::signal1<webrtc::VideoFrame&> CaptureFrame;
 
         CodecInitializationResult GetCodecInitializationResult() const { return m_initializationResult; }
+        //the texture passed to CopyBuffer is larger than the encoder, it is scaled down on the GPU (simulcast layers)
+        void SetScaleInput(bool scaleInput) { m_scaleInput = scaleInput; }
+        //may be called from any thread
+        EncoderStats GetStats() const { return m_stats.Get(); }
     protected:
+        //converts a capture time in the rtc::TimeMicros() domain to NTP milliseconds.
+        //m79's video RTP sender can't write the absolute-capture-time header extension,
+        //the capture time only reaches the receiver through the RTP timestamp and the RTCP sender reports
+        static int64 CaptureTimeToNtpMs(int64 captureTimeUs)
+        {
+            webrtc::Clock* clock = webrtc::Clock::GetRealTimeClock();
+            return captureTimeUs / rtc::kNumMicrosecsPerMillisec + clock->CurrentNtpInMilliseconds() - clock->TimeInMilliseconds();
+        }
         CodecInitializationResult m_initializationResult = CodecInitializationResult::NotInitialized;
+        bool m_scaleInput = false;
+        EncoderStatsCounters m_stats;
 
     };
 }
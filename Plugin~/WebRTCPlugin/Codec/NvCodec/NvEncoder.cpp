@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "NvEncoder.h"
 #include "Context.h"
+#include "FrameTrace.h"
 #include <cstring>
 #include "GraphicsDevice/IGraphicsDevice.h"
 
@@ -112,8 +113,13 @@ namespace WebRTC
 
     CodecInitializationResult NvEncoder::LoadCodec()
     {
-        pNvEncodeAPI = std::make_unique<NV_ENCODE_API_FUNCTION_LIST>();
-        pNvEncodeAPI->version = NV_ENCODE_API_FUNCTION_LIST_VER;
+        //the function list is shared by every encode session, replacing it would pull it from under running encoders
+        if (pNvEncodeAPI != nullptr)
+        {
+            return CodecInitializationResult::Success;
+        }
+        auto functionList = std::make_unique<NV_ENCODE_API_FUNCTION_LIST>();
+        functionList->version = NV_ENCODE_API_FUNCTION_LIST_VER;
 
         if (!LoadModule())
         {
@@ -131,7 +137,7 @@ namespace WebRTC
         NvEncodeAPIGetMaxSupportedVersion(&version);
         if (currentVersion > version)
         {
-            LogPrint("Current Driver Version does not support this NvEncodeAPI version, please upgrade driver");
+            DebugError("Current Driver Version does not support this NvEncodeAPI version, please upgrade driver");
             return CodecInitializationResult::DriverVersionDoesNotSupportAPI;
         }
 
@@ -144,15 +150,16 @@ namespace WebRTC
 
         if (!NvEncodeAPICreateInstance)
         {
-            LogPrint("Cannot find NvEncodeAPICreateInstance() entry in NVENC library");
+            DebugError("Cannot find NvEncodeAPICreateInstance() entry in NVENC library");
             return CodecInitializationResult::APINotFound;
         }
-        bool result = (NvEncodeAPICreateInstance(pNvEncodeAPI.get()) == NV_ENC_SUCCESS);
+        bool result = (NvEncodeAPICreateInstance(functionList.get()) == NV_ENC_SUCCESS);
         checkf(result, "Unable to create NvEnc API function list");
         if (!result)
         {
             return CodecInitializationResult::APINotFound;
         }
+        pNvEncodeAPI = std::move(functionList);
         return CodecInitializationResult::Success;
     }
 
@@ -173,7 +180,7 @@ namespace WebRTC
 
         if (module == nullptr)
         {
-            LogPrint("NVENC library file is not found. Please ensure NV driver is installed");
+            DebugError("NVENC library file is not found. Please ensure NV driver is installed");
             return false;
         }
         s_hModule = module;
@@ -196,9 +203,10 @@ namespace WebRTC
     void NvEncoder::UpdateSettings()
     {
         bool settingChanged = false;
-        if (nvEncConfig.rcParams.averageBitRate != bitRate)
+        const uint32_t targetBitRate = bitRate.load(std::memory_order_relaxed);
+        if (nvEncConfig.rcParams.averageBitRate != targetBitRate)
         {
-            nvEncConfig.rcParams.averageBitRate = bitRate;
+            nvEncConfig.rcParams.averageBitRate = targetBitRate;
             settingChanged = true;
         }
         if (nvEncInitializeParams.frameRateNum != frameRate)
@@ -214,26 +222,36 @@ namespace WebRTC
             nvEncReconfigureParams.version = NV_ENC_RECONFIGURE_PARAMS_VER;
             errorCode = pNvEncodeAPI->nvEncReconfigureEncoder(pEncoderInterface, &nvEncReconfigureParams);
             checkf(NV_RESULT(errorCode), StringFormat("Failed to reconfigure encoder setting %d", errorCode).c_str());
+            m_stats.OnReconfigure();
         }
     }
     void NvEncoder::SetRate(uint32 rate)
     {
-#pragma warning (suppress: 4018)
-        if (rate < lastBitRate)
-        {
-#pragma warning(suppress: 4018)
-            bitRate = rate > minBitRate ? rate : minBitRate;
-            lastBitRate = bitRate;
-        }
+        //follows the merged target both ways,
+        //lower simulcast layers have to follow the allocation, the floor is tuned for the full resolution
+        const uint32_t floorBitRate = m_scaleInput ? minLayerBitRate : minBitRate;
+        bitRate.store(rate > floorBitRate ? rate : floorBitRate, std::memory_order_relaxed);
     }
 
-    bool NvEncoder::CopyBuffer(void* frame)
+    bool NvEncoder::CopyBuffer(void* frame, int64 captureTimeUs)
     {
         const int curFrameNum = GetCurrentFrameCount() % bufferedFrameNum;
         const auto tex = renderTextures[curFrameNum];
         if (tex == nullptr)
             return false;
-        m_device->CopyResourceFromNativeV(tex, frame);
+        ScopedTrace trace("CopyResourceFromNativeV", captureTimeUs);
+        const int64 copyStartUs = rtc::TimeMicros();
+        if (m_scaleInput)
+        {
+            if (!m_device->ScaleResourceFromNativeV(tex, frame))
+                return false;
+        }
+        else
+        {
+            m_device->CopyResourceFromNativeV(tex, frame);
+        }
+        m_stats.OnCopy(rtc::TimeMicros() - copyStartUs);
+        bufferedFrames[curFrameNum].captureTimeUs = captureTimeUs;
         return true;
     }
 
@@ -243,10 +261,12 @@ namespace WebRTC
         UpdateSettings();
         uint32 bufferIndexToWrite = frameCount % bufferedFrameNum;
         Frame& frame = bufferedFrames[bufferIndexToWrite];
+        m_stats.OnFrameSubmitted();
 #pragma region set frame params
         //no free buffer, skip this frame
         if (frame.isEncoding)
         {
+            m_stats.OnFrameDropped();
             return false;
         }
         frame.isEncoding = true;
@@ -266,12 +286,16 @@ namespace WebRTC
         if (isIdrFrame)
         {
             picParams.encodePicFlags |= NV_ENC_PIC_FLAG_FORCEIDR;
+            m_stats.OnForcedIdrFrame();
         }
         isIdrFrame = false;
+        frame.encodeStartMs = rtc::TimeMillis();
+        const int64 encodeStartUs = rtc::TimeMicros();
         errorCode = pNvEncodeAPI->nvEncEncodePicture(pEncoderInterface, &picParams);
         checkf(NV_RESULT(errorCode), StringFormat("Failed to encode frame, error is %d", errorCode).c_str());
 #pragma endregion
         ProcessEncodedFrame(frame);
+        m_stats.OnFrameEncoded(rtc::TimeMicros() - encodeStartUs);
         frameCount++;
         return true;
     }
@@ -286,27 +310,32 @@ namespace WebRTC
         }
         frame.isEncoding = false;
 #pragma region retrieve encoded frame from output buffer
+        ScopedTrace trace("LockBitstream", frame.captureTimeUs);
         NV_ENC_LOCK_BITSTREAM lockBitStream = { 0 };
         lockBitStream.version = NV_ENC_LOCK_BITSTREAM_VER;
         lockBitStream.outputBitstream = frame.outputFrame;
         lockBitStream.doNotWait = nvEncInitializeParams.enableEncodeAsync;
         errorCode = pNvEncodeAPI->nvEncLockBitstream(pEncoderInterface, &lockBitStream);
         checkf(NV_RESULT(errorCode), StringFormat("Failed to lock bit stream, error is %d", errorCode).c_str());
-        if (lockBitStream.bitstreamSizeInBytes)
-        {
-            frame.encodedFrame.resize(lockBitStream.bitstreamSizeInBytes);
-            std::memcpy(frame.encodedFrame.data(), lockBitStream.bitstreamBufferPtr, lockBitStream.bitstreamSizeInBytes);
-        }
+        //the frame owns its copy, the peer connections send it after this buffer has been reused
+        const rtc::CopyOnWriteBuffer bitstream(static_cast<const uint8*>(lockBitStream.bitstreamBufferPtr), lockBitStream.bitstreamSizeInBytes);
         errorCode = pNvEncodeAPI->nvEncUnlockBitstream(pEncoderInterface, frame.outputFrame);
         checkf(NV_RESULT(errorCode), StringFormat("Failed to unlock bit stream, error is %d", errorCode).c_str());
         frame.isIdrFrame = lockBitStream.pictureType == NV_ENC_PIC_TYPE_IDR;
+        frame.encodeFinishMs = rtc::TimeMillis();
 #pragma endregion
 
-
-        rtc::scoped_refptr<FrameBuffer> buffer = new rtc::RefCountedObject<FrameBuffer>(width, height, frame.encodedFrame);
-        int64 timestamp = rtc::TimeMillis();
-        webrtc::VideoFrame videoFrame{buffer, webrtc::VideoRotation::kVideoRotation_0, timestamp};
-        videoFrame.set_ntp_time_ms(timestamp);
+        //frames encoded without a preceding CopyBuffer (e.g. from tests) have no capture time
+        const int64 captureTimeUs = frame.captureTimeUs != 0 ? frame.captureTimeUs : rtc::TimeMicros();
+        rtc::scoped_refptr<FrameBuffer> buffer = new rtc::RefCountedObject<FrameBuffer>(
+            width, height, bitstream, frame.encodeStartMs, frame.encodeFinishMs);
+        webrtc::VideoFrame videoFrame = webrtc::VideoFrame::Builder()
+            .set_video_frame_buffer(buffer)
+            .set_rotation(webrtc::kVideoRotation_0)
+            .set_timestamp_us(captureTimeUs)
+            .set_ntp_time_ms(CaptureTimeToNtpMs(captureTimeUs))
+            .build();
+        frame.captureTimeUs = 0;
         CaptureFrame(videoFrame);
     }
 
@@ -24,9 +24,11 @@ namespace WebRTC
         {
             InputFrame inputFrame = {nullptr, nullptr, NV_ENC_BUFFER_FORMAT_UNDEFINED };
             OutputFrame outputFrame = nullptr;
-            std::vector<uint8> encodedFrame = {};
             bool isIdrFrame = false;
             std::atomic<bool> isEncoding = { false };
+            int64 captureTimeUs = 0;
+            int64 encodeStartMs = 0;
+            int64 encodeFinishMs = 0;
         };
     public:
         NvEncoder(
@@ -45,7 +47,7 @@ namespace WebRTC
 
         void SetRate(uint32 rate) override;
         void UpdateSettings() override;
-        bool CopyBuffer(void* frame) override;
+        bool CopyBuffer(void* frame, int64 captureTimeUs) override;
         bool EncodeFrame() override;
         bool IsSupported() const override { return isNvEncoderSupported; }
         void SetIdrFrame()  override { isIdrFrame = true; }
@@ -80,12 +82,12 @@ namespace WebRTC
         uint64 frameCount = 0;
         void* pEncoderInterface = nullptr;
         bool isIdrFrame = false;
-        //10Mbps
-        uint32_t bitRate = 10000000;
-        //100Mbps
-        uint32_t lastBitRate = 100000000;
+        //10Mbps, set from the encoder queues of the peer connections and read on the rendering thread
+        std::atomic<uint32_t> bitRate { 10000000 };
         //5Mbps
         const uint32_t minBitRate = 5000000;
+        //100kbps
+        const uint32_t minLayerBitRate = 100000;
         uint32_t frameRate = 45;
     };
 }
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "SoftwareEncoder.h"
 #include "Context.h"
+#include "FrameTrace.h"
 #include <cstring>
 #include "GraphicsDevice/IGraphicsDevice.h"
 
@@ -22,19 +23,37 @@ namespace WebRTC
         m_initializationResult = CodecInitializationResult::Success;
     }
 
-    bool SoftwareEncoder::CopyBuffer(void* frame)
+    bool SoftwareEncoder::CopyBuffer(void* frame, int64 captureTimeUs)
     {
+        ScopedTrace trace("CopyResourceFromNativeV", captureTimeUs);
+        const int64 copyStartUs = rtc::TimeMicros();
         m_device->CopyResourceFromNativeV(m_encodeTex, frame);
+        m_stats.OnCopy(rtc::TimeMicros() - copyStartUs);
+        m_captureTimeUs = captureTimeUs;
         return true;
     }
 
     bool SoftwareEncoder::EncodeFrame()
     {
+        m_stats.OnFrameSubmitted();
+        //the frame is only converted here, webrtc's own encoder compresses it
+        const int64 encodeStartUs = rtc::TimeMicros();
         const rtc::scoped_refptr<webrtc::I420Buffer> i420Buffer = m_device->ConvertRGBToI420(m_encodeTex);
         if (nullptr == i420Buffer)
+        {
+            m_stats.OnFrameDropped();
             return false;
+        }
+        m_stats.OnFrameEncoded(rtc::TimeMicros() - encodeStartUs);
 
-        webrtc::VideoFrame frame = webrtc::VideoFrame::Builder().set_video_frame_buffer(i420Buffer).set_rotation(webrtc::kVideoRotation_0).set_timestamp_us(0).build();
+        const int64 captureTimeUs = m_captureTimeUs != 0 ? m_captureTimeUs : rtc::TimeMicros();
+        webrtc::VideoFrame frame = webrtc::VideoFrame::Builder()
+            .set_video_frame_buffer(i420Buffer)
+            .set_rotation(webrtc::kVideoRotation_0)
+            .set_timestamp_us(captureTimeUs)
+            .set_ntp_time_ms(CaptureTimeToNtpMs(captureTimeUs))
+            .build();
+        m_captureTimeUs = 0;
         CaptureFrame(frame);
         m_frameCount++;
         return true;
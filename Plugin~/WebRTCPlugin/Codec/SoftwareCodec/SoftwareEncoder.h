@@ -15,7 +15,7 @@ namespace WebRTC
         virtual void InitV() override;
         virtual void SetRate(uint32_t rate) override {}
         virtual void UpdateSettings() override {}
-        virtual bool CopyBuffer(void* frame) override;
+        virtual bool CopyBuffer(void* frame, int64 captureTimeUs) override;
         virtual bool EncodeFrame() override;
         virtual bool IsSupported() const override { return true; }
         virtual void SetIdrFrame() override {}
@@ -27,6 +27,7 @@ namespace WebRTC
         int m_width = 1920;
         int m_height = 1080;
         uint64 m_frameCount = 0;
+        int64 m_captureTimeUs = 0;
     };
 //---------------------------------------------------------------------------------------------------------------------
    
@@ -2,6 +2,7 @@
 #include "Codec/IEncoder.h"
 #include "GraphicsDevice/IGraphicsDevice.h"
 #include <VideoToolbox/VideoToolbox.h>
+#include <atomic>
 
 namespace WebRTC {
     class VTEncoderMetal : public IEncoder{
@@ -10,19 +11,33 @@ namespace WebRTC {
         ~VTEncoderMetal();
         void SetRate(uint32_t rate) override;
         void UpdateSettings() override;
-        bool CopyBuffer(void* frame) override;
+        bool CopyBuffer(void* frame, int64 captureTimeUs) override;
         bool EncodeFrame() override;
         bool IsSupported() const override;
         void SetIdrFrame() override;
         uint64 GetCurrentFrameCount() const override { return frameCount; }
     private:
+        //a frame handed to the compression session, passed back to the output callback
+        struct Frame
+        {
+            std::vector<uint8> encodedBuffer;
+            int64 submitTimeUs = 0;
+        };
+        friend void VTCompressionOutputCallback(void* outputCallbackRefCon, void* sourceFrameRefCon,
+            OSStatus status, VTEncodeInfoFlags infoFlags, CMSampleBufferRef sampleBuffer);
+
         uint64 frameCount = 0;
         uint64 m_width = 0;
         uint64 m_height = 0;
         IGraphicsDevice* m_device;
         ITexture2D* renderTextures[bufferedFrameNum];
         CVPixelBufferRef pixelBuffers[bufferedFrameNum];
-        std::vector<uint8> encodedBuffers[bufferedFrameNum];
+        Frame frames[bufferedFrameNum];
+        int64 captureTimes[bufferedFrameNum] = {};
+        std::atomic<uint32_t> bitRate { 0 };
+        //the bitrate the session was last configured with, 0 until SetRate is called
+        uint32_t appliedBitRate = 0;
+        bool isIdrFrame = false;
 
         VTCompressionSessionRef encoderSession;
     };
@@ -114,26 +114,31 @@ namespace WebRTC {
                                      VTEncodeInfoFlags infoFlags,
                                      CMSampleBufferRef sampleBuffer)
     {
-        if (status != noErr)
+        VTEncoderMetal* encoder = reinterpret_cast<VTEncoderMetal*>(outputCallbackRefCon);
+        VTEncoderMetal::Frame* frame = reinterpret_cast<VTEncoderMetal::Frame*>(sourceFrameRefCon);
+        if(encoder == nullptr || frame == nullptr) {
+            NSLog(@"VTCompressionOutputCallback parameter failed");
+            return;
+        }
+        if (status != noErr || (infoFlags & kVTEncodeInfo_FrameDropped) != 0)
         {
             NSLog(@"VTCompressionOutputCallback returns failed %d", status);
+            encoder->m_stats.OnFrameDropped();
             return;
         }
         if (!CMSampleBufferDataIsReady(sampleBuffer))
         {
             NSLog(@"VTCompressionOutputCallback data is not ready ");
+            encoder->m_stats.OnFrameDropped();
             return;
         }
-        VTEncoderMetal* encoder = reinterpret_cast<VTEncoderMetal*>(outputCallbackRefCon);
-        std::vector<uint8>* encodedFrame = reinterpret_cast<std::vector<uint8>*>(sourceFrameRefCon);
-    
-        if(encoder == nullptr || encodedFrame == nullptr) {
-            NSLog(@"VTCompressionOutputCallback parameter failed");
-            return;
-        }
-        auto info = CMSampleBufferH264Parser(sampleBuffer, *encodedFrame);
+        //the buffer is reused every bufferedFrameNum frames
+        frame->encodedBuffer.clear();
+        auto info = CMSampleBufferH264Parser(sampleBuffer, frame->encodedBuffer);
         delete info;
-        encoder->CaptureFrame(*encodedFrame);
+        //the session compresses asynchronously, from the submission to the compressed frame
+        encoder->m_stats.OnFrameEncoded(rtc::TimeMicros() - frame->submitTimeUs);
+        encoder->CaptureFrame(frame->encodedBuffer);
     }
 
     VTEncoderMetal::VTEncoderMetal(uint32_t nWidth, uint32_t nHeight, IGraphicsDevice* device)
@@ -200,17 +205,37 @@ namespace WebRTC {
     }
     void VTEncoderMetal::SetRate(uint32_t rate)
     {
+        bitRate.store(rate, std::memory_order_relaxed);
     }
     void VTEncoderMetal::UpdateSettings()
     {
+        const uint32_t targetBitRate = bitRate.load(std::memory_order_relaxed);
+        if (targetBitRate == 0 || targetBitRate == appliedBitRate)
+        {
+            return;
+        }
+        const int32_t value = static_cast<int32_t>(std::min<uint32_t>(targetBitRate, INT32_MAX));
+        CFNumberRef number = CFNumberCreate(kCFAllocatorDefault, kCFNumberSInt32Type, &value);
+        OSStatus status = VTSessionSetProperty(encoderSession, kVTCompressionPropertyKey_AverageBitRate, number);
+        CFRelease(number);
+        if (status != noErr)
+        {
+            NSLog(@"VTSessionSetProperty AverageBitRate failed %d", status);
+            return;
+        }
+        appliedBitRate = targetBitRate;
+        m_stats.OnReconfigure();
     }
-    bool VTEncoderMetal::CopyBuffer(void* frame)
+    bool VTEncoderMetal::CopyBuffer(void* frame, int64 captureTimeUs)
     {
         const int curFrameNum = GetCurrentFrameCount() % bufferedFrameNum;
         const auto tex = renderTextures[curFrameNum];
         if (tex == nullptr)
             return false;
+        const int64 copyStartUs = rtc::TimeMicros();
         m_device->CopyResourceFromNativeV(tex, frame);
+        m_stats.OnCopy(rtc::TimeMicros() - copyStartUs);
+        captureTimes[curFrameNum] = captureTimeUs;
         return true;
     }
     bool VTEncoderMetal::EncodeFrame()
@@ -218,16 +243,35 @@ namespace WebRTC {
         UpdateSettings();
         uint32 bufferIndexToWrite = frameCount % bufferedFrameNum;
 
-        CMTime presentationTimeStamp = CMTimeMake(frameCount, 1000);
+        CMTime presentationTimeStamp = CMTimeMake(captureTimes[bufferIndexToWrite], rtc::kNumMicrosecsPerSec);
         VTEncodeInfoFlags flags;
+        m_stats.OnFrameSubmitted();
+
+        CFDictionaryRef frameProperties = NULL;
+        if (isIdrFrame)
+        {
+            const void* keys[] = { kVTEncodeFrameOptionKey_ForceKeyFrame };
+            const void* values[] = { kCFBooleanTrue };
+            frameProperties = CFDictionaryCreate(kCFAllocatorDefault, keys, values, 1,
+                                                 &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+            m_stats.OnForcedIdrFrame();
+        }
+        isIdrFrame = false;
+
+        Frame& frame = frames[bufferIndexToWrite];
+        frame.submitTimeUs = rtc::TimeMicros();
         OSStatus status = VTCompressionSessionEncodeFrame(encoderSession,
                                                           pixelBuffers[bufferIndexToWrite],
                                                           presentationTimeStamp,
                                                           kCMTimeInvalid,
-                                                          NULL, (void*)&encodedBuffers[bufferIndexToWrite], &flags);
-    
+                                                          frameProperties, (void*)&frame, &flags);
+        if (frameProperties != NULL)
+        {
+            CFRelease(frameProperties);
+        }
         if (status != noErr)
         {
+            m_stats.OnFrameDropped();
             return false;
         }
         frameCount++;
@@ -239,6 +283,6 @@ namespace WebRTC {
     }
     void VTEncoderMetal::SetIdrFrame()
     {
-        // Nothing to do
+        isIdrFrame = true;
     }
 }
@@ -3,6 +3,7 @@
 #include "Context.h"
 #include "GraphicsDevice/GraphicsDevice.h"
 #include "Codec/EncoderFactory.h"
+#include "HardwareVideoDecoderFactory.h"
 #include "DummyVideoEncoder.h"
 #include "VideoCapturer.h"
 #include "VideoCaptureTrackSource.h"
@@ -21,21 +22,36 @@ namespace WebRTC
         return nullptr;
     }
 
-    Context* ContextManager::CreateContext(int uid, UnityEncoderType encoderType)
+    Context* ContextManager::CreateContext(int uid, UnityEncoderType encoderType, bool shareFactory)
     {
         auto it = s_instance.m_contexts.find(uid);
         if (it != s_instance.m_contexts.end()) {
             DebugLog("Using already created context with ID %d", uid);
             return nullptr;
         }
-        auto ctx = new Context(uid, encoderType);
+        auto ctx = new Context(uid, encoderType, shareFactory);
         s_instance.m_contexts[uid].reset(ctx);
         return ctx;
     }
 
-    CodecInitializationResult Context::GetCodecInitializationResult()
+    CodecInitializationResult Context::GetCodecInitializationResult(const webrtc::MediaStreamTrackInterface* track)
     {
-        return nvVideoCapturer->GetCodecInitializationResult();
+        std::lock_guard<std::mutex> lock(videoCapturersMutex);
+        auto capturers = GetVideoCapturers(track);
+        if (capturers.empty())
+        {
+            return CodecInitializationResult::NotInitialized;
+        }
+        //report the first track which is not ready
+        for (auto capturer : capturers)
+        {
+            const auto result = capturer->GetCodecInitializationResult();
+            if (result != CodecInitializationResult::Success)
+            {
+                return result;
+            }
+        }
+        return CodecInitializationResult::Success;
     }
 
     void ContextManager::SetCurContext(Context* context)
@@ -74,6 +90,15 @@ namespace WebRTC
             return;
         }
 
+        //receive side buffering, webrtc only accepts these when the peer connection is created
+        const int maxPackets = configJson["audioJitterBufferMaxPackets"].asInt();
+        if (maxPackets > 0)
+        {
+            config.audio_jitter_buffer_max_packets = maxPackets;
+        }
+        config.audio_jitter_buffer_min_delay_ms = std::max(0, configJson["audioJitterBufferMinDelayMs"].asInt());
+        config.audio_jitter_buffer_fast_accelerate = configJson["audioJitterBufferFastAccelerate"].asBool();
+
         Json::Value iceServersJson = configJson["iceServers"];
         if (!iceServersJson)
             return;
@@ -127,106 +152,254 @@ namespace WebRTC
     }
 #pragma warning(pop)
 
-    Context::Context(int uid, UnityEncoderType encoderType)
+    Context::Context(int uid, UnityEncoderType encoderType, bool shareFactory)
         : m_uid(uid)
         , m_encoderType(encoderType)
     {
-        workerThread.reset(new rtc::Thread(rtc::SocketServer::CreateDefault()));
-        workerThread->Start();
-        signalingThread.reset(new rtc::Thread(rtc::SocketServer::CreateDefault()));
-        signalingThread->Start();
-
-        rtc::InitializeSSL();
-
-        audioDevice = new rtc::RefCountedObject<DummyAudioDevice>();
-        nvVideoCapturerUnique = std::make_unique<NvVideoCapturer>();
-
-        //[TODO-sin: 2020-1-16] Since we are giving the pointer to peerConnectionFactory in CreateVideoStream(), 
-        //we shouldn't store the raw pointer here.
-        nvVideoCapturer = nvVideoCapturerUnique.get();
-
-#if defined(SUPPORT_METAL) && defined(SUPPORT_SOFTWARE_ENCODER)
-        //Always use SoftwareEncoder on Mac for now.
-        std::unique_ptr<webrtc::VideoEncoderFactory> videoEncoderFactory = webrtc::CreateBuiltinVideoEncoderFactory();
-#else
-        std::unique_ptr<webrtc::VideoEncoderFactory> videoEncoderFactory =
-            m_encoderType == UnityEncoderType::UnityEncoderHardware ?
-            std::make_unique<DummyVideoEncoderFactory>(nvVideoCapturer) :
-            webrtc::CreateBuiltinVideoEncoderFactory();
-#endif
-
-        peerConnectionFactory = webrtc::CreatePeerConnectionFactory(
-                                workerThread.get(),
-                                workerThread.get(),
-                                signalingThread.get(),
-                                audioDevice,
-                                webrtc::CreateAudioEncoderFactory<webrtc::AudioEncoderOpus>(),
-                                webrtc::CreateAudioDecoderFactory<webrtc::AudioDecoderOpus>(),
-                                std::move(videoEncoderFactory),
-                                webrtc::CreateBuiltinVideoDecoderFactory(),
-                                nullptr,
-                                nullptr);
+        factoryResources = shareFactory ?
+            FactoryResources::AcquireShared(m_encoderType) :
+            FactoryResources::Create(m_encoderType);
+        peerConnectionFactory = factoryResources->Factory();
     }
 
     Context::~Context()
     {
+        StopAudioPacer();
+        StopStatsSampler();
+        for (auto& receiver : videoReceivers)
+        {
+            receiver.second.second->RemoveSink(receiver.first);
+        }
+        videoReceivers.clear();
+        std::vector<const webrtc::MediaStreamTrackInterface*> remoteAudioTracks;
+        {
+            std::lock_guard<std::mutex> lock(audioPlayoutMutex);
+            for (const auto& sink : audioPlayoutSinks)
+            {
+                remoteAudioTracks.push_back(sink.first);
+            }
+        }
+        for (auto track : remoteAudioTracks)
+        {
+            RemoveRemoteAudioTrack(track);
+        }
         dataChannels.clear();
         clients.clear();
         peerConnectionFactory = nullptr;
-        audioTrack = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(audioSourcesMutex);
+            audioSources.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(videoCapturersMutex);
+            videoCapturers.clear();
+        }
         videoTracks.clear();
-        audioStream = nullptr;
+        audioStreams.clear();
         videoStreams.clear();
 
-        workerThread->Quit();
-        workerThread.reset();
-        signalingThread->Quit();
-        signalingThread.reset();
+        //stops the threads unless another context still shares them
+        factoryResources.reset();
+    }
+
+    //videoCapturersMutex must be held while the returned capturers are used,
+    //DeleteVideoStream() may release them from the main thread.
+    std::vector<NvVideoCapturer*> Context::GetVideoCapturers(const webrtc::MediaStreamTrackInterface* track)
+    {
+        std::vector<NvVideoCapturer*> capturers;
+        if (track == nullptr)
+        {
+            for (const auto& pair : videoCapturers)
+            {
+                capturers.push_back(pair.second);
+            }
+            return capturers;
+        }
+        auto it = videoCapturers.find(track);
+        if (it != videoCapturers.end())
+        {
+            capturers.push_back(it->second);
+        }
+        return capturers;
+    }
+
+    bool Context::InitializeEncoder(IGraphicsDevice* device, const webrtc::MediaStreamTrackInterface* track)
+    {
+        std::lock_guard<std::mutex> lock(videoCapturersMutex);
+        auto capturers = GetVideoCapturers(track);
+        if (capturers.empty())
+        {
+            return false;
+        }
+        bool result = true;
+        for (auto capturer : capturers)
+        {
+            if (!capturer->InitializeEncoder(device, m_encoderType))
+            {
+                result = false;
+                continue;
+            }
+            capturer->StartEncoder();
+        }
+        return result;
+    }
+    void Context::EncodeFrame(const webrtc::MediaStreamTrackInterface* track, int64 captureTimeUs)
+    {
+        std::lock_guard<std::mutex> lock(videoCapturersMutex);
+        for (auto capturer : GetVideoCapturers(track))
+        {
+            capturer->EncodeVideoData(captureTimeUs);
+        }
+    }
+    void Context::FinalizeEncoder(const webrtc::MediaStreamTrackInterface* track)
+    {
+        std::lock_guard<std::mutex> lock(videoCapturersMutex);
+        for (auto capturer : GetVideoCapturers(track))
+        {
+            capturer->FinalizeEncoder();
+        }
+    }
+    void Context::SetBitratePolicy(BitratePolicy policy)
+    {
+        std::lock_guard<std::mutex> lock(videoCapturersMutex);
+        m_bitratePolicy = policy;
+        for (auto capturer : GetVideoCapturers(nullptr))
+        {
+            capturer->SetBitratePolicy(policy);
+        }
     }
 
-    bool Context::InitializeEncoder(IGraphicsDevice* device)
+    bool Context::HasInitializedEncoder()
+    {
+        std::lock_guard<std::mutex> lock(videoCapturersMutex);
+        for (auto capturer : GetVideoCapturers(nullptr))
+        {
+            if (capturer->GetCodecInitializationResult() != CodecInitializationResult::NotInitialized)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    bool Context::SetPlayoutDelay(const webrtc::MediaStreamTrackInterface* track, int minMs, int maxMs)
     {
-        if(!nvVideoCapturer->InitializeEncoder(device, m_encoderType))
+        if (!NvVideoCapturer::IsValidPlayoutDelay(minMs, maxMs))
         {
+            DebugWarning("Invalid playout delay %d-%dms", minMs, maxMs);
             return false;
         }
-        nvVideoCapturer->StartEncoder();
+        std::lock_guard<std::mutex> lock(videoCapturersMutex);
+        for (auto capturer : GetVideoCapturers(track))
+        {
+            capturer->SetPlayoutDelay(minMs, maxMs);
+        }
         return true;
     }
-    void Context::EncodeFrame()
+
+    bool Context::GetEncoderStats(const webrtc::MediaStreamTrackInterface* track, int32 layer, EncoderStats* stats)
     {
-        nvVideoCapturer->EncodeVideoData();
+        std::lock_guard<std::mutex> lock(videoCapturersMutex);
+        auto item = videoCapturers.find(track);
+        if (item == videoCapturers.end())
+        {
+            return false;
+        }
+        return item->second->GetEncoderStats(layer, stats);
     }
-    void Context::FinalizeEncoder()
+
+    void Context::StopCapturer(const webrtc::MediaStreamTrackInterface* track)
     {
-        nvVideoCapturer->FinalizeEncoder();
+        std::lock_guard<std::mutex> lock(videoCapturersMutex);
+        for (auto capturer : GetVideoCapturers(track))
+        {
+            capturer->Stop();
+        }
     }
 
-    UnityEncoderType Context::GetEncoderType() const
+    VideoFrameReceiver* Context::CreateVideoReceiver(webrtc::MediaStreamTrackInterface* track)
     {
-        return m_encoderType;
+        if (track == nullptr || track->kind() != webrtc::MediaStreamTrackInterface::kVideoKind)
+        {
+            return nullptr;
+        }
+        rtc::scoped_refptr<webrtc::VideoTrackInterface> videoTrack(static_cast<webrtc::VideoTrackInterface*>(track));
+        auto receiver = std::make_unique<VideoFrameReceiver>();
+        VideoFrameReceiver* ptr = receiver.get();
+        videoTrack->AddOrUpdateSink(ptr, rtc::VideoSinkWants());
+        videoReceivers[ptr] = std::make_pair(std::move(receiver), videoTrack);
+        return ptr;
     }
 
-    webrtc::MediaStreamInterface* Context::CreateVideoStream(void* frameBuffer, int width, int height)
+    void Context::DeleteVideoReceiver(VideoFrameReceiver* receiver)
     {
-        rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> source(WebRTC::VideoCapturerTrackSource::Create(workerThread.get(), std::move(nvVideoCapturerUnique), false));
+        auto item = videoReceivers.find(receiver);
+        if (item == videoReceivers.end())
+        {
+            return;
+        }
+        //after RemoveSink returns the decoder thread no longer calls OnFrame
+        item->second.second->RemoveSink(receiver);
+        videoReceivers.erase(item);
+    }
 
-        //TODO: label and stream id should be maintained in some way for multi-stream
-        auto videoTrack = peerConnectionFactory->CreateVideoTrack("video", source);
+    VideoDecoderStats Context::GetVideoDecoderStats() const
+    {
+        return factoryResources->VideoDecoderFactory()->GetStats();
+    }
 
-        videoTracks[frameBuffer] = videoTrack;
+    void Context::AddVideoDecoderBackend(std::unique_ptr<IHardwareDecoderBackend> backend)
+    {
+        factoryResources->VideoDecoderFactory()->AddBackend(std::move(backend));
+    }
 
-        auto videoStream = peerConnectionFactory->CreateLocalMediaStream("video");
-        videoStream->AddTrack(videoTrack);
-        videoStreams.push_back(videoStream);
+    HardwareVideoDecoderFactory* Context::GetVideoDecoderFactory() const
+    {
+        return factoryResources->VideoDecoderFactory();
+    }
+
+    UnityEncoderType Context::GetEncoderType() const
+    {
+        return m_encoderType;
+    }
+
+    webrtc::MediaStreamInterface* Context::CreateVideoStream(void* frameBuffer, int width, int height, int simulcastLayers)
+    {
+        auto capturer = std::make_unique<NvVideoCapturer>();
+        NvVideoCapturer* nvVideoCapturer = capturer.get();
         nvVideoCapturer->SetFrameBuffer(frameBuffer);
         nvVideoCapturer->SetSize(width, height);
+        nvVideoCapturer->SetSimulcastLayers(simulcastLayers);
+        nvVideoCapturer->SetBitratePolicy(m_bitratePolicy);
+        rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> source(WebRTC::VideoCapturerTrackSource::Create(factoryResources->WorkerThread(), std::move(capturer), false));
+
+        //every track gets its own ids so that remote peers can tell the viewpoints apart
+        auto videoTrack = peerConnectionFactory->CreateVideoTrack(rtc::CreateRandomUuid(), source);
+        auto videoStream = peerConnectionFactory->CreateLocalMediaStream(rtc::CreateRandomUuid());
+        videoStream->AddTrack(videoTrack);
+        videoStreams.push_back(videoStream);
+        videoTracks[videoTrack.get()] = videoTrack;
+        {
+            std::lock_guard<std::mutex> lock(videoCapturersMutex);
+            videoCapturers[videoTrack.get()] = nvVideoCapturer;
+        }
         return videoStream.get();
     }
 
     void Context::DeleteVideoStream(webrtc::MediaStreamInterface* stream)
     {
         auto item = std::find(videoStreams.begin(), videoStreams.end(), stream);
+        if (item == videoStreams.end())
+        {
+            return;
+        }
+        for (const auto& track : (*item)->GetVideoTracks())
+        {
+            {
+                std::lock_guard<std::mutex> lock(videoCapturersMutex);
+                videoCapturers.erase(track.get());
+            }
+            videoTracks.erase(track.get());
+        }
         videoStreams.erase(item);
     }
 
@@ -237,22 +410,401 @@ namespace WebRTC
         audioOptions.auto_gain_control = false;
         audioOptions.noise_suppression = false;
         audioOptions.highpass_filter = false;
-        //TODO: label and stream id should be maintained in some way for multi-stream
-        audioTrack = peerConnectionFactory->CreateAudioTrack("audio", peerConnectionFactory->CreateAudioSource(audioOptions));
-        audioStream = peerConnectionFactory->CreateLocalMediaStream("audio");
+        //each track has its own source and capture buffer, so game audio and commentary can be sent separately
+        rtc::scoped_refptr<AudioTrackSource> source = AudioTrackSource::Create(audioOptions);
+        if (audioPacing)
+        {
+            //Unity's audio clock drifts against the system clock, the pacer evens it out
+            source->EnablePacing(true);
+            StartAudioPacer();
+        }
+        auto audioTrack = peerConnectionFactory->CreateAudioTrack(rtc::CreateRandomUuid(), source);
+        auto audioStream = peerConnectionFactory->CreateLocalMediaStream(rtc::CreateRandomUuid());
         audioStream->AddTrack(audioTrack);
-
+        audioStreams.push_back(audioStream);
+        {
+            std::lock_guard<std::mutex> lock(audioSourcesMutex);
+            audioSources[audioTrack.get()] = source;
+        }
         return audioStream.get();
     }
 
     void Context::DeleteAudioStream(webrtc::MediaStreamInterface* stream)
     {
-        audioStream.release();
+        auto item = std::find(audioStreams.begin(), audioStreams.end(), stream);
+        if (item == audioStreams.end())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(audioSourcesMutex);
+            for (const auto& track : (*item)->GetAudioTracks())
+            {
+                audioSources.erase(track.get());
+            }
+        }
+        for (const auto& track : (*item)->GetAudioTracks())
+        {
+            opusSettings.erase(track.get());
+        }
+        audioStreams.erase(item);
+    }
+
+    void Context::ProcessAudioData(const webrtc::MediaStreamTrackInterface* track, const float* data, int32 size, int32 sampleRate, int32 channels)
+    {
+        std::lock_guard<std::mutex> lock(audioSourcesMutex);
+        if (track == nullptr)
+        {
+            for (auto& source : audioSources)
+            {
+                source.second->ProcessAudioData(data, size, sampleRate, channels);
+            }
+            return;
+        }
+        auto item = audioSources.find(track);
+        if (item != audioSources.end())
+        {
+            item->second->ProcessAudioData(data, size, sampleRate, channels);
+        }
     }
 
-    void Context::ProcessAudioData(const float* data, int32 size)
+    void Context::SetOpusSettings(const webrtc::MediaStreamTrackInterface* track, const OpusSettings& settings)
     {
-        audioDevice->ProcessAudioData(data, size);
+        if (track == nullptr)
+        {
+            defaultOpusSettings = settings;
+            return;
+        }
+        opusSettings[track] = settings;
+    }
+
+    void Context::ApplyOpusSettings(webrtc::PeerConnectionInterface* connection, webrtc::SessionDescriptionInterface* desc)
+    {
+        if (opusSettings.empty() && !defaultOpusSettings)
+        {
+            return;
+        }
+        //audio sections are matched to transceivers the way the peer connection does, by mid, or else
+        //to the first transceiver added by AddTrack which isn't associated yet
+        auto transceivers = connection->GetTransceivers();
+        std::vector<rtc::scoped_refptr<webrtc::RtpTransceiverInterface>> unassociated;
+        for (const auto& transceiver : transceivers)
+        {
+            if (transceiver->media_type() == cricket::MEDIA_TYPE_AUDIO && !transceiver->mid() && !transceiver->stopped())
+            {
+                unassociated.push_back(transceiver);
+            }
+        }
+        WebRTC::ApplyOpusSettings(desc, [&](const std::string& mid) -> const OpusSettings*
+        {
+            rtc::scoped_refptr<webrtc::RtpTransceiverInterface> transceiver;
+            for (const auto& item : transceivers)
+            {
+                if (item->mid() == mid)
+                {
+                    transceiver = item;
+                    break;
+                }
+            }
+            if (!transceiver && !unassociated.empty())
+            {
+                transceiver = unassociated.front();
+                unassociated.erase(unassociated.begin());
+            }
+            if (transceiver)
+            {
+                auto track = transceiver->sender()->track();
+                auto item = opusSettings.find(track.get());
+                if (item != opusSettings.end())
+                {
+                    return &item->second;
+                }
+            }
+            return defaultOpusSettings ? &*defaultOpusSettings : nullptr;
+        });
+    }
+
+    bool Context::GetAudioCaptureStats(const webrtc::MediaStreamTrackInterface* track, AudioCaptureStats* stats)
+    {
+        std::lock_guard<std::mutex> lock(audioSourcesMutex);
+        auto item = audioSources.find(track);
+        if (item == audioSources.end())
+        {
+            return false;
+        }
+        *stats = item->second->GetCaptureStats();
+        return true;
+    }
+
+    void Context::SetAudioPacing(bool enable)
+    {
+        //sources don't switch paths while the audio thread is pushing to them
+        audioPacing = enable;
+    }
+
+    void Context::StartAudioPacer()
+    {
+        std::lock_guard<std::mutex> lock(audioPacerMutex);
+        if (audioPacerRunning)
+        {
+            return;
+        }
+        audioPacerRunning = true;
+        audioPacerThread = std::thread(&Context::AudioPacerLoop, this);
+    }
+
+    void Context::StopAudioPacer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(audioPacerMutex);
+            if (!audioPacerRunning)
+            {
+                return;
+            }
+            audioPacerRunning = false;
+        }
+        audioPacerCondition.notify_all();
+        audioPacerThread.join();
+    }
+
+    void Context::AudioPacerLoop()
+    {
+        const std::chrono::milliseconds interval(10);
+        std::vector<rtc::scoped_refptr<AudioTrackSource>> sources;
+        auto next = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(audioPacerMutex);
+        while (audioPacerRunning)
+        {
+            lock.unlock();
+            {
+                //don't hold the lock the audio thread pushes under while delivering
+                std::lock_guard<std::mutex> sourcesLock(audioSourcesMutex);
+                sources.clear();
+                for (auto& source : audioSources)
+                {
+                    sources.push_back(source.second);
+                }
+            }
+            for (auto& source : sources)
+            {
+                source->DeliverPacedAudio();
+            }
+            lock.lock();
+
+            next += interval;
+            const auto now = std::chrono::steady_clock::now();
+            if (next < now - interval * 5)
+            {
+                //the thread was stalled, don't try to catch up with a burst of chunks
+                next = now;
+            }
+            audioPacerCondition.wait_until(lock, next, [this]() { return !audioPacerRunning; });
+        }
+    }
+
+    void Context::AddPeerConnection(rtc::scoped_refptr<PeerConnectionObject> obj)
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        clients[obj.get()] = std::move(obj);
+    }
+
+    void Context::DeletePeerConnection(PeerConnectionObject* obj)
+    {
+        if (obj->connection != nullptr)
+        {
+            for (const auto& receiver : obj->connection->GetReceivers())
+            {
+                RemoveRemoteAudioTrack(receiver->track());
+            }
+        }
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        statsSamplers.erase(obj);
+        clients.erase(obj);
+    }
+
+    void Context::StartStatsSampler(int32 intervalMs, int32 sampleCount)
+    {
+        StopStatsSampler();
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            //samples of the previous run don't continue with the new settings
+            statsSamplers.clear();
+            statsSampleCount = std::max(sampleCount, 1);
+        }
+        std::lock_guard<std::mutex> lock(statsSamplerMutex);
+        statsSamplerInterval = std::chrono::milliseconds(std::max(intervalMs, 1));
+        statsSamplerRunning = true;
+        statsSamplerThread = std::thread(&Context::StatsSamplerLoop, this);
+    }
+
+    void Context::StopStatsSampler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(statsSamplerMutex);
+            if (!statsSamplerRunning)
+            {
+                return;
+            }
+            statsSamplerRunning = false;
+        }
+        statsSamplerCondition.notify_all();
+        statsSamplerThread.join();
+    }
+
+    int32 Context::GetStatsSamples(const PeerConnectionObject* obj, StatsSample* samples, int32 capacity)
+    {
+        rtc::scoped_refptr<StatsSampler> sampler;
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            auto item = statsSamplers.find(obj);
+            if (item == statsSamplers.end())
+            {
+                return 0;
+            }
+            sampler = item->second;
+        }
+        return sampler->GetSamples(samples, capacity);
+    }
+
+    void Context::StatsSamplerLoop()
+    {
+        //holding the connections rather than the plugin objects, the last reference of a PeerConnectionObject
+        //deleted during a pass must not drop on this thread and call its observers from here
+        std::vector<std::pair<rtc::scoped_refptr<webrtc::PeerConnectionInterface>, rtc::scoped_refptr<StatsSampler>>> targets;
+        std::unique_lock<std::mutex> lock(statsSamplerMutex);
+        while (statsSamplerRunning)
+        {
+            lock.unlock();
+            {
+                std::lock_guard<std::mutex> clientsLock(clientsMutex);
+                targets.clear();
+                for (auto& client : clients)
+                {
+                    rtc::scoped_refptr<StatsSampler>& sampler = statsSamplers[client.first];
+                    if (sampler == nullptr)
+                    {
+                        sampler = new rtc::RefCountedObject<StatsSampler>(statsSampleCount);
+                    }
+                    targets.emplace_back(client.second->connection, sampler);
+                }
+            }
+            //the reports are delivered on the signaling thread, this thread doesn't wait for them
+            for (auto& target : targets)
+            {
+                target.first->GetStats(target.second);
+            }
+            targets.clear();
+            lock.lock();
+            statsSamplerCondition.wait_for(lock, statsSamplerInterval, [this]() { return !statsSamplerRunning; });
+        }
+    }
+
+    size_t Context::MixAudioPlayout(float* data, size_t size)
+    {
+        size_t readFrames = 0;
+        std::lock_guard<std::mutex> lock(audioPlayoutMutex);
+        for (auto& sink : audioPlayoutSinks)
+        {
+            const size_t read = sink.second.first->MixInto(data, size);
+            readFrames = std::max(readFrames, read / AudioPlayoutSink::Channels);
+        }
+        return readFrames;
+    }
+
+    int32 Context::ReadAudioPlayoutData(float* data, int32 size, int32 sampleRate, int32 channels)
+    {
+        if (size <= 0)
+        {
+            return 0;
+        }
+        if (!AudioCaptureConverter::IsSupportedFormat(sampleRate, channels))
+        {
+            std::fill(data, data + size, 0.0f);
+            return 0;
+        }
+        const size_t frames = size / channels;
+        const size_t samples = frames * AudioPlayoutSink::Channels;
+        size_t readFrames = 0;
+        if (sampleRate == AudioPlayoutSink::SampleRate)
+        {
+            audioPlayoutMix.assign(samples, 0.0f);
+            readFrames = MixAudioPlayout(audioPlayoutMix.data(), audioPlayoutMix.size());
+        }
+        else
+        {
+            if (audioPlayoutConverter == nullptr || audioPlayoutConverter->GetOutputSampleRate() != sampleRate)
+            {
+                audioPlayoutConverter = std::make_unique<AudioCaptureConverter>(sampleRate, AudioPlayoutSink::Channels);
+                audioPlayoutResampled.clear();
+            }
+            //the resampler takes whole 10ms blocks, a remainder is kept for the next read
+            audioPlayoutBlock.resize(AudioPlayoutSink::SampleRate / 100 * AudioPlayoutSink::Channels);
+            while (audioPlayoutResampled.size() < samples)
+            {
+                std::fill(audioPlayoutBlock.begin(), audioPlayoutBlock.end(), 0.0f);
+                if (MixAudioPlayout(audioPlayoutBlock.data(), audioPlayoutBlock.size()) == 0)
+                {
+                    break;
+                }
+                audioPlayoutConverter->Process(audioPlayoutBlock.data(), audioPlayoutBlock.size(), AudioPlayoutSink::SampleRate, AudioPlayoutSink::Channels,
+                    [this](const float* block, size_t blockSize)
+                {
+                    audioPlayoutResampled.insert(audioPlayoutResampled.end(), block, block + blockSize);
+                });
+            }
+            readFrames = std::min(samples, audioPlayoutResampled.size()) / AudioPlayoutSink::Channels;
+            const auto end = audioPlayoutResampled.begin() + readFrames * AudioPlayoutSink::Channels;
+            audioPlayoutMix.assign(audioPlayoutResampled.begin(), end);
+            audioPlayoutResampled.erase(audioPlayoutResampled.begin(), end);
+        }
+        for (float& sample : audioPlayoutMix)
+        {
+            sample = std::min(std::max(sample, -1.0f), 1.0f);
+        }
+        if (channels == AudioPlayoutSink::Channels)
+        {
+            std::copy(audioPlayoutMix.begin(), audioPlayoutMix.begin() + readFrames * channels, data);
+        }
+        else
+        {
+            AudioCaptureConverter::MixChannels(audioPlayoutMix.data(), AudioPlayoutSink::Channels, data, channels, readFrames);
+        }
+        const size_t read = readFrames * channels;
+        std::fill(data + read, data + size, 0.0f);
+        return static_cast<int32>(read);
+    }
+
+    void Context::AddRemoteAudioTrack(webrtc::AudioTrackInterface* track)
+    {
+        {
+            std::lock_guard<std::mutex> lock(audioPlayoutMutex);
+            if (audioPlayoutSinks.count(track) > 0)
+            {
+                return;
+            }
+        }
+        //the track may call back into the sinks while attaching, don't hold the lock the audio thread reads under
+        auto sink = std::make_unique<AudioPlayoutSink>();
+        track->AddSink(sink.get());
+        std::lock_guard<std::mutex> lock(audioPlayoutMutex);
+        audioPlayoutSinks[track] = std::make_pair(std::move(sink), rtc::scoped_refptr<webrtc::AudioTrackInterface>(track));
+    }
+
+    void Context::RemoveRemoteAudioTrack(const webrtc::MediaStreamTrackInterface* track)
+    {
+        std::pair<std::unique_ptr<AudioPlayoutSink>, rtc::scoped_refptr<webrtc::AudioTrackInterface>> sink;
+        {
+            std::lock_guard<std::mutex> lock(audioPlayoutMutex);
+            auto item = audioPlayoutSinks.find(track);
+            if (item == audioPlayoutSinks.end())
+            {
+                return;
+            }
+            sink = std::move(item->second);
+            audioPlayoutSinks.erase(item);
+        }
+        //after RemoveSink returns the playout thread no longer calls OnData
+        sink.second->RemoveSink(sink.first.get());
     }
 
     DataChannelObject* Context::CreateDataChannel(PeerConnectionObject* obj, const char* label, const RTCDataChannelInit& options)
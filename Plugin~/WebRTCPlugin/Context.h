@@ -1,7 +1,16 @@
 #pragma once
-#include "DummyAudioDevice.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "FactoryResources.h"
+#include "AudioTrackSource.h"
+#include "AudioPlayoutSink.h"
+#include "OpusSettings.h"
+#include "StatsSampler.h"
 #include "PeerConnectionObject.h"
 #include "NvVideoCapturer.h"
+#include "VideoFrameReceiver.h"
+#include "HardwareVideoDecoderFactory.h"
 #include "Codec/IEncoder.h"
 
 namespace WebRTC
@@ -15,7 +24,7 @@ namespace WebRTC
         static ContextManager* GetInstance() { return &s_instance; }
      
         Context* GetContext(int uid) const;
-        Context* CreateContext(int uid, UnityEncoderType encoderType);
+        Context* CreateContext(int uid, UnityEncoderType encoderType, bool shareFactory = false);
         void DestroyContext(int uid);
         void SetCurContext(Context*);
 
@@ -31,27 +40,67 @@ namespace WebRTC
     class Context
     {
     public:
-        explicit Context(int uid = -1, UnityEncoderType encoderType = UnityEncoderType::UnityEncoderHardware);
+        //shareFactory uses the threads and the peer connection factory of every other context created with it
+        explicit Context(int uid = -1, UnityEncoderType encoderType = UnityEncoderType::UnityEncoderHardware, bool shareFactory = false);
         ~Context();
 
-        CodecInitializationResult GetCodecInitializationResult();
-        webrtc::MediaStreamInterface* CreateVideoStream(void* frameBuffer, int width, int height);
+        //Passing nullptr as track aggregates the results of every video track.
+        CodecInitializationResult GetCodecInitializationResult(const webrtc::MediaStreamTrackInterface* track = nullptr);
+        webrtc::MediaStreamInterface* CreateVideoStream(void* frameBuffer, int width, int height, int simulcastLayers = 1);
         void DeleteVideoStream(webrtc::MediaStreamInterface* stream);
         webrtc::MediaStreamInterface* CreateAudioStream();
         void DeleteAudioStream(webrtc::MediaStreamInterface* stream);
         PeerConnectionObject* CreatePeerConnection();
         PeerConnectionObject* CreatePeerConnection(const std::string& conf);
-        void DeletePeerConnection(PeerConnectionObject* obj) { clients.erase(obj); }
+        void DeletePeerConnection(PeerConnectionObject* obj);
         UnityEncoderType GetEncoderType() const;
+        //how the bitrates requested by the peer connections sharing a video track are merged
+        void SetBitratePolicy(BitratePolicy policy);
+        VideoDecoderStats GetVideoDecoderStats() const;
+        //used for the remote video tracks negotiated afterwards, contexts sharing a factory share their backends
+        void AddVideoDecoderBackend(std::unique_ptr<IHardwareDecoderBackend> backend);
+        HardwareVideoDecoderFactory* GetVideoDecoderFactory() const;
 
         // You must call these methods on Rendering thread.
-        bool InitializeEncoder(IGraphicsDevice* device);
-        void EncodeFrame();
-        void FinalizeEncoder();
+        // Passing nullptr as track applies the call to every video track of this context.
+        bool InitializeEncoder(IGraphicsDevice* device, const webrtc::MediaStreamTrackInterface* track = nullptr);
+        void EncodeFrame(const webrtc::MediaStreamTrackInterface* track, int64 captureTimeUs);
+        void FinalizeEncoder(const webrtc::MediaStreamTrackInterface* track = nullptr);
+        bool HasInitializedEncoder();
         //
 
-        void StopCapturer() { nvVideoCapturer->Stop(); }
-        void ProcessAudioData(const float* data, int32 size);
+        //min and max delay the remote receivers should render the frames of this track with, -1 leaves it to them
+        //returns false if the bounds are out of range or min exceeds max
+        bool SetPlayoutDelay(const webrtc::MediaStreamTrackInterface* track, int minMs, int maxMs);
+        //returns false if the track has no encoder for the simulcast layer, 0 is the lowest resolution
+        bool GetEncoderStats(const webrtc::MediaStreamTrackInterface* track, int32 layer, EncoderStats* stats);
+        void StopCapturer(const webrtc::MediaStreamTrackInterface* track);
+        //receives the decoded frames of a remote video track, returns nullptr if the track isn't a video track
+        VideoFrameReceiver* CreateVideoReceiver(webrtc::MediaStreamTrackInterface* track);
+        void DeleteVideoReceiver(VideoFrameReceiver* receiver);
+        //Passing nullptr as track sends the samples to every audio track of this context.
+        void ProcessAudioData(const webrtc::MediaStreamTrackInterface* track, const float* data, int32 size, int32 sampleRate, int32 channels);
+        //mixes the remote audio tracks of the peer connections of this context in the sample rate and channel count of the caller.
+        //returns the number of samples read, the rest of data is filled with silence
+        int32 ReadAudioPlayoutData(float* data, int32 size, int32 sampleRate, int32 channels);
+        //called by the peer connections of this context on the signaling thread
+        void AddRemoteAudioTrack(webrtc::AudioTrackInterface* track);
+        void RemoveRemoteAudioTrack(const webrtc::MediaStreamTrackInterface* track);
+        //paces the audio streams created afterwards on a steady 10ms clock and compensates the drift
+        //of the application's audio clock, off by default so the samples are sent as soon as they are pushed
+        void SetAudioPacing(bool enable);
+        //Passing nullptr as track sets the settings of audio tracks which have none of their own.
+        void SetOpusSettings(const webrtc::MediaStreamTrackInterface* track, const OpusSettings& settings);
+        //writes the opus settings of the local tracks into a remote description before it is applied
+        void ApplyOpusSettings(webrtc::PeerConnectionInterface* connection, webrtc::SessionDescriptionInterface* desc);
+        //returns false if the track isn't a local audio track of this context
+        bool GetAudioCaptureStats(const webrtc::MediaStreamTrackInterface* track, AudioCaptureStats* stats);
+
+        //collects the stats of every peer connection each intervalMs, and keeps the latest sampleCount samples of each
+        void StartStatsSampler(int32 intervalMs, int32 sampleCount);
+        void StopStatsSampler();
+        //copies up to capacity samples of the connection, oldest first, and returns how many were copied
+        int32 GetStatsSamples(const PeerConnectionObject* obj, StatsSample* samples, int32 capacity);
 
         DataChannelObject* CreateDataChannel(PeerConnectionObject* obj, const char* label, const RTCDataChannelInit& options);
         void DeleteDataChannel(DataChannelObject* obj);
@@ -59,20 +108,60 @@ namespace WebRTC
         std::map<DataChannelObject*, std::unique_ptr<DataChannelObject>> dataChannels;
 
     private:
+        std::vector<NvVideoCapturer*> GetVideoCapturers(const webrtc::MediaStreamTrackInterface* track);
+        void StartAudioPacer();
+        void StopAudioPacer();
+        void AudioPacerLoop();
+        void AddPeerConnection(rtc::scoped_refptr<PeerConnectionObject> obj);
+        void StatsSamplerLoop();
+
         int m_uid;
         UnityEncoderType m_encoderType;
-        std::unique_ptr<rtc::Thread> workerThread;
-        std::unique_ptr<rtc::Thread> signalingThread;
+        BitratePolicy m_bitratePolicy = BitratePolicy::Latest;
+        std::shared_ptr<FactoryResources> factoryResources;
         std::map<PeerConnectionObject*, rtc::scoped_refptr<PeerConnectionObject>> clients;
+        //clients is read by the stats sampler thread
+        std::mutex clientsMutex;
         rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> peerConnectionFactory;
-        NvVideoCapturer* nvVideoCapturer;
-        std::unique_ptr<NvVideoCapturer> nvVideoCapturerUnique;
-        rtc::scoped_refptr<DummyAudioDevice> audioDevice;
-        rtc::scoped_refptr<webrtc::AudioTrackInterface> audioTrack;
-        rtc::scoped_refptr<webrtc::MediaStreamInterface> audioStream;
-        //TODO: move videoTrack to NvVideoCapturer and maintain multiple NvVideoCapturer here
+        std::vector<rtc::scoped_refptr<webrtc::MediaStreamInterface>> audioStreams;
+        std::map<const webrtc::MediaStreamTrackInterface*, rtc::scoped_refptr<AudioTrackSource>> audioSources;
+        //audioSources is touched by both the main thread and the audio thread
+        std::mutex audioSourcesMutex;
+        std::map<const webrtc::MediaStreamTrackInterface*, OpusSettings> opusSettings;
+        absl::optional<OpusSettings> defaultOpusSettings;
+        //delivers the captured audio of every source on a steady 10ms clock
+        std::thread audioPacerThread;
+        std::mutex audioPacerMutex;
+        std::condition_variable audioPacerCondition;
+        bool audioPacerRunning = false;
+        bool audioPacing = false;
+        std::thread statsSamplerThread;
+        std::mutex statsSamplerMutex;
+        std::condition_variable statsSamplerCondition;
+        bool statsSamplerRunning = false;
+        std::chrono::milliseconds statsSamplerInterval {1000};
+        size_t statsSampleCount = 0;
+        //guarded by clientsMutex
+        std::map<const PeerConnectionObject*, rtc::scoped_refptr<StatsSampler>> statsSamplers;
         std::vector<rtc::scoped_refptr<webrtc::MediaStreamInterface>> videoStreams;
-        std::map<const void*, rtc::scoped_refptr<webrtc::VideoTrackInterface>> videoTracks;
+        //the capturers are owned by the track sources, keeping the track alive keeps its capturer alive
+        std::map<const webrtc::MediaStreamTrackInterface*, rtc::scoped_refptr<webrtc::VideoTrackInterface>> videoTracks;
+        std::map<const webrtc::MediaStreamTrackInterface*, NvVideoCapturer*> videoCapturers;
+        //videoCapturers is touched by both the main thread and the rendering thread
+        std::mutex videoCapturersMutex;
+        std::map<VideoFrameReceiver*, std::pair<std::unique_ptr<VideoFrameReceiver>, rtc::scoped_refptr<webrtc::VideoTrackInterface>>> videoReceivers;
+        //the audio device is shared with the contexts sharing the factory, each context plays its own remote tracks
+        std::map<const webrtc::MediaStreamTrackInterface*, std::pair<std::unique_ptr<AudioPlayoutSink>, rtc::scoped_refptr<webrtc::AudioTrackInterface>>> audioPlayoutSinks;
+        //audioPlayoutSinks is touched by both the signaling thread and the audio thread
+        std::mutex audioPlayoutMutex;
+        //used by the audio thread
+        size_t MixAudioPlayout(float* data, size_t size);
+        std::vector<float> audioPlayoutMix;
+        //converts the 48kHz stereo of the sinks when the caller plays at another rate
+        std::unique_ptr<AudioCaptureConverter> audioPlayoutConverter;
+        std::vector<float> audioPlayoutBlock;
+        //resampled samples left over from the previous read
+        std::vector<float> audioPlayoutResampled;
     };
 
     class PeerSDPObserver : public webrtc::SetSessionDescriptionObserver
@@ -0,0 +1,184 @@
+#include "pch.h"
+#include "DataChannelChunking.h"
+#include "rtc_base/byte_order.h"
+
+namespace WebRTC
+{
+    namespace
+    {
+        //merges [begin, end) into ranges and returns how many of its bytes weren't in them yet
+        size_t AddRange(std::map<size_t, size_t>& ranges, size_t begin, size_t end)
+        {
+            size_t added = end - begin;
+            size_t mergedBegin = begin;
+            size_t mergedEnd = end;
+            auto it = ranges.upper_bound(begin);
+            if (it != ranges.begin() && std::prev(it)->second >= begin)
+            {
+                --it;
+            }
+            while (it != ranges.end() && it->first <= end)
+            {
+                const size_t overlapBegin = std::max(it->first, begin);
+                const size_t overlapEnd = std::min(it->second, end);
+                if (overlapEnd > overlapBegin)
+                {
+                    added -= overlapEnd - overlapBegin;
+                }
+                mergedBegin = std::min(mergedBegin, it->first);
+                mergedEnd = std::max(mergedEnd, it->second);
+                it = ranges.erase(it);
+            }
+            ranges.emplace(mergedBegin, mergedEnd);
+            return added;
+        }
+    }
+
+    ChunkedMessageSender::ChunkedMessageSender(size_t chunkSize)
+        : chunkSize(std::max(chunkSize, ChunkHeaderSize + 1))
+    {
+    }
+
+    uint32 ChunkedMessageSender::Enqueue(const byte* data, size_t size)
+    {
+        const uint32 id = nextTransferId++;
+        transfers.push_back(Transfer { id, std::vector<byte>(data, data + size), 0 });
+        pendingSize += size;
+        return id;
+    }
+
+    size_t ChunkedMessageSender::NextChunk(byte* dst)
+    {
+        if (transfers.empty())
+        {
+            return 0;
+        }
+        Transfer transfer = std::move(transfers.front());
+        transfers.pop_front();
+
+        const size_t payloadSize = std::min(chunkSize - ChunkHeaderSize, transfer.data.size() - transfer.offset);
+        dst[0] = static_cast<byte>(ChunkedMessageType::Chunk);
+        rtc::SetBE32(dst + 1, transfer.id);
+        rtc::SetBE32(dst + 1 + sizeof(uint32), static_cast<uint32>(transfer.data.size()));
+        rtc::SetBE32(dst + 1 + 2 * sizeof(uint32), static_cast<uint32>(transfer.offset));
+        memcpy(dst + ChunkHeaderSize, transfer.data.data() + transfer.offset, payloadSize);
+        transfer.offset += payloadSize;
+        pendingSize -= payloadSize;
+
+        //round robin, an unfinished transfer waits behind the others
+        if (transfer.offset < transfer.data.size())
+        {
+            transfers.push_back(std::move(transfer));
+        }
+        return ChunkHeaderSize + payloadSize;
+    }
+
+    void ChunkedMessageSender::WriteWholeMessageHeader(byte* dst)
+    {
+        dst[0] = static_cast<byte>(ChunkedMessageType::Whole);
+    }
+
+    ChunkedMessageReceiver::ChunkedMessageReceiver(size_t maxMessageSize, size_t maxPendingSize, size_t maxPendingTransfers)
+        : maxMessageSize(maxMessageSize)
+        , maxPendingSize(maxPendingSize)
+        , maxPendingTransfers(std::max<size_t>(maxPendingTransfers, 1))
+    {
+    }
+
+    bool ChunkedMessageReceiver::Receive(const byte* data, size_t size, const MessageHandler& onMessage)
+    {
+        if (size < WholeMessageHeaderSize)
+        {
+            return false;
+        }
+        switch (static_cast<ChunkedMessageType>(data[0]))
+        {
+        case ChunkedMessageType::Whole:
+            onMessage(data + WholeMessageHeaderSize, size - WholeMessageHeaderSize);
+            return true;
+        case ChunkedMessageType::Chunk:
+            break;
+        default:
+            return false;
+        }
+        if (size < ChunkHeaderSize)
+        {
+            return false;
+        }
+        const uint32 id = rtc::GetBE32(data + 1);
+        const size_t totalSize = rtc::GetBE32(data + 1 + sizeof(uint32));
+        const size_t offset = rtc::GetBE32(data + 1 + 2 * sizeof(uint32));
+        const size_t payloadSize = size - ChunkHeaderSize;
+        if (totalSize > maxMessageSize || offset > totalSize || payloadSize > totalSize - offset)
+        {
+            return false;
+        }
+
+        auto it = transfers.find(id);
+        if (it == transfers.end())
+        {
+            if (IsDropped(id))
+            {
+                return true;
+            }
+            if (!MakeRoom(totalSize))
+            {
+                return false;
+            }
+            //the first chunk allocates the whole message
+            it = transfers.emplace(id, Transfer { std::vector<byte>(totalSize), {}, 0 }).first;
+            transferOrder.push_back(id);
+            pendingSize += totalSize;
+        }
+        Transfer& transfer = it->second;
+        if (transfer.data.size() != totalSize)
+        {
+            return false;
+        }
+        memcpy(transfer.data.data() + offset, data + ChunkHeaderSize, payloadSize);
+        transfer.receivedSize += AddRange(transfer.ranges, offset, offset + payloadSize);
+        if (transfer.receivedSize >= totalSize)
+        {
+            onMessage(transfer.data.data(), transfer.data.size());
+            pendingSize -= totalSize;
+            transfers.erase(it);
+            transferOrder.erase(std::find(transferOrder.begin(), transferOrder.end(), id));
+        }
+        return true;
+    }
+
+    bool ChunkedMessageReceiver::MakeRoom(size_t size)
+    {
+        if (size > maxPendingSize)
+        {
+            return false;
+        }
+        while (transfers.size() >= maxPendingTransfers || pendingSize + size > maxPendingSize)
+        {
+            DropOldestTransfer();
+        }
+        return true;
+    }
+
+    void ChunkedMessageReceiver::DropOldestTransfer()
+    {
+        const uint32 id = transferOrder.front();
+        transferOrder.pop_front();
+        auto it = transfers.find(id);
+        pendingSize -= it->second.data.size();
+        transfers.erase(it);
+
+        droppedIds.push_back(id);
+        if (droppedIds.size() > maxPendingTransfers)
+        {
+            droppedIds.pop_front();
+        }
+        droppedTransferCount++;
+        DebugWarning("Dropped a partially received chunked message to make room for a new one");
+    }
+
+    bool ChunkedMessageReceiver::IsDropped(uint32 id) const
+    {
+        return std::find(droppedIds.begin(), droppedIds.end(), id) != droppedIds.end();
+    }
+}
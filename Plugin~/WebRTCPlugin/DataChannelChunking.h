@@ -0,0 +1,112 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace WebRTC
+{
+    // With chunking enabled, every binary message of a data channel starts with a type byte.
+    // A whole message is followed by its payload. A chunk is followed by the id of its transfer,
+    // the size of the whole message and the offset of the chunk in it, as big endian uint32,
+    // and then by the chunk payload.
+    // Text messages are sent as they are. Chunking has to be enabled on both ends of a reliable channel.
+    enum class ChunkedMessageType : uint8
+    {
+        Whole = 0,
+        Chunk = 1,
+    };
+
+    const size_t WholeMessageHeaderSize = 1;
+    const size_t ChunkHeaderSize = 1 + 3 * sizeof(uint32);
+
+    // ChunkedMessageSender splits the messages larger than a chunk and hands out their chunks
+    // one at a time, taking turns between transfers so that a large message doesn't hold back
+    // the ones queued after it.
+    // It isn't thread safe.
+    class ChunkedMessageSender
+    {
+    public:
+        // chunkSize is the largest message sent on the wire, headers included.
+        explicit ChunkedMessageSender(size_t chunkSize);
+
+        size_t GetChunkSize() const { return chunkSize; }
+        // Payloads up to this size are sent whole.
+        size_t GetMaxWholeMessageSize() const { return chunkSize - WholeMessageHeaderSize; }
+
+        // Copies a message to be sent in chunks, returns the id of its transfer.
+        uint32 Enqueue(const byte* data, size_t size);
+        bool HasPendingChunks() const { return !transfers.empty(); }
+        // Payload bytes of the queued transfers which haven't been handed out yet.
+        size_t GetPendingSize() const { return pendingSize; }
+        // Writes the next chunk to dst, which holds at least GetChunkSize() bytes, and returns its size.
+        // Returns 0 if no chunk is pending.
+        size_t NextChunk(byte* dst);
+
+        static void WriteWholeMessageHeader(byte* dst);
+
+    private:
+        struct Transfer
+        {
+            uint32 id;
+            std::vector<byte> data;
+            size_t offset;
+        };
+        const size_t chunkSize;
+        uint32 nextTransferId = 0;
+        std::deque<Transfer> transfers;
+        size_t pendingSize = 0;
+    };
+
+    // ChunkedMessageReceiver parses the binary messages framed by ChunkedMessageSender and
+    // reassembles chunked messages into a buffer allocated once at their full size, chunks may
+    // arrive in any order and a chunk received twice is only counted once.
+    // The transfers being reassembled are limited in number and in total size. A transfer which
+    // doesn't fit drops the oldest ones, whose remaining chunks are then ignored.
+    // It isn't thread safe.
+    class ChunkedMessageReceiver
+    {
+    public:
+        using MessageHandler = std::function<void(const byte* data, size_t size)>;
+        static const size_t DefaultMaxMessageSize = 256 * 1024 * 1024;
+        static const size_t DefaultMaxPendingSize = 256 * 1024 * 1024;
+        static const size_t DefaultMaxPendingTransfers = 64;
+
+        explicit ChunkedMessageReceiver(size_t maxMessageSize = DefaultMaxMessageSize,
+            size_t maxPendingSize = DefaultMaxPendingSize, size_t maxPendingTransfers = DefaultMaxPendingTransfers);
+
+        // Calls onMessage with the payload of a whole message, or of a chunked message once its
+        // last chunk is in. Returns false if the message is malformed.
+        bool Receive(const byte* data, size_t size, const MessageHandler& onMessage);
+        size_t GetPendingTransferCount() const { return transfers.size(); }
+        // Bytes allocated for the transfers being reassembled.
+        size_t GetPendingSize() const { return pendingSize; }
+        // Transfers dropped to make room for newer ones.
+        uint64 GetDroppedTransferCount() const { return droppedTransferCount; }
+
+    private:
+        struct Transfer
+        {
+            std::vector<byte> data;
+            //disjoint ranges of the message received so far, begin to end
+            std::map<size_t, size_t> ranges;
+            size_t receivedSize;
+        };
+        //returns false if the transfer can't fit even after dropping every other transfer
+        bool MakeRoom(size_t size);
+        void DropOldestTransfer();
+        bool IsDropped(uint32 id) const;
+
+        const size_t maxMessageSize;
+        const size_t maxPendingSize;
+        const size_t maxPendingTransfers;
+        std::map<uint32, Transfer> transfers;
+        //ids of the pending transfers, oldest first
+        std::deque<uint32> transferOrder;
+        //ids of the latest dropped transfers, so that their remaining chunks don't start them over
+        std::deque<uint32> droppedIds;
+        size_t pendingSize = 0;
+        uint64 droppedTransferCount = 0;
+    };
+}
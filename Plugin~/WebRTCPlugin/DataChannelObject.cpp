@@ -20,6 +20,7 @@ namespace WebRTC
         onClose = nullptr;
         onOpen = nullptr;
         onMessage = nullptr;
+        onBufferedAmountLow = nullptr;
     }
 
     void DataChannelObject::OnStateChange()
@@ -45,14 +46,276 @@ namespace WebRTC
     }
     void DataChannelObject::OnMessage(const webrtc::DataBuffer& buffer)
     {
-        if (onMessage != nullptr)
+        if (buffer.binary && chunkingEnabled.load(std::memory_order_acquire))
         {
-            size_t size = buffer.data.size();
-            if (onMessage != nullptr)
+            const bool valid = chunkReceiver->Receive(buffer.data.data(), buffer.data.size(),
+                [this](const byte* data, size_t size) { DeliverMessage(data, size); });
+            if (!valid)
             {
+                DebugWarning("DataChannelObject::OnMessage: dropped a malformed chunked message");
+            }
+            return;
+        }
+        DeliverMessage(buffer.data.data(), buffer.data.size());
+    }
+
+    void DataChannelObject::DeliverMessage(const byte* data, size_t size)
+    {
+        if (DataChannelReceiveQueue* queue = receiveQueue.load(std::memory_order_acquire))
+        {
+            queue->Push(data, size);
+            return;
+        }
+        if (onMessage != nullptr)
+        {
 #pragma warning(suppress: 4267)
-                onMessage(this, buffer.data.data(), size);
+            onMessage(this, data, size);
+        }
+    }
+
+    void DataChannelObject::OnBufferedAmountChange(uint64_t sentDataSize)
+    {
+        if (chunkingEnabled)
+        {
+            PumpChunks();
+        }
+        CheckBufferedAmountLow();
+    }
+
+    bool DataChannelObject::EnableChunking(size_t chunkSize)
+    {
+        if (chunkingEnabled)
+        {
+            return false;
+        }
+        chunkSender = std::make_unique<ChunkedMessageSender>(chunkSize);
+        chunkReceiver = std::make_unique<ChunkedMessageReceiver>();
+        chunkingEnabled.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool DataChannelObject::SendBinary(const byte* data, size_t size)
+    {
+        if (!chunkingEnabled)
+        {
+            return SendBuffer(webrtc::DataBuffer(rtc::CopyOnWriteBuffer(data, size), true));
+        }
+        if (size <= chunkSender->GetMaxWholeMessageSize())
+        {
+            rtc::CopyOnWriteBuffer buffer(size + WholeMessageHeaderSize);
+            ChunkedMessageSender::WriteWholeMessageHeader(buffer.data());
+            memcpy(buffer.data() + WholeMessageHeaderSize, data, size);
+            return SendBuffer(webrtc::DataBuffer(buffer, true));
+        }
+        if (dataChannel->state() != webrtc::DataChannelInterface::kOpen)
+        {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(chunkMutex);
+            chunkSender->Enqueue(data, size);
+        }
+        PumpChunks();
+        return true;
+    }
+
+    void DataChannelObject::PumpChunks()
+    {
+        //chunks are only handed to the channel while little is buffered, so that the messages
+        //sent in the meantime don't wait behind a whole large message
+        const uint64 window = ChunkSendWindow * chunkSender->GetChunkSize();
+        while (dataChannel->buffered_amount() < window)
+        {
+            rtc::CopyOnWriteBuffer chunk(chunkSender->GetChunkSize());
+            {
+                //not held while sending, the channel calls OnBufferedAmountChange from the signaling thread
+                std::lock_guard<std::mutex> lock(chunkMutex);
+                chunk.SetSize(chunkSender->NextChunk(chunk.data()));
+            }
+            if (chunk.size() == 0 || !SendBuffer(webrtc::DataBuffer(chunk, true)))
+            {
+                break;
+            }
+        }
+    }
+
+    uint64 DataChannelObject::GetPendingChunkedSize()
+    {
+        if (!chunkingEnabled)
+        {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(chunkMutex);
+        return chunkSender->GetPendingSize();
+    }
+
+    void DataChannelObject::CheckBufferedAmountLow()
+    {
+        if (dataChannel->buffered_amount() > bufferedAmountLowThreshold || !aboveLowThreshold.exchange(false))
+        {
+            return;
+        }
+        bufferedAmountLow = true;
+        if (onBufferedAmountLow != nullptr)
+        {
+            onBufferedAmountLow(this);
+        }
+    }
+
+    bool DataChannelObject::SendBuffer(const webrtc::DataBuffer& buffer)
+    {
+        const bool result = dataChannel->Send(buffer);
+        if (dataChannel->buffered_amount() > bufferedAmountLowThreshold)
+        {
+            aboveLowThreshold = true;
+            //the buffer may have been drained before the flag was set
+            CheckBufferedAmountLow();
+        }
+        return result;
+    }
+
+    bool DataChannelObject::TrySend(const byte* data, int len)
+    {
+        const uint64 highThreshold = bufferedAmountHighThreshold;
+        if (highThreshold > 0 && dataChannel->buffered_amount() + GetPendingChunkedSize() + len > highThreshold)
+        {
+            return false;
+        }
+        return SendBinary(data, len);
+    }
+
+    bool DataChannelObject::EnableReceiveQueue(size_t capacity)
+    {
+        if (receiveQueueStorage != nullptr)
+        {
+            return false;
+        }
+        receiveQueueStorage = std::make_unique<DataChannelReceiveQueue>(capacity);
+        receiveQueue.store(receiveQueueStorage.get(), std::memory_order_release);
+        return true;
+    }
+
+    int DataChannelObject::ReceiveMessages(byte* data, int size, int* sizes, int count)
+    {
+        DataChannelReceiveQueue* queue = receiveQueue.load(std::memory_order_acquire);
+        if (queue == nullptr || size < 0)
+        {
+            return 0;
+        }
+        return queue->Pop(data, size, sizes, count);
+    }
+
+    int DataChannelObject::GetNextMessageSize()
+    {
+        DataChannelReceiveQueue* queue = receiveQueue.load(std::memory_order_acquire);
+        return queue != nullptr ? queue->GetNextMessageSize() : -1;
+    }
+
+    int DataChannelObject::Send(const byte* data, int size, const int* offsets, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            const int begin = offsets[i];
+            const int end = i + 1 < count ? offsets[i + 1] : size;
+            if (begin < 0 || end < begin || end > size)
+            {
+                LogPrint("DataChannelObject::Send: invalid offset of message %d", i);
+                return i;
             }
+            //m79 buffers can't share memory, each message still needs its own copy
+            if (!SendBinary(data + begin, end - begin))
+            {
+                return i;
+            }
+        }
+        return count;
+    }
+
+    DataChannelBuffer* DataChannelObject::AcquireBuffer(int capacity)
+    {
+        if (capacity < 0)
+        {
+            return nullptr;
+        }
+        std::unique_ptr<DataChannelBuffer> buffer;
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        if (freeBuffers.empty())
+        {
+            buffer = std::make_unique<DataChannelBuffer>();
+        }
+        else
+        {
+            buffer = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+        }
+        //room for the header in front of the message
+        buffer->offset = chunkingEnabled ? WholeMessageHeaderSize : 0;
+        //a buffer still referenced by a queued message is cloned here instead of overwritten
+        buffer->data.SetSize(buffer->offset + capacity);
+        auto ptr = buffer.get();
+        acquiredBuffers[ptr] = std::move(buffer);
+        return ptr;
+    }
+
+    bool DataChannelObject::Send(DataChannelBuffer* buffer, int size)
+    {
+        auto owned = TakeBuffer(buffer);
+        if (owned == nullptr)
+        {
+            return false;
+        }
+        bool result = false;
+        const size_t offset = owned->offset;
+        if (size >= 0 && static_cast<size_t>(size) <= owned->data.size() - offset)
+        {
+            if (chunkingEnabled && (offset != WholeMessageHeaderSize || static_cast<size_t>(size) > chunkSender->GetMaxWholeMessageSize()))
+            {
+                //acquired before chunking was enabled, or has to be split
+                result = SendBinary(owned->data.cdata() + offset, size);
+            }
+            else
+            {
+                if (offset == WholeMessageHeaderSize)
+                {
+                    ChunkedMessageSender::WriteWholeMessageHeader(owned->data.data());
+                }
+                owned->data.SetSize(offset + size);
+                //the channel keeps a reference to the memory while the message is queued
+                result = SendBuffer(webrtc::DataBuffer(owned->data, true));
+            }
+        }
+        RecycleBuffer(std::move(owned));
+        return result;
+    }
+
+    void DataChannelObject::ReleaseBuffer(DataChannelBuffer* buffer)
+    {
+        auto owned = TakeBuffer(buffer);
+        if (owned != nullptr)
+        {
+            RecycleBuffer(std::move(owned));
+        }
+    }
+
+    void DataChannelObject::RecycleBuffer(std::unique_ptr<DataChannelBuffer> buffer)
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        if (freeBuffers.size() < MaxPooledBuffers)
+        {
+            freeBuffers.push_back(std::move(buffer));
+        }
+    }
+
+    std::unique_ptr<DataChannelBuffer> DataChannelObject::TakeBuffer(DataChannelBuffer* buffer)
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        auto it = acquiredBuffers.find(buffer);
+        if (it == acquiredBuffers.end())
+        {
+            return nullptr;
         }
+        auto owned = std::move(it->second);
+        acquiredBuffers.erase(it);
+        return owned;
     }
 }
@@ -1,5 +1,10 @@
 ﻿#pragma once
 
+#include <map>
+#include <mutex>
+#include "DataChannelChunking.h"
+#include "DataChannelReceiveQueue.h"
+
 namespace WebRTC
 {
     class PeerConnectionObject;
@@ -7,6 +12,18 @@ namespace WebRTC
     using DelegateOnMessage = void(*)(DataChannelObject*, const byte*, int);
     using DelegateOnOpen = void(*)(DataChannelObject*);
     using DelegateOnClose = void(*)(DataChannelObject*);
+    using DelegateOnBufferedAmountLow = void(*)(DataChannelObject*);
+
+    // DataChannelBuffer is a send buffer owned by the plugin. The caller writes a message into
+    // it in place and hands it back with DataChannelObject::Send, so the message is neither
+    // marshalled nor copied into a new buffer. Buffers are recycled by the channel which
+    // handed them out.
+    struct DataChannelBuffer
+    {
+        rtc::CopyOnWriteBuffer data;
+        //the message starts after the room left for the chunking header
+        size_t offset = 0;
+    };
 
     class DataChannelObject : public webrtc::DataChannelObserver
     {
@@ -28,17 +45,55 @@ namespace WebRTC
         }
         void Send(const char* data)
         {
-            dataChannel->Send(webrtc::DataBuffer(std::string(data)));
+            SendBuffer(webrtc::DataBuffer(std::string(data)));
         }
         void Send(const byte* data, int len)
         {
-            rtc::CopyOnWriteBuffer buf(data, len);
-            dataChannel->Send(webrtc::DataBuffer(buf, true));
+            SendBinary(data, len);
         }
+        // Sends unless the message would take the buffered amount past the high threshold,
+        // so a sender can't fill up the memory of a congested connection.
+        bool TrySend(const byte* data, int len);
+        uint64 GetBufferedAmount() const
+        {
+            return dataChannel->buffered_amount();
+        }
+        // onBufferedAmountLow is called, and the flag read by PollBufferedAmountLow is set,
+        // when the buffered amount falls to the low threshold from above it.
+        void SetBufferedAmountLowThreshold(uint64 value) { bufferedAmountLowThreshold = value; }
+        uint64 GetBufferedAmountLowThreshold() const { return bufferedAmountLowThreshold; }
+        // 0 lets TrySend buffer as much as the channel accepts.
+        void SetBufferedAmountHighThreshold(uint64 value) { bufferedAmountHighThreshold = value; }
+        uint64 GetBufferedAmountHighThreshold() const { return bufferedAmountHighThreshold; }
+        // Returns true once after each time the buffered amount fell to the low threshold.
+        bool PollBufferedAmountLow() { return bufferedAmountLow.exchange(false); }
+        // Sends count binary messages packed in data, message i starts at offsets[i] and ends
+        // where the next one starts, the last one ends at size.
+        // Returns the number of messages handed to the channel, it stops at the first failure.
+        int Send(const byte* data, int size, const int* offsets, int count);
+        // The caller owns the returned buffer until it is sent or released.
+        DataChannelBuffer* AcquireBuffer(int capacity);
+        // Sends the first size bytes of buffer as a binary message, the ownership of buffer
+        // moves back to the channel whether the message could be sent or not.
+        bool Send(DataChannelBuffer* buffer, int size);
+        void ReleaseBuffer(DataChannelBuffer* buffer);
         void RegisterOnMessage(DelegateOnMessage callback)
         {
             onMessage = callback;
         }
+        // Binary messages larger than chunkSize are split into chunks sent a few at a time, and
+        // reassembled by the receiving channel, which has to enable chunking too. A chunked
+        // message may arrive after smaller messages sent later. Returns false if already enabled.
+        bool EnableChunking(size_t chunkSize);
+        // Bytes of chunked messages not handed to the channel yet, they don't count in GetBufferedAmount.
+        uint64 GetPendingChunkedSize();
+        // Messages received from now on are queued for ReceiveMessages instead of being passed
+        // to onMessage. Returns false if the queue is already enabled.
+        bool EnableReceiveQueue(size_t capacity);
+        // See DataChannelReceiveQueue::Pop, returns 0 if the queue isn't enabled.
+        int ReceiveMessages(byte* data, int size, int* sizes, int count);
+        // Returns -1 if no message is queued.
+        int GetNextMessageSize();
         void RegisterOnOpen(DelegateOnOpen callback)
         {
             onOpen = callback;
@@ -47,17 +102,56 @@ namespace WebRTC
         {
             onClose = callback;
         }
+        void RegisterOnBufferedAmountLow(DelegateOnBufferedAmountLow callback)
+        {
+            onBufferedAmountLow = callback;
+        }
         //werbrtc::DataChannelObserver
        // The data channel state have changed.
         void OnStateChange() override;
         //  A data buffer was successfully received.
         void OnMessage(const webrtc::DataBuffer& buffer) override;
+        // The data channel's buffered_amount has changed.
+        void OnBufferedAmountChange(uint64_t sentDataSize) override;
     public:
         DelegateOnMessage onMessage = nullptr;
         DelegateOnOpen onOpen = nullptr;
         DelegateOnClose onClose = nullptr;
+        DelegateOnBufferedAmountLow onBufferedAmountLow = nullptr;
     private:
+        //every send goes through here to keep track of the low threshold
+        bool SendBuffer(const webrtc::DataBuffer& buffer);
+        bool SendBinary(const byte* data, size_t size);
+        void PumpChunks();
+        void DeliverMessage(const byte* data, size_t size);
+        void CheckBufferedAmountLow();
+        static const size_t MaxPooledBuffers = 64;
+        //chunks buffered in the channel at most
+        static const size_t ChunkSendWindow = 4;
+        //returns nullptr if buffer wasn't acquired from this channel
+        std::unique_ptr<DataChannelBuffer> TakeBuffer(DataChannelBuffer* buffer);
+        void RecycleBuffer(std::unique_ptr<DataChannelBuffer> buffer);
+
         rtc::scoped_refptr<webrtc::DataChannelInterface> dataChannel;
         PeerConnectionObject& peerConnectionObj;
+
+        //never replaced once set, OnMessage reads it on the signaling thread
+        std::unique_ptr<DataChannelReceiveQueue> receiveQueueStorage;
+        std::atomic<DataChannelReceiveQueue*> receiveQueue {nullptr};
+
+        std::atomic<uint64> bufferedAmountLowThreshold {0};
+        std::atomic<uint64> bufferedAmountHighThreshold {0};
+        std::atomic<bool> aboveLowThreshold {false};
+        std::atomic<bool> bufferedAmountLow {false};
+
+        //set once, the receiver is only used on the signaling thread which calls OnMessage
+        std::atomic<bool> chunkingEnabled {false};
+        std::mutex chunkMutex;
+        std::unique_ptr<ChunkedMessageSender> chunkSender;
+        std::unique_ptr<ChunkedMessageReceiver> chunkReceiver;
+
+        std::mutex bufferMutex;
+        std::map<DataChannelBuffer*, std::unique_ptr<DataChannelBuffer>> acquiredBuffers;
+        std::vector<std::unique_ptr<DataChannelBuffer>> freeBuffers;
     };
 }
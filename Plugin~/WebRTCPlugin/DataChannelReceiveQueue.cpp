@@ -0,0 +1,133 @@
+#include "pch.h"
+#include "DataChannelReceiveQueue.h"
+
+namespace WebRTC
+{
+    DataChannelReceiveQueue::DataChannelReceiveQueue(size_t capacity) : arena(capacity)
+    {
+    }
+
+    void DataChannelReceiveQueue::Push(const byte* data, size_t size)
+    {
+        if (overflowing.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(overflowMutex);
+            //the consumer may have caught up in the meantime
+            if (overflowing.load(std::memory_order_relaxed))
+            {
+                overflow.emplace_back(data, data + size);
+                overflowCount++;
+                return;
+            }
+        }
+        if (TryWrite(data, size))
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        overflow.emplace_back(data, data + size);
+        overflowCount++;
+        overflowing.store(true, std::memory_order_release);
+    }
+
+    int DataChannelReceiveQueue::Pop(byte* data, size_t size, int* sizes, int count)
+    {
+        int popped = 0;
+        size_t offset = 0;
+        while (popped < count)
+        {
+            //read before the write position, messages pushed to the arena before the producer
+            //started to overflow are then visible, and none are pushed to it afterwards
+            const bool overflowed = overflowing.load(std::memory_order_acquire);
+            const uint64 read = readPosition.load(std::memory_order_relaxed);
+            if (read != writePosition.load(std::memory_order_acquire))
+            {
+                const uint32 messageSize = ReadHeader(read);
+                if (messageSize > size - offset)
+                {
+                    break;
+                }
+                CopyFromArena(read + HeaderSize, data + offset, messageSize);
+                readPosition.store(read + HeaderSize + messageSize, std::memory_order_release);
+                sizes[popped++] = static_cast<int>(messageSize);
+                offset += messageSize;
+                continue;
+            }
+            if (!overflowed)
+            {
+                break;
+            }
+            std::lock_guard<std::mutex> lock(overflowMutex);
+            while (popped < count && !overflow.empty() && overflow.front().size() <= size - offset)
+            {
+                const std::vector<byte>& message = overflow.front();
+                std::copy(message.begin(), message.end(), data + offset);
+                sizes[popped++] = static_cast<int>(message.size());
+                offset += message.size();
+                overflow.pop_front();
+            }
+            if (overflow.empty())
+            {
+                //the producer goes back to the arena, which is empty now
+                overflowing.store(false, std::memory_order_relaxed);
+            }
+            break;
+        }
+        return popped;
+    }
+
+    int DataChannelReceiveQueue::GetNextMessageSize()
+    {
+        const bool overflowed = overflowing.load(std::memory_order_acquire);
+        const uint64 read = readPosition.load(std::memory_order_relaxed);
+        if (read != writePosition.load(std::memory_order_acquire))
+        {
+            return static_cast<int>(ReadHeader(read));
+        }
+        if (!overflowed)
+        {
+            return -1;
+        }
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        return overflow.empty() ? -1 : static_cast<int>(overflow.front().size());
+    }
+
+    bool DataChannelReceiveQueue::TryWrite(const byte* data, size_t size)
+    {
+        const uint64 write = writePosition.load(std::memory_order_relaxed);
+        const uint64 read = readPosition.load(std::memory_order_acquire);
+        const size_t available = arena.size() - static_cast<size_t>(write - read);
+        if (size > std::numeric_limits<uint32>::max() || HeaderSize + size > available)
+        {
+            return false;
+        }
+        const uint32 header = static_cast<uint32>(size);
+        CopyToArena(write, reinterpret_cast<const byte*>(&header), HeaderSize);
+        CopyToArena(write + HeaderSize, data, size);
+        writePosition.store(write + HeaderSize + size, std::memory_order_release);
+        return true;
+    }
+
+    void DataChannelReceiveQueue::CopyToArena(uint64 position, const byte* data, size_t size)
+    {
+        const size_t index = static_cast<size_t>(position % arena.size());
+        const size_t first = std::min(size, arena.size() - index);
+        std::copy(data, data + first, arena.data() + index);
+        std::copy(data + first, data + size, arena.data());
+    }
+
+    void DataChannelReceiveQueue::CopyFromArena(uint64 position, byte* data, size_t size) const
+    {
+        const size_t index = static_cast<size_t>(position % arena.size());
+        const size_t first = std::min(size, arena.size() - index);
+        std::copy(arena.data() + index, arena.data() + index + first, data);
+        std::copy(arena.data(), arena.data() + size - first, data + first);
+    }
+
+    uint32 DataChannelReceiveQueue::ReadHeader(uint64 position) const
+    {
+        uint32 header = 0;
+        CopyFromArena(position, reinterpret_cast<byte*>(&header), HeaderSize);
+        return header;
+    }
+}
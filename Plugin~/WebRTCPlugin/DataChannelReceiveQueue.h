@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace WebRTC
+{
+    // DataChannelReceiveQueue buffers the messages of a data channel until the application drains
+    // them, so the signaling thread neither calls into managed code nor waits for it.
+    // DataChannelObserver::OnMessage runs on the signaling thread, which is the single producer
+    // and appends each message, prefixed by its size,
+    // to a preallocated byte arena without locking. The consumer drains many messages at once.
+    // Messages which don't fit into the arena go to an overflow list guarded by a mutex, and
+    // all the following ones too until the consumer has caught up, so no message is lost or
+    // reordered.
+    class DataChannelReceiveQueue
+    {
+    public:
+        explicit DataChannelReceiveQueue(size_t capacity);
+
+        // Producer side.
+        void Push(const byte* data, size_t size);
+
+        // Consumer side, copies up to count messages back to back into data and their sizes into sizes.
+        // Returns the number of messages copied, it stops at the first message which doesn't fit.
+        int Pop(byte* data, size_t size, int* sizes, int count);
+        // Consumer side, returns -1 if the queue is empty.
+        int GetNextMessageSize();
+
+        size_t GetCapacity() const { return arena.size(); }
+        // Number of messages which went to the overflow list.
+        uint64 GetOverflowCount() const { return overflowCount; }
+
+    private:
+        static const size_t HeaderSize = sizeof(uint32);
+
+        bool TryWrite(const byte* data, size_t size);
+        void CopyToArena(uint64 position, const byte* data, size_t size);
+        void CopyFromArena(uint64 position, byte* data, size_t size) const;
+        uint32 ReadHeader(uint64 position) const;
+
+        std::vector<byte> arena;
+        //monotonic positions, the index into the arena is the position modulo the capacity
+        std::atomic<uint64> writePosition {0};
+        std::atomic<uint64> readPosition {0};
+
+        //set by the producer, cleared by the consumer once it drained the overflow list
+        std::atomic<bool> overflowing {false};
+        std::mutex overflowMutex;
+        std::deque<std::vector<byte>> overflow;
+        std::atomic<uint64> overflowCount {0};
+    };
+}
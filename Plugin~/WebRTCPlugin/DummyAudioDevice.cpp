@@ -3,23 +3,66 @@
 
 namespace WebRTC
 {
-    void DummyAudioDevice::ProcessAudioData(const float* data, int32 size)
+    DummyAudioDevice::~DummyAudioDevice()
+    {
+        StopPlayout();
+    }
+
+    int32 DummyAudioDevice::StartPlayout()
+    {
+        if (!isPlayoutInitialized)
+        {
+            return -1;
+        }
+        std::lock_guard<std::mutex> lock(playoutMutex);
+        if (isPlaying)
+        {
+            return 0;
+        }
+        deviceBuffer->StartPlayout();
+        isPlaying = true;
+        playoutThread = std::thread(&DummyAudioDevice::PlayoutLoop, this);
+        return 0;
+    }
+
+    int32 DummyAudioDevice::StopPlayout()
     {
-        if (started && isRecording)
         {
-            for (int i = 0; i < size; i++)
+            std::lock_guard<std::mutex> lock(playoutMutex);
+            if (!isPlaying)
             {
-#pragma warning (suppress: 4244)
-                convertedAudioData.push_back(data[i] >= 0 ? data[i] * SHRT_MAX : data[i] * -SHRT_MIN);
+                return 0;
             }
-            //opus supports up to 48khz sample rate, enforce 48khz here for quality
-            int chunkSize = 48000 * 2 / 100;
-            while (convertedAudioData.size() > chunkSize)
+            isPlaying = false;
+        }
+        playoutCondition.notify_all();
+        playoutThread.join();
+        deviceBuffer->StopPlayout();
+        isPlayoutInitialized = false;
+        return 0;
+    }
+
+    void DummyAudioDevice::PlayoutLoop()
+    {
+        const std::chrono::milliseconds interval(10);
+        auto next = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(playoutMutex);
+        while (isPlaying)
+        {
+            lock.unlock();
+            //pull even when the application doesn't drain, so the jitter buffer keeps moving.
+            //the remote tracks hand their audio to their sinks, the mix itself isn't used
+            deviceBuffer->RequestPlayoutData(PlayoutChunkSize / PlayoutChannels);
+            lock.lock();
+
+            next += interval;
+            const auto now = std::chrono::steady_clock::now();
+            if (next < now - interval * 5)
             {
-                deviceBuffer->SetRecordedBuffer(convertedAudioData.data(), chunkSize / 2);
-                deviceBuffer->DeliverRecordedData();
-                convertedAudioData.erase(convertedAudioData.begin(), convertedAudioData.begin() + chunkSize);
+                //the thread was stalled, don't try to catch up with a burst of pulls
+                next = now;
             }
+            playoutCondition.wait_until(lock, next, [this]() { return !isPlaying; });
         }
     }
 }
@@ -1,13 +1,22 @@
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "api/task_queue/default_task_queue_factory.h"
 
 namespace WebRTC
 {
+    // Local audio doesn't go through the device, each track is fed by its AudioTrackSource,
+    // since the recorded audio of a device would be sent on every audio track.
+    // Remote audio doesn't come out of the device either, its playout thread only drives the
+    // pull of the remote streams. The mix of the device would hold the audio of every context
+    // sharing the factory, each context reads its own remote tracks through AudioPlayoutSink.
     class DummyAudioDevice : public webrtc::AudioDeviceModule
     {
     public:
-        void ProcessAudioData(const float* data, int32 size);
+        ~DummyAudioDevice();
 
         //webrtc::AudioDeviceModule
         // Retrieve the currently utilized audio layer
@@ -32,6 +41,7 @@ namespace WebRTC
         }
         virtual int32 Terminate() override
         {
+            StopPlayout();
             deviceBuffer.reset();
             started = false;
             isRecording = false;
@@ -89,11 +99,14 @@ namespace WebRTC
         }
         virtual int32 InitPlayout() override
         {
+            isPlayoutInitialized = true;
+            deviceBuffer->SetPlayoutSampleRate(PlayoutSampleRate);
+            deviceBuffer->SetPlayoutChannels(PlayoutChannels);
             return 0;
         }
         virtual bool PlayoutIsInitialized() const override
         {
-            return false;
+            return isPlayoutInitialized;
         }
         virtual int32 RecordingIsAvailable(bool* available) override
         {
@@ -102,8 +115,8 @@ namespace WebRTC
         virtual int32 InitRecording() override
         {
             isRecording = true;
-            deviceBuffer->SetRecordingSampleRate(48000);
-            deviceBuffer->SetRecordingChannels(2);
+            deviceBuffer->SetRecordingSampleRate(RecordingSampleRate);
+            deviceBuffer->SetRecordingChannels(RecordingChannels);
             return 0;
         }
         virtual bool RecordingIsInitialized() const override
@@ -112,17 +125,11 @@ namespace WebRTC
         }
 
         // Audio transport control
-        virtual int32 StartPlayout() override
-        {
-            return 0;
-        }
-        virtual int32 StopPlayout() override
-        {
-            return 0;
-        }
+        virtual int32 StartPlayout() override;
+        virtual int32 StopPlayout() override;
         virtual bool Playing() const override
         {
-            return false;
+            return isPlaying;
         }
         virtual int32 StartRecording() override
         {
@@ -230,6 +237,7 @@ namespace WebRTC
         // Stereo support
         virtual int32 StereoPlayoutIsAvailable(bool* available) const override
         {
+            *available = true;
             return 0;
         }
         virtual int32 SetStereoPlayout(bool enable) override
@@ -238,6 +246,7 @@ namespace WebRTC
         }
         virtual int32 StereoPlayout(bool* enabled) const override
         {
+            *enabled = true;
             return 0;
         }
         virtual int32 StereoRecordingIsAvailable(bool* available) const override
@@ -288,10 +297,24 @@ namespace WebRTC
         {
             return 0;
         }
+        //opus supports up to 48khz sample rate, enforce 48khz here for quality
+        static const int RecordingSampleRate = 48000;
+        static const int RecordingChannels = 2;
+        static const int PlayoutSampleRate = 48000;
+        static const int PlayoutChannels = 2;
+        static const size_t PlayoutChunkSize = PlayoutSampleRate * PlayoutChannels / 100;
     private:
+        void PlayoutLoop();
+
         std::unique_ptr<webrtc::AudioDeviceBuffer> deviceBuffer;
         std::atomic<bool> started {false};
         std::atomic<bool> isRecording {false};
-        std::vector<int16> convertedAudioData;
+
+        std::atomic<bool> isPlayoutInitialized {false};
+        std::atomic<bool> isPlaying {false};
+        //pulls remote audio every 10ms, independently of the application's audio callback
+        std::thread playoutThread;
+        std::mutex playoutMutex;
+        std::condition_variable playoutCondition;
     };
 }
@@ -1,50 +1,93 @@
 #include "pch.h"
 #include "DummyVideoEncoder.h"
 #include "NvVideoCapturer.h"
+#include "FrameTrace.h"
 
 namespace WebRTC
 {
+    DummyVideoEncoder::~DummyVideoEncoder()
+    {
+        BindCapturer(nullptr);
+    }
+
     int32_t DummyVideoEncoder::Encode(
         const webrtc::VideoFrame& frame,
         const std::vector<webrtc::VideoFrameType>* frameTypes)
     {
+        ScopedTrace trace("DummyVideoEncoder::Encode", frame.timestamp_us());
         FrameBuffer* frameBuffer = static_cast<FrameBuffer*>(frame.video_frame_buffer().get());
-        std::vector<uint8_t>& frameDataBuffer = frameBuffer->buffer;
+        BindCapturer(frameBuffer->Capturer());
+
+        bool keyFrameRequested = false;
+        if (frameTypes)
+        {
+            for (auto frameType : *frameTypes)
+            {
+                keyFrameRequested |= frameType == webrtc::VideoFrameType::kVideoFrameKey;
+            }
+        }
+
+
+        //capturer layers are aligned to the highest webrtc streams,
+        //the frame itself is the highest layer and carries the lower ones
+        const auto& lowerLayers = frameBuffer->SimulcastLayers();
+        const int layerCount = static_cast<int>(lowerLayers.size()) + 1;
+        for (int i = 0; i < layerCount; i++)
+        {
+            const int streamIndex = i + numberOfSimulcastStreams - layerCount;
+            if (streamIndex < 0)
+            {
+                continue;
+            }
+            FrameBuffer* layer = i + 1 < layerCount ? lowerLayers[i].get() : frameBuffer;
+            const int32_t result = EncodeLayer(frame, layer, streamIndex, keyFrameRequested);
+            if (result != WEBRTC_VIDEO_CODEC_OK)
+            {
+                return result;
+            }
+        }
+        return WEBRTC_VIDEO_CODEC_OK;
+    }
+
+    int32_t DummyVideoEncoder::EncodeLayer(const webrtc::VideoFrame& frame, FrameBuffer* frameBuffer, int streamIndex, bool keyFrameRequested)
+    {
+        const rtc::CopyOnWriteBuffer& frameData = frameBuffer->Data();
+        const std::vector<webrtc::H264::NaluIndex>& naluIndices = frameBuffer->NaluIndices();
 
         encodedImage._completeFrame = true;
         encodedImage.SetTimestamp(frame.timestamp());
-        encodedImage._encodedWidth = frame.video_frame_buffer()->width();
-        encodedImage._encodedHeight = frame.video_frame_buffer()->height();
+        encodedImage._encodedWidth = frameBuffer->width();
+        encodedImage._encodedHeight = frameBuffer->height();
         encodedImage.ntp_time_ms_ = frame.ntp_time_ms();
+        encodedImage.capture_time_ms_ = frame.render_time_ms();
         encodedImage.rotation_ = frame.rotation();
         encodedImage.content_type_ = webrtc::VideoContentType::UNSPECIFIED;
-        encodedImage.timing_.flags = webrtc::VideoSendTiming::kInvalid;
-        encodedImage._frameType = webrtc::VideoFrameType::kVideoFrameDelta;
-        std::vector<webrtc::H264::NaluIndex> naluIndices =
-            webrtc::H264::FindNaluIndices(&frameDataBuffer[0], frameDataBuffer.size());
-        for (uint32_t i = 0; i < naluIndices.size(); i++)
+        //the hardware encode has already happened on the render thread, report its real duration
+        encodedImage.SetEncodeTime(frameBuffer->EncodeStartMs(), frameBuffer->EncodeFinishMs());
+        encodedImage.timing_.flags = webrtc::VideoSendTiming::kNotTriggered;
+        if (capturer != nullptr)
         {
-            webrtc::H264::NaluType NALUType = webrtc::H264::ParseNaluType(frameDataBuffer[naluIndices[i].payload_start_offset]);
-            if (NALUType == webrtc::H264::kIdr)
-            {
-                encodedImage._frameType = webrtc::VideoFrameType::kVideoFrameKey;
-                break;
-            }
+            capturer->Use([this](NvVideoCapturer& source) { encodedImage.playout_delay_ = source.GetPlayoutDelay(); });
         }
-
-        if (encodedImage._frameType != webrtc::VideoFrameType::kVideoFrameKey && frameTypes && (*frameTypes)[0] == webrtc::VideoFrameType::kVideoFrameKey)
+        //RtpVideoSender picks the simulcast stream from the spatial index
+        if (numberOfSimulcastStreams > 1)
         {
-            SetKeyFrame();
+            encodedImage.SetSpatialIndex(streamIndex);
         }
+        encodedImage._frameType = frameBuffer->IsKeyFrame() ? webrtc::VideoFrameType::kVideoFrameKey : webrtc::VideoFrameType::kVideoFrameDelta;
 
-        if (lastBitrate.get_sum_kbps() > 0)
+        if (encodedImage._frameType != webrtc::VideoFrameType::kVideoFrameKey && keyFrameRequested)
         {
-            RateControlParameters param(lastBitrate, 30);
-            SetRates(param);
+            keyFramePending = true;
+        }
+        if (keyFramePending && capturer != nullptr)
+        {
+            keyFramePending = !capturer->Use([](NvVideoCapturer& source) { source.RequestKeyFrame(); });
         }
 
-        encodedImage.set_buffer(&frameDataBuffer[0], frameDataBuffer.capacity());
-        encodedImage.set_size(frameDataBuffer.size());
+        //the image only borrows the bytes of the frame, OnEncodedImage copies them before returning
+        encodedImage.set_buffer(const_cast<uint8_t*>(frameData.cdata()), frameData.size());
+        encodedImage.set_size(frameData.size());
 
         fragHeader.VerifyAndAllocateFragmentationHeader(naluIndices.size());
         fragHeader.fragmentationVectorSize = static_cast<uint16_t>(naluIndices.size());
@@ -56,10 +99,14 @@ namespace WebRTC
         }
         webrtc::CodecSpecificInfo codecInfo;
         codecInfo.codecType = webrtc::kVideoCodecH264;
-        auto result = callback->OnEncodedImage(encodedImage, &codecInfo, &fragHeader);
+        webrtc::EncodedImageCallback::Result result(webrtc::EncodedImageCallback::Result::OK);
+        {
+            ScopedTrace trace("OnEncodedImage", frame.timestamp_us());
+            result = callback->OnEncodedImage(encodedImage, &codecInfo, &fragHeader);
+        }
         if(result.error != webrtc::EncodedImageCallback::Result::OK)
         {
-            LogPrint("Encode callback failed %d", result.error);
+            DebugWarning("Encode callback failed %d", result.error);
             return WEBRTC_VIDEO_CODEC_ERROR;
         }
         return WEBRTC_VIDEO_CODEC_OK;
@@ -68,10 +115,64 @@ namespace WebRTC
     void DummyVideoEncoder::SetRates(const webrtc::VideoEncoder::RateControlParameters& parameters)
     {
         lastBitrate = parameters.bitrate;
-        SetRate(parameters.bitrate.get_sum_kbps() * 1000);
+        lastFramerate = parameters.framerate_fps;
+        hasRates = true;
+        ApplyRates();
+    }
+
+    void DummyVideoEncoder::ApplyRates()
+    {
+        if (capturer == nullptr || !hasRates)
+        {
+            return;
+        }
+        capturer->Use([this](NvVideoCapturer& source)
+        {
+            const int layerCount = source.GetSimulcastLayers();
+            if (numberOfSimulcastStreams > 1)
+            {
+                for (int i = 0; i < numberOfSimulcastStreams; i++)
+                {
+                    source.SetSubscriberRate(this, i - (numberOfSimulcastStreams - layerCount), lastBitrate.GetSpatialLayerSum(i) * 1000);
+                }
+            }
+            else
+            {
+                source.SetSubscriberRate(this, layerCount - 1, lastBitrate.get_sum_kbps() * 1000);
+            }
+            source.SetFramerate(static_cast<uint32>(lastFramerate + 0.5));
+        });
+    }
+
+    webrtc::VideoEncoder::EncoderInfo DummyVideoEncoder::GetEncoderInfo() const
+    {
+        EncoderInfo info;
+        info.implementation_name = "UnityHardwareEncoder";
+        info.is_hardware_accelerated = true;
+        info.has_internal_source = false;
+        //the frame has already been encoded, scaling it would only break the bitstream
+        info.scaling_settings = VideoEncoder::ScalingSettings::kOff;
+        return info;
+    }
+
+    //The factory can't tell which track an encoder is created for,
+    //so the encoder follows the capturer that produced the frames it receives.
+    void DummyVideoEncoder::BindCapturer(rtc::scoped_refptr<CapturerLink> videoCapturer)
+    {
+        if (capturer == videoCapturer)
+        {
+            return;
+        }
+        //leave the previous capturer's feedback so that stale rates don't hold its bitrate down
+        if (capturer != nullptr)
+        {
+            capturer->Use([this](NvVideoCapturer& source) { source.RemoveSubscriber(this); });
+        }
+        capturer = videoCapturer;
+        //what webrtc asked for before the first frame of this capturer arrived
+        ApplyRates();
     }
 
-    DummyVideoEncoderFactory::DummyVideoEncoderFactory(NvVideoCapturer* videoCapturer):capturer(videoCapturer){}
     std::vector<webrtc::SdpVideoFormat> DummyVideoEncoderFactory::GetSupportedFormats() const
     {
         const absl::optional<std::string> profileLevelId =
@@ -90,9 +191,6 @@ namespace WebRTC
     std::unique_ptr<webrtc::VideoEncoder> DummyVideoEncoderFactory::CreateVideoEncoder(
         const webrtc::SdpVideoFormat& format)
     {
-        auto dummyVideoEncoder = std::make_unique<DummyVideoEncoder>();
-        dummyVideoEncoder->SetKeyFrame.connect(capturer, &NvVideoCapturer::SetKeyFrame);
-        dummyVideoEncoder->SetRate.connect(capturer, &NvVideoCapturer::SetRate);
-        return dummyVideoEncoder;
+        return std::make_unique<DummyVideoEncoder>();
     }
 }
@@ -2,17 +2,18 @@
 
 namespace WebRTC
 {
-    class NvVideoCapturer;
+    class CapturerLink;
+    class FrameBuffer;
     class DummyVideoEncoder : public webrtc::VideoEncoder
     {
     public:
-        sigslot::signal0<> SetKeyFrame;
-        sigslot::signal1<uint32> SetRate;
+        virtual ~DummyVideoEncoder() override;
         //webrtc::VideoEncoder
         // Initialize the encoder with the information from the codecSettings
         virtual int32_t InitEncode(const webrtc::VideoCodec* codec_settings,
             int32_t number_of_cores,
             size_t max_payload_size) override {
+            numberOfSimulcastStreams = std::max<int>(codec_settings->numberOfSimulcastStreams, 1);
             return 0;
         }
         // Register an encode complete callback object.
@@ -21,7 +22,7 @@ namespace WebRTC
             return 0;
         }
         // Free encoder memory.
-        virtual int32_t Release() override { callback = nullptr; return 0; }
+        virtual int32_t Release() override { callback = nullptr; BindCapturer(nullptr); return 0; }
         // Encode an I420 image (as a part of a video stream). The encoded image
         // will be returned to the user through the encode complete callback.
         virtual int32_t Encode(
@@ -29,12 +30,24 @@ namespace WebRTC
             const std::vector<webrtc::VideoFrameType>* frame_types) override;
         // Default fallback: Just use the sum of bitrates as the single target rate.
         virtual void SetRates(const RateControlParameters& parameters) override;
+        virtual EncoderInfo GetEncoderInfo() const override;
     private:
+        int32_t EncodeLayer(const webrtc::VideoFrame& frame, FrameBuffer* frameBuffer, int streamIndex, bool keyFrameRequested);
+        void BindCapturer(rtc::scoped_refptr<CapturerLink> videoCapturer);
+        //passes the rates to the capturer, they are kept until one is bound
+        void ApplyRates();
+        //the capturer may be deleted with its track at any time, it is only reached through the link
+        rtc::scoped_refptr<CapturerLink> capturer;
+        bool hasRates = false;
+        //a key frame request which hasn't reached a capturer yet
+        bool keyFramePending = false;
         webrtc::EncodedImageCallback* callback = nullptr;
         webrtc::EncodedImage encodedImage;
         webrtc::H264BitstreamParser bitstreamParser;
         webrtc::RTPFragmentationHeader fragHeader;
         webrtc::VideoBitrateAllocation lastBitrate;
+        double lastFramerate = 0;
+        int numberOfSimulcastStreams = 1;
     };
 
     class DummyVideoEncoderFactory : public webrtc::VideoEncoderFactory
@@ -50,8 +63,5 @@ namespace WebRTC
         // Creates a VideoEncoder for the specified format.
         virtual std::unique_ptr<webrtc::VideoEncoder> CreateVideoEncoder(
             const webrtc::SdpVideoFormat& format) override;
-        DummyVideoEncoderFactory(NvVideoCapturer* videoCapturer);
-    private:
-        NvVideoCapturer* capturer;
     };
 }
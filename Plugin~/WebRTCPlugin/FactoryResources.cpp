@@ -0,0 +1,129 @@
+#include "pch.h"
+#include "FactoryResources.h"
+#include "OpusSettings.h"
+#include "DummyVideoEncoder.h"
+
+#if _WIN32
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace WebRTC
+{
+    namespace
+    {
+        //same mapping as rtc::PlatformThread, raising the priority may need privileges outside Windows
+        bool SetCurrentThreadPriority(ThreadPriority priority)
+        {
+            if (priority == ThreadPriority::Normal)
+            {
+                return true;
+            }
+#if _WIN32
+            const int value = priority == ThreadPriority::Highest ? THREAD_PRIORITY_HIGHEST : THREAD_PRIORITY_ABOVE_NORMAL;
+            return SetThreadPriority(GetCurrentThread(), value) != FALSE;
+#else
+            const int policy = SCHED_FIFO;
+            const int minPriority = sched_get_priority_min(policy);
+            const int maxPriority = sched_get_priority_max(policy);
+            if (minPriority == -1 || maxPriority == -1)
+            {
+                return false;
+            }
+            const int topPriority = maxPriority - 1;
+            sched_param param;
+            param.sched_priority = std::max(priority == ThreadPriority::Highest ? topPriority - 1 : topPriority - 2, minPriority);
+            return pthread_setschedparam(pthread_self(), policy, &param) == 0;
+#endif
+        }
+    }
+
+    std::atomic<bool> FactoryResources::s_dedicatedNetworkThread { true };
+    std::atomic<ThreadPriority> FactoryResources::s_networkThreadPriority { ThreadPriority::Normal };
+    std::mutex FactoryResources::s_sharedMutex;
+    std::map<UnityEncoderType, std::weak_ptr<FactoryResources>> FactoryResources::s_shared;
+
+    std::shared_ptr<FactoryResources> FactoryResources::Create(UnityEncoderType encoderType)
+    {
+        return std::shared_ptr<FactoryResources>(new FactoryResources(encoderType));
+    }
+
+    std::shared_ptr<FactoryResources> FactoryResources::AcquireShared(UnityEncoderType encoderType)
+    {
+        std::lock_guard<std::mutex> lock(s_sharedMutex);
+        auto resources = s_shared[encoderType].lock();
+        if (resources == nullptr)
+        {
+            //the previous instance may still be shutting down on another thread, it is not reused
+            resources = Create(encoderType);
+            s_shared[encoderType] = resources;
+            DebugLog("Created the shared peer connection factory");
+        }
+        return resources;
+    }
+
+    FactoryResources::FactoryResources(UnityEncoderType encoderType)
+    {
+        if (s_dedicatedNetworkThread)
+        {
+            networkThread.reset(new rtc::Thread(rtc::SocketServer::CreateDefault()));
+            networkThread->Start();
+            const ThreadPriority priority = s_networkThreadPriority;
+            if (!networkThread->Invoke<bool>(RTC_FROM_HERE, [priority]() { return SetCurrentThreadPriority(priority); }))
+            {
+                DebugWarning("Failed to raise the priority of the network thread");
+            }
+        }
+        workerThread.reset(new rtc::Thread(rtc::SocketServer::CreateDefault()));
+        workerThread->Start();
+        signalingThread.reset(new rtc::Thread(rtc::SocketServer::CreateDefault()));
+        signalingThread->Start();
+
+        rtc::InitializeSSL();
+
+        audioDevice = new rtc::RefCountedObject<DummyAudioDevice>();
+
+#if defined(SUPPORT_METAL) && defined(SUPPORT_SOFTWARE_ENCODER)
+        //Always use SoftwareEncoder on Mac for now.
+        std::unique_ptr<webrtc::VideoEncoderFactory> videoEncoderFactory = webrtc::CreateBuiltinVideoEncoderFactory();
+#else
+        std::unique_ptr<webrtc::VideoEncoderFactory> videoEncoderFactory =
+            encoderType == UnityEncoderType::UnityEncoderHardware ?
+            std::make_unique<DummyVideoEncoderFactory>() :
+            webrtc::CreateBuiltinVideoEncoderFactory();
+#endif
+        auto decoderFactory = std::make_unique<HardwareVideoDecoderFactory>(webrtc::CreateBuiltinVideoDecoderFactory());
+        videoDecoderFactory = decoderFactory.get();
+
+        peerConnectionFactory = webrtc::CreatePeerConnectionFactory(
+                                NetworkThread(),
+                                workerThread.get(),
+                                signalingThread.get(),
+                                audioDevice,
+                                new rtc::RefCountedObject<OpusAudioEncoderFactory>(),
+                                webrtc::CreateAudioDecoderFactory<webrtc::AudioDecoderOpus>(),
+                                std::move(videoEncoderFactory),
+                                std::move(decoderFactory),
+                                nullptr,
+                                nullptr);
+    }
+
+    FactoryResources::~FactoryResources()
+    {
+        //the factory posts its own teardown to the threads, they are stopped after it
+        peerConnectionFactory = nullptr;
+        videoDecoderFactory = nullptr;
+        audioDevice = nullptr;
+
+        workerThread->Quit();
+        workerThread.reset();
+        signalingThread->Quit();
+        signalingThread.reset();
+        if (networkThread)
+        {
+            networkThread->Quit();
+            networkThread.reset();
+        }
+    }
+}
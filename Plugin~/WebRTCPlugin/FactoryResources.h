@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "DummyAudioDevice.h"
+#include "HardwareVideoDecoderFactory.h"
+
+namespace WebRTC
+{
+    enum class ThreadPriority
+    {
+        Normal,
+        High,
+        Highest
+    };
+
+    // FactoryResources owns the threads and the PeerConnectionFactory a Context creates its objects with.
+    // A Context created with shareFactory uses the process-wide instance of its encoder type,
+    // which is created by the first of these contexts and destroyed with the last one.
+    // Contexts sharing it also share the audio device, which pulls the remote audio of all of them,
+    // each context reads the remote audio tracks of its own peer connections.
+    class FactoryResources
+    {
+    public:
+        static std::shared_ptr<FactoryResources> Create(UnityEncoderType encoderType);
+        static std::shared_ptr<FactoryResources> AcquireShared(UnityEncoderType encoderType);
+        ~FactoryResources();
+
+        //socket I/O, DTLS/SRTP and SCTP run on their own thread unless disabled,
+        //these apply to the resources created afterwards
+        static void SetDedicatedNetworkThread(bool dedicated) { s_dedicatedNetworkThread = dedicated; }
+        static void SetNetworkThreadPriority(ThreadPriority priority) { s_networkThreadPriority = priority; }
+
+        rtc::Thread* NetworkThread() const { return networkThread ? networkThread.get() : workerThread.get(); }
+        rtc::Thread* WorkerThread() const { return workerThread.get(); }
+        rtc::Thread* SignalingThread() const { return signalingThread.get(); }
+        webrtc::PeerConnectionFactoryInterface* Factory() const { return peerConnectionFactory.get(); }
+        HardwareVideoDecoderFactory* VideoDecoderFactory() const { return videoDecoderFactory; }
+        DummyAudioDevice* AudioDevice() const { return audioDevice.get(); }
+
+    private:
+        explicit FactoryResources(UnityEncoderType encoderType);
+
+        //null when the worker thread also does the network work
+        std::unique_ptr<rtc::Thread> networkThread;
+        std::unique_ptr<rtc::Thread> workerThread;
+        std::unique_ptr<rtc::Thread> signalingThread;
+        rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> peerConnectionFactory;
+        //owned by the peer connection factory
+        HardwareVideoDecoderFactory* videoDecoderFactory = nullptr;
+        rtc::scoped_refptr<DummyAudioDevice> audioDevice;
+
+        static std::atomic<bool> s_dedicatedNetworkThread;
+        static std::atomic<ThreadPriority> s_networkThreadPriority;
+        static std::mutex s_sharedMutex;
+        //not owning, the contexts using an instance keep it alive
+        static std::map<UnityEncoderType, std::weak_ptr<FactoryResources>> s_shared;
+    };
+}
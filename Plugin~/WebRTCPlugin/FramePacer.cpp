@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "FramePacer.h"
+
+namespace WebRTC
+{
+    FramePacer::FramePacer(int maxFramerate) : maxFramerate(maxFramerate)
+    {
+    }
+
+    int FramePacer::GetTargetFramerate() const
+    {
+        //a non positive value means the source doesn't constrain the frame rate
+        int target = std::numeric_limits<int>::max();
+        for (const int fps : { maxFramerate.load(), encoderFramerate.load(), sinkFramerate.load() })
+        {
+            if (fps > 0)
+            {
+                target = std::min(target, fps);
+            }
+        }
+        return target;
+    }
+
+    //Same scheme as cricket::VideoAdapter: frames are kept on a fixed grid so the
+    //output interval stays even regardless of the jitter of the render events.
+    bool FramePacer::ShouldEncodeFrame(int64 timestampUs)
+    {
+        const int targetFramerate = GetTargetFramerate();
+        if (targetFramerate == std::numeric_limits<int>::max())
+        {
+            return true;
+        }
+        const int64 frameIntervalUs = rtc::kNumMicrosecsPerSec / targetFramerate;
+        if (nextFrameTimestampUs)
+        {
+            const int64 timeUntilNextFrameUs = *nextFrameTimestampUs - timestampUs;
+            //continue if the timestamp is within the expected range
+            if (std::abs(timeUntilNextFrameUs) < 2 * frameIntervalUs)
+            {
+                //drop if a frame shouldn't be encoded yet
+                if (timeUntilNextFrameUs > 0)
+                {
+                    droppedFrameCount++;
+                    return false;
+                }
+                *nextFrameTimestampUs += frameIntervalUs;
+                return true;
+            }
+        }
+        //first frame or the timestamp is way outside the expected range, so reset
+        nextFrameTimestampUs = timestampUs + frameIntervalUs / 2;
+        return true;
+    }
+}
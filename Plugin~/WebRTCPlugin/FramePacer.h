@@ -0,0 +1,33 @@
+#pragma once
+
+namespace WebRTC
+{
+    // FramePacer decides which render events turn into encoded frames, so that the
+    // encode rate follows what WebRTC asks for instead of Unity's frame rate.
+    // The target is the lowest of the configured maximum, the frame rate reported
+    // by the encoder and the frame rate wanted by the sinks.
+    // The setters may be called from any thread, ShouldEncodeFrame must be called
+    // on the rendering thread only.
+    class FramePacer
+    {
+    public:
+        explicit FramePacer(int maxFramerate);
+
+        void SetMaxFramerate(int fps) { maxFramerate = fps; }
+        void SetEncoderFramerate(int fps) { encoderFramerate = fps; }
+        void SetSinkFramerate(int fps) { sinkFramerate = fps; }
+        int GetTargetFramerate() const;
+
+        // Returns false if the frame captured at timestampUs is surplus and should
+        // be dropped before copying and encoding it.
+        bool ShouldEncodeFrame(int64 timestampUs);
+        uint64 GetDroppedFrameCount() const { return droppedFrameCount; }
+
+    private:
+        std::atomic<int> maxFramerate;
+        std::atomic<int> encoderFramerate { 0 };
+        std::atomic<int> sinkFramerate { 0 };
+        absl::optional<int64> nextFrameTimestampUs;
+        uint64 droppedFrameCount = 0;
+    };
+}
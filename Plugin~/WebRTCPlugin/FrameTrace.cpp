@@ -0,0 +1,131 @@
+#include "pch.h"
+#include "FrameTrace.h"
+
+namespace WebRTC
+{
+    const size_t FrameTrace::EventsPerThread;
+    std::atomic<bool> FrameTrace::s_enabled { false };
+    std::mutex FrameTrace::s_mutex;
+    std::vector<std::unique_ptr<FrameTrace::ThreadBuffer>> FrameTrace::s_buffers;
+    uint32 FrameTrace::s_nextThreadId = 1;
+    thread_local FrameTrace::ThreadBufferHolder FrameTrace::s_threadBuffer;
+
+    FrameTrace::ThreadBufferHolder::~ThreadBufferHolder()
+    {
+        if (buffer == nullptr)
+        {
+            return;
+        }
+        //the events stay readable until another thread overwrites them
+        std::lock_guard<std::mutex> lock(s_mutex);
+        buffer->inUse = false;
+    }
+
+    FrameTrace::ThreadBuffer* FrameTrace::AcquireThreadBuffer()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        for (auto& buffer : s_buffers)
+        {
+            if (!buffer->inUse)
+            {
+                buffer->inUse = true;
+                buffer->threadId = s_nextThreadId++;
+                return buffer.get();
+            }
+        }
+        s_buffers.push_back(std::make_unique<ThreadBuffer>());
+        ThreadBuffer* buffer = s_buffers.back().get();
+        buffer->inUse = true;
+        buffer->threadId = s_nextThreadId++;
+        return buffer;
+    }
+
+    void FrameTrace::Record(const char* name, int64 beginUs, int64 endUs, int64 frameUs)
+    {
+        ThreadBuffer*& buffer = s_threadBuffer.buffer;
+        if (buffer == nullptr)
+        {
+            buffer = AcquireThreadBuffer();
+        }
+        const uint64 index = buffer->written.load(std::memory_order_relaxed);
+        Event& event = buffer->events[index % EventsPerThread];
+        buffer->started.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        event.name.store(name, std::memory_order_relaxed);
+        event.beginUs.store(beginUs, std::memory_order_relaxed);
+        event.durationUs.store(endUs - beginUs, std::memory_order_relaxed);
+        event.frameUs.store(frameUs, std::memory_order_relaxed);
+        event.threadId.store(buffer->threadId, std::memory_order_relaxed);
+        buffer->written.store(index + 1, std::memory_order_release);
+    }
+
+    void FrameTrace::Dump(int64 windowUs, std::string& json)
+    {
+        struct Copy
+        {
+            const char* name;
+            int64 beginUs;
+            int64 durationUs;
+            int64 frameUs;
+            uint32 threadId;
+        };
+        const int64 sinceUs = rtc::TimeMicros() - windowUs;
+        std::vector<Copy> copies;
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            for (auto& buffer : s_buffers)
+            {
+                const uint64 written = buffer->written.load(std::memory_order_acquire);
+                const uint64 first = written > EventsPerThread ? written - EventsPerThread : 0;
+                const size_t offset = copies.size();
+                for (uint64 i = first; i < written; i++)
+                {
+                    const Event& event = buffer->events[i % EventsPerThread];
+                    copies.push_back({ event.name.load(std::memory_order_relaxed), event.beginUs.load(std::memory_order_relaxed),
+                        event.durationUs.load(std::memory_order_relaxed), event.frameUs.load(std::memory_order_relaxed),
+                        event.threadId.load(std::memory_order_relaxed) });
+                }
+                //the owning thread keeps writing, drop the events it may have overwritten while they were copied
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const uint64 started = buffer->started.load(std::memory_order_relaxed);
+                const uint64 firstValid = started > EventsPerThread ? started - EventsPerThread : 0;
+                if (firstValid > first)
+                {
+                    const size_t overwritten = static_cast<size_t>(std::min(firstValid - first, written - first));
+                    copies.erase(copies.begin() + offset, copies.begin() + offset + overwritten);
+                }
+            }
+        }
+
+        json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        char line[256];
+        bool first = true;
+        for (const Copy& copy : copies)
+        {
+            if (copy.name == nullptr || copy.beginUs < sinceUs)
+            {
+                continue;
+            }
+            snprintf(line, sizeof(line),
+                "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lld,\"dur\":%lld,\"args\":{\"frameUs\":%lld}}",
+                first ? "" : ",", copy.name, copy.threadId,
+                static_cast<long long>(copy.beginUs), static_cast<long long>(copy.durationUs), static_cast<long long>(copy.frameUs));
+            json += line;
+            first = false;
+        }
+        json += "]}";
+    }
+
+    void FrameTrace::Clear()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        for (auto& buffer : s_buffers)
+        {
+            //only the owning thread writes the counter, a cleared buffer is detected by its empty names
+            for (Event& event : buffer->events)
+            {
+                event.name.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    }
+}
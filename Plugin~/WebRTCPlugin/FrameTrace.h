@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace WebRTC
+{
+    // FrameTrace records timed events of the video pipeline into a ring buffer per thread,
+    // and dumps a window of them as Chrome trace JSON (chrome://tracing, Perfetto).
+    // Recording is off by default, a disabled ScopedTrace only loads one flag.
+    class FrameTrace
+    {
+    public:
+        static const size_t EventsPerThread = 4096;
+
+        static void SetEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+        static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+        // name has to be a string literal, only the pointer is stored.
+        // frameUs is the capture time of the frame the event belongs to, 0 if unknown.
+        static void Record(const char* name, int64 beginUs, int64 endUs, int64 frameUs);
+
+        // Writes the events that began during the last windowUs microseconds.
+        static void Dump(int64 windowUs, std::string& json);
+        // Drops the recorded events of every thread.
+        static void Clear();
+
+    private:
+        struct Event
+        {
+            std::atomic<const char*> name { nullptr };
+            std::atomic<int64> beginUs { 0 };
+            std::atomic<int64> durationUs { 0 };
+            std::atomic<int64> frameUs { 0 };
+            std::atomic<uint32> threadId { 0 };
+        };
+
+        // Written by the thread owning it, read by Dump from any thread.
+        // A buffer is handed over to a new thread once its thread exits.
+        struct ThreadBuffer
+        {
+            Event events[EventsPerThread];
+            //number of events ever written, the writer publishes an event by incrementing it
+            std::atomic<uint64> written { 0 };
+            //incremented before an event is written, a reader discards what may have been overwritten meanwhile
+            std::atomic<uint64> started { 0 };
+            uint32 threadId = 0;
+            bool inUse = false;
+        };
+
+        // Gives the buffer back to the registry when its thread exits.
+        struct ThreadBufferHolder
+        {
+            ~ThreadBufferHolder();
+            ThreadBuffer* buffer = nullptr;
+        };
+
+        static ThreadBuffer* AcquireThreadBuffer();
+
+        static std::atomic<bool> s_enabled;
+        static std::mutex s_mutex;
+        static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+        static uint32 s_nextThreadId;
+        static thread_local ThreadBufferHolder s_threadBuffer;
+    };
+
+    // Records the lifetime of the object as one event.
+    class ScopedTrace
+    {
+    public:
+        explicit ScopedTrace(const char* name, int64 frameUs = 0)
+            : name(name), frameUs(frameUs), beginUs(FrameTrace::IsEnabled() ? rtc::TimeMicros() : 0)
+        {
+        }
+        ~ScopedTrace()
+        {
+            if (beginUs != 0)
+            {
+                FrameTrace::Record(name, beginUs, rtc::TimeMicros(), frameUs);
+            }
+        }
+        ScopedTrace(const ScopedTrace&) = delete;
+        ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+    private:
+        const char* name;
+        int64 frameUs;
+        int64 beginUs;
+    };
+}
@@ -13,6 +13,7 @@ D3D11GraphicsDevice::D3D11GraphicsDevice(ID3D11Device* nativeDevice) : m_d3d11De
 
 //---------------------------------------------------------------------------------------------------------------------
 D3D11GraphicsDevice::~D3D11GraphicsDevice() {
+    ReleaseVideoProcessors();
     SAFE_RELEASE(m_d3d11Context);
 }
 
@@ -24,6 +25,7 @@ bool D3D11GraphicsDevice::InitV() {
 //---------------------------------------------------------------------------------------------------------------------
 
 void D3D11GraphicsDevice::ShutdownV() {
+    ReleaseVideoProcessors();
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -38,7 +40,8 @@ ITexture2D* D3D11GraphicsDevice::CreateDefaultTextureV(uint32_t w, uint32_t h) {
     desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
     desc.SampleDesc.Count = 1;
     desc.Usage = D3D11_USAGE_DEFAULT;
-    desc.BindFlags = 0;
+    //render target is required to be the output of the video processor
+    desc.BindFlags = D3D11_BIND_RENDER_TARGET;
     desc.CPUAccessFlags = 0;
     HRESULT r = m_d3d11Device->CreateTexture2D(&desc, NULL, &texture);
     return new D3D11Texture2D(w,h,texture);
@@ -87,6 +90,109 @@ bool D3D11GraphicsDevice::CopyResourceFromNativeV(ITexture2D* dest, void* native
     return true;
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+bool D3D11GraphicsDevice::ScaleResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) {
+    ID3D11Texture2D* nativeDest = reinterpret_cast<ID3D11Texture2D*>(dest->GetNativeTexturePtrV());
+    ID3D11Texture2D* nativeSrc = reinterpret_cast<ID3D11Texture2D*>(nativeTexturePtr);
+    if (nativeSrc == nativeDest)
+        return false;
+    if (nativeSrc == nullptr || nativeDest == nullptr)
+        return false;
+
+    D3D11_TEXTURE2D_DESC srcDesc;
+    nativeSrc->GetDesc(&srcDesc);
+    if (dest->IsSize(srcDesc.Width, srcDesc.Height)) {
+        m_d3d11Context->CopyResource(nativeDest, nativeSrc);
+        return true;
+    }
+
+    VideoProcessor* videoProcessor = GetVideoProcessor(srcDesc.Width, srcDesc.Height, dest->GetWidth(), dest->GetHeight());
+    if (nullptr == videoProcessor)
+        return false;
+
+    ID3D11VideoProcessorInputView* inputView = nullptr;
+    D3D11_VIDEO_PROCESSOR_INPUT_VIEW_DESC inputViewDesc = {};
+    inputViewDesc.ViewDimension = D3D11_VPIV_DIMENSION_TEXTURE2D;
+    HRESULT hr = m_videoDevice->CreateVideoProcessorInputView(nativeSrc, videoProcessor->enumerator, &inputViewDesc, &inputView);
+    if (hr != S_OK) {
+        LogPrint("CreateVideoProcessorInputView failed %x", hr);
+        return false;
+    }
+
+    ID3D11VideoProcessorOutputView* outputView = nullptr;
+    D3D11_VIDEO_PROCESSOR_OUTPUT_VIEW_DESC outputViewDesc = {};
+    outputViewDesc.ViewDimension = D3D11_VPOV_DIMENSION_TEXTURE2D;
+    hr = m_videoDevice->CreateVideoProcessorOutputView(nativeDest, videoProcessor->enumerator, &outputViewDesc, &outputView);
+    if (hr != S_OK) {
+        LogPrint("CreateVideoProcessorOutputView failed %x", hr);
+        SAFE_RELEASE(inputView);
+        return false;
+    }
+
+    D3D11_VIDEO_PROCESSOR_STREAM stream = {};
+    stream.Enable = TRUE;
+    stream.pInputSurface = inputView;
+    hr = m_videoContext->VideoProcessorBlt(videoProcessor->processor, outputView, 0, 1, &stream);
+
+    SAFE_RELEASE(outputView);
+    SAFE_RELEASE(inputView);
+    return hr == S_OK;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+D3D11GraphicsDevice::VideoProcessor* D3D11GraphicsDevice::GetVideoProcessor(
+    uint32_t srcWidth, uint32_t srcHeight, uint32_t destWidth, uint32_t destHeight) {
+
+    const VideoProcessorKey key(srcWidth, srcHeight, destWidth, destHeight);
+    auto it = m_videoProcessors.find(key);
+    if (it != m_videoProcessors.end())
+        return &it->second;
+
+    if (nullptr == m_videoDevice) {
+        if (m_d3d11Device->QueryInterface(__uuidof(ID3D11VideoDevice), reinterpret_cast<void**>(&m_videoDevice)) != S_OK
+            || m_d3d11Context->QueryInterface(__uuidof(ID3D11VideoContext), reinterpret_cast<void**>(&m_videoContext)) != S_OK) {
+            LogPrint("D3D11 video processing is not supported on this device");
+            SAFE_RELEASE(m_videoDevice);
+            SAFE_RELEASE(m_videoContext);
+            return nullptr;
+        }
+    }
+
+    D3D11_VIDEO_PROCESSOR_CONTENT_DESC contentDesc = {};
+    contentDesc.InputFrameFormat = D3D11_VIDEO_FRAME_FORMAT_PROGRESSIVE;
+    contentDesc.InputWidth = srcWidth;
+    contentDesc.InputHeight = srcHeight;
+    contentDesc.OutputWidth = destWidth;
+    contentDesc.OutputHeight = destHeight;
+    contentDesc.Usage = D3D11_VIDEO_USAGE_PLAYBACK_NORMAL;
+
+    VideoProcessor videoProcessor = { nullptr, nullptr };
+    if (m_videoDevice->CreateVideoProcessorEnumerator(&contentDesc, &videoProcessor.enumerator) != S_OK) {
+        LogPrint("CreateVideoProcessorEnumerator failed");
+        return nullptr;
+    }
+    if (m_videoDevice->CreateVideoProcessor(videoProcessor.enumerator, 0, &videoProcessor.processor) != S_OK) {
+        LogPrint("CreateVideoProcessor failed");
+        SAFE_RELEASE(videoProcessor.enumerator);
+        return nullptr;
+    }
+    //RGB in, RGB out, nothing but the scaling should happen
+    m_videoContext->VideoProcessorSetStreamFrameFormat(videoProcessor.processor, 0, D3D11_VIDEO_FRAME_FORMAT_PROGRESSIVE);
+    m_videoContext->VideoProcessorSetStreamAutoProcessingMode(videoProcessor.processor, 0, FALSE);
+    return &(m_videoProcessors[key] = videoProcessor);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+void D3D11GraphicsDevice::ReleaseVideoProcessors() {
+    for (auto& pair : m_videoProcessors) {
+        SAFE_RELEASE(pair.second.processor);
+        SAFE_RELEASE(pair.second.enumerator);
+    }
+    m_videoProcessors.clear();
+    SAFE_RELEASE(m_videoContext);
+    SAFE_RELEASE(m_videoDevice);
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 
 rtc::scoped_refptr<webrtc::I420Buffer> D3D11GraphicsDevice::ConvertRGBToI420(ITexture2D* tex) {
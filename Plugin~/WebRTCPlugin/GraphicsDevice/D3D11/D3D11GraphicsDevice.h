@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <tuple>
 #include "GraphicsDevice/IGraphicsDevice.h"
 #include "WebRTCConstants.h"
 
@@ -17,12 +18,27 @@ public:
     virtual ITexture2D* CreateCPUReadTextureV(uint32_t w, uint32_t h) override;
     virtual bool CopyResourceV(ITexture2D* dest, ITexture2D* src) override;
     virtual bool CopyResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) override;
+    virtual bool ScaleResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) override;
     inline virtual GraphicsDeviceType GetDeviceType() const override;
     virtual rtc::scoped_refptr<webrtc::I420Buffer> ConvertRGBToI420(ITexture2D* tex) override;
 
 private:
+    struct VideoProcessor {
+        ID3D11VideoProcessorEnumerator* enumerator;
+        ID3D11VideoProcessor* processor;
+    };
+    //src width, src height, dest width, dest height
+    using VideoProcessorKey = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>;
+
+    VideoProcessor* GetVideoProcessor(uint32_t srcWidth, uint32_t srcHeight, uint32_t destWidth, uint32_t destHeight);
+    void ReleaseVideoProcessors();
+
     ID3D11Device* m_d3d11Device;
     ID3D11DeviceContext* m_d3d11Context; 
+    //the video processor does the scaling for simulcast layers, created lazily
+    ID3D11VideoDevice* m_videoDevice = nullptr;
+    ID3D11VideoContext* m_videoContext = nullptr;
+    std::map<VideoProcessorKey, VideoProcessor> m_videoProcessors;
 };
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -126,6 +126,19 @@ bool D3D12GraphicsDevice::CopyResourceFromNativeV(ITexture2D* baseDest, void* na
     return true;
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+bool D3D12GraphicsDevice::ScaleResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) {
+    //Only same size copies, SupportsScaling() keeps the encoders from asking for more.
+    ID3D12Resource* nativeSrc = reinterpret_cast<ID3D12Resource*>(nativeTexturePtr);
+    if (nullptr == nativeSrc)
+        return false;
+    const D3D12_RESOURCE_DESC srcDesc = nativeSrc->GetDesc();
+    if (dest->IsSize(static_cast<uint32_t>(srcDesc.Width), srcDesc.Height))
+        return CopyResourceFromNativeV(dest, nativeTexturePtr);
+    LogPrint("ScaleResourceFromNativeV is not supported on D3D12");
+    return false;
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 
 D3D12Texture2D* D3D12GraphicsDevice::CreateSharedD3D12Texture(uint32_t w, uint32_t h) {
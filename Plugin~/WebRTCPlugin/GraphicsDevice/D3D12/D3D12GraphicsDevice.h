@@ -21,6 +21,9 @@ public:
     virtual ITexture2D* CreateDefaultTextureV(uint32_t w, uint32_t h) override;
     virtual bool CopyResourceV(ITexture2D* dest, ITexture2D* src) override;
     virtual bool CopyResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) override;
+    virtual bool ScaleResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) override;
+    //D3D12 has no fixed function scaler
+    virtual bool SupportsScaling() const override { return false; }
     inline virtual GraphicsDeviceType GetDeviceType() const override;
 
     virtual ITexture2D* CreateCPUReadTextureV(uint32_t w, uint32_t h) override;
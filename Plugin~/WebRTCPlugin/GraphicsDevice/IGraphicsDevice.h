@@ -17,6 +17,11 @@ public:
     virtual void* GetEncodeDevicePtrV() = 0;
     virtual bool CopyResourceV(ITexture2D* dest, ITexture2D* src) = 0;
     virtual bool CopyResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) = 0;
+    //Copies the native texture into dest, resizing it to the size of dest on the GPU.
+    //Returns false when the device can't scale textures.
+    virtual bool ScaleResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) = 0;
+    //false if ScaleResourceFromNativeV only copies textures of the same size, simulcast needs scaling
+    virtual bool SupportsScaling() const { return true; }
     virtual GraphicsDeviceType GetDeviceType() const = 0;
 
     //Required for software encoding
@@ -19,6 +19,8 @@ namespace WebRTC {
         virtual ITexture2D* CreateCPUReadTextureV(uint32_t width, uint32_t height) override;
         virtual bool CopyResourceV(ITexture2D* dest, ITexture2D* src) override;
         virtual bool CopyResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) override;
+        virtual bool ScaleResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) override;
+        virtual bool SupportsScaling() const override { return false; }
         inline virtual GraphicsDeviceType GetDeviceType() const override;
         virtual rtc::scoped_refptr<webrtc::I420Buffer> ConvertRGBToI420(ITexture2D* tex) override;
 
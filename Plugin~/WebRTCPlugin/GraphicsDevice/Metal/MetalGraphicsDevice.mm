@@ -61,6 +61,21 @@ namespace WebRTC {
         return CopyTexture(dstTexture, srcTexture);
     }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+    bool MetalGraphicsDevice::ScaleResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) {
+        if(nativeTexturePtr == nullptr) {
+            return false;
+        }
+        id<MTLTexture> srcTexture = (__bridge id<MTLTexture>)nativeTexturePtr;
+        if(dest->IsSize(static_cast<uint32_t>(srcTexture.width), static_cast<uint32_t>(srcTexture.height))) {
+            return CopyResourceFromNativeV(dest, nativeTexturePtr);
+        }
+        //Only same size copies, SupportsScaling() keeps the encoders from asking for more.
+        LogPrint("ScaleResourceFromNativeV is not supported on Metal");
+        return false;
+    }
+
 //---------------------------------------------------------------------------------------------------------------------
 
     bool MetalGraphicsDevice::CopyTexture(id<MTLTexture> dest, id<MTLTexture> src)
@@ -28,7 +28,11 @@ bool OpenGLGraphicsDevice::InitV() {
 //---------------------------------------------------------------------------------------------------------------------
 
 void OpenGLGraphicsDevice::ShutdownV() {
-
+    if (m_scaleFramebuffers[0] != 0)
+    {
+        glDeleteFramebuffers(2, m_scaleFramebuffers);
+        m_scaleFramebuffers[0] = m_scaleFramebuffers[1] = 0;
+    }
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -73,6 +77,57 @@ bool OpenGLGraphicsDevice::CopyResourceFromNativeV(ITexture2D* dest, void* nativ
     return CopyResource(dstName, srcName, width, height);
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+bool OpenGLGraphicsDevice::ScaleResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) {
+    auto nativeDest = reinterpret_cast<GLuint*>(dest->GetNativeTexturePtrV());
+    GLuint srcName = (GLuint)(size_t)(nativeTexturePtr);
+    GLuint dstName = *nativeDest;
+    if(srcName == dstName || glIsTexture(srcName) == GL_FALSE || glIsTexture(dstName) == GL_FALSE)
+    {
+        LogPrint("Invalid textures to scale");
+        return false;
+    }
+
+    GLint srcWidth = 0;
+    GLint srcHeight = 0;
+    GLint boundTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+    glBindTexture(GL_TEXTURE_2D, srcName);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &srcWidth);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &srcHeight);
+    glBindTexture(GL_TEXTURE_2D, boundTexture);
+
+    const auto width = dest->GetWidth();
+    const auto height = dest->GetHeight();
+    if(dest->IsSize(srcWidth, srcHeight))
+    {
+        return CopyResource(dstName, srcName, width, height);
+    }
+
+    if(m_scaleFramebuffers[0] == 0)
+    {
+        glGenFramebuffers(2, m_scaleFramebuffers);
+    }
+    //restore Unity's framebuffers after the blit
+    GLint readFramebuffer = 0;
+    GLint drawFramebuffer = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_scaleFramebuffers[0]);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, srcName, 0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_scaleFramebuffers[1]);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dstName, 0);
+    glBlitFramebuffer(
+            0, 0, srcWidth, srcHeight,
+            0, 0, width, height,
+            GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+    return true;
+}
+
 bool OpenGLGraphicsDevice::CopyResource(GLuint dstName, GLuint srcName, uint32 width, uint32 height) {
     if(srcName == dstName)
     {
@@ -20,10 +20,13 @@ public:
     virtual bool CopyResourceV(ITexture2D* dest, ITexture2D* src);
     virtual rtc::scoped_refptr<webrtc::I420Buffer> ConvertRGBToI420(ITexture2D* tex);
     virtual bool CopyResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr);
+    virtual bool ScaleResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr);
     inline virtual GraphicsDeviceType GetDeviceType() const;
 
 private:
     bool CopyResource(GLuint dstName, GLuint srcName, uint32 width, uint32 height);
+    //read and draw framebuffers used to blit simulcast layers, created lazily
+    GLuint m_scaleFramebuffers[2] = { 0, 0 };
 };
 
 void* OpenGLGraphicsDevice::GetEncodeDevicePtrV() { return nullptr; }
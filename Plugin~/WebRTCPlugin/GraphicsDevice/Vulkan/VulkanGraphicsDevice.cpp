@@ -168,6 +168,36 @@ bool VulkanGraphicsDevice::CopyResourceFromNativeV(ITexture2D* dest, void* nativ
     return true;
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+bool VulkanGraphicsDevice::ScaleResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) {
+    if (nullptr == dest || nullptr == nativeTexturePtr)
+        return false;
+
+    VulkanTexture2D* destTexture = reinterpret_cast<VulkanTexture2D*>(dest);
+    UnityVulkanImage unityVulkanImage;
+    VkImageSubresource subResource { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0 };
+
+    if (!m_unityVulkan->AccessTexture(nativeTexturePtr, &subResource, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, kUnityVulkanResourceAccess_PipelineBarrier,
+        &unityVulkanImage))
+    {
+        return false;
+    }
+
+    if (destTexture->GetImage() == unityVulkanImage.image)
+        return false;
+
+    //The layouts of All VulkanTexture2D should be VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, so no transition for destTex
+    VULKAN_CHECK_FAILVALUE(
+        VulkanUtility::BlitImage(m_device, m_commandPool, m_graphicsQueue,
+            unityVulkanImage.image, unityVulkanImage.extent.width, unityVulkanImage.extent.height,
+            destTexture->GetImage(), destTexture->GetWidth(), destTexture->GetHeight()),
+        false
+    );
+
+    return true;
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 VkResult VulkanGraphicsDevice::CreateCommandPool() {
     VkCommandPoolCreateInfo poolInfo = {};
@@ -379,5 +379,27 @@ VkResult VulkanUtility::CopyImage(const VkDevice device, const VkCommandPool com
     return EndAndSubmitOneTimeCommandBuffer(device,commandPool,queue,commandBuffer);
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+
+VkResult VulkanUtility::BlitImage(const VkDevice device, const VkCommandPool commandPool, const VkQueue queue,
+               const VkImage srcImage, const uint32_t srcWidth, const uint32_t srcHeight,
+               const VkImage dstImage, const uint32_t dstWidth, const uint32_t dstHeight)
+{
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VULKAN_CHECK(BeginOneTimeCommandBufferInto(device, commandPool, &commandBuffer));
+
+    VkImageBlit blitRegion{};
+    blitRegion.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    blitRegion.srcOffsets[0] = { 0, 0, 0 };
+    blitRegion.srcOffsets[1] = { static_cast<int32_t>(srcWidth), static_cast<int32_t>(srcHeight), 1 };
+    blitRegion.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    blitRegion.dstOffsets[0] = { 0, 0, 0 };
+    blitRegion.dstOffsets[1] = { static_cast<int32_t>(dstWidth), static_cast<int32_t>(dstHeight), 1 };
+    vkCmdBlitImage(commandBuffer, srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dstImage,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blitRegion, VK_FILTER_LINEAR);
+
+    return EndAndSubmitOneTimeCommandBuffer(device,commandPool,queue,commandBuffer);
+}
+
 
 } //end namespace
@@ -43,6 +43,11 @@ public:
                const VkImage srcImage, const VkImage dstImage,
                const uint32_t width, const uint32_t height);
 
+    //Same as CopyImage, but scales srcImage to the size of dstImage with linear filtering.
+    static VkResult BlitImage(const VkDevice device, const VkCommandPool commandPool, const VkQueue queue,
+               const VkImage srcImage, const uint32_t srcWidth, const uint32_t srcHeight,
+               const VkImage dstImage, const uint32_t dstWidth, const uint32_t dstHeight);
+
 };
 } //end namespace
 
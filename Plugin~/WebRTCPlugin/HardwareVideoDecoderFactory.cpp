@@ -0,0 +1,183 @@
+#include "pch.h"
+#include <array>
+#include "HardwareVideoDecoderFactory.h"
+#include "api/video_codecs/video_decoder_software_fallback_wrapper.h"
+
+namespace WebRTC
+{
+    void VideoDecoderStatsCollector::OnFrameDecoded(int64 decodeTimeUs, bool hardware)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.decodedFrames++;
+        if (hardware)
+        {
+            stats.hardwareDecodedFrames++;
+        }
+        stats.totalDecodeTimeUs += decodeTimeUs;
+        stats.maxDecodeTimeUs = std::max(stats.maxDecodeTimeUs, decodeTimeUs);
+    }
+
+    void VideoDecoderStatsCollector::OnFallback()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.fallbackCount++;
+    }
+
+    VideoDecoderStats VideoDecoderStatsCollector::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+    namespace
+    {
+        //Measures the time from Decode() until the frame comes out of the decoder,
+        //which also works for hardware decoders delivering their frames asynchronously.
+        class StatsVideoDecoder : public webrtc::VideoDecoder, public webrtc::DecodedImageCallback
+        {
+        public:
+            StatsVideoDecoder(std::unique_ptr<webrtc::VideoDecoder> decoder, std::string hardwareName, std::shared_ptr<VideoDecoderStatsCollector> stats)
+                : decoder(std::move(decoder)), hardwareName(std::move(hardwareName)), stats(std::move(stats))
+            {
+                usingHardware = !this->hardwareName.empty();
+            }
+
+            //webrtc::VideoDecoder
+            int32_t InitDecode(const webrtc::VideoCodec* codecSettings, int32_t numberOfCores) override
+            {
+                const int32_t result = decoder->InitDecode(codecSettings, numberOfCores);
+                CheckFallback();
+                return result;
+            }
+            int32_t Decode(const webrtc::EncodedImage& inputImage, bool missingFrames, int64_t renderTimeMs) override
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    pendingFrames[nextPendingFrame] = { inputImage.Timestamp(), rtc::TimeMicros() };
+                    nextPendingFrame = (nextPendingFrame + 1) % pendingFrames.size();
+                }
+                const int32_t result = decoder->Decode(inputImage, missingFrames, renderTimeMs);
+                CheckFallback();
+                return result;
+            }
+            int32_t RegisterDecodeCompleteCallback(webrtc::DecodedImageCallback* decodeCompleteCallback) override
+            {
+                callback = decodeCompleteCallback;
+                return decoder->RegisterDecodeCompleteCallback(decodeCompleteCallback == nullptr ? nullptr : this);
+            }
+            int32_t Release() override { return decoder->Release(); }
+            bool PrefersLateDecoding() const override { return decoder->PrefersLateDecoding(); }
+            const char* ImplementationName() const override { return decoder->ImplementationName(); }
+
+            //webrtc::DecodedImageCallback
+            int32_t Decoded(webrtc::VideoFrame& decodedImage) override
+            {
+                OnDecoded(decodedImage);
+                return callback->Decoded(decodedImage);
+            }
+            int32_t Decoded(webrtc::VideoFrame& decodedImage, int64_t decodeTimeMs) override
+            {
+                OnDecoded(decodedImage);
+                return callback->Decoded(decodedImage, decodeTimeMs);
+            }
+            void Decoded(webrtc::VideoFrame& decodedImage, absl::optional<int32_t> decodeTimeMs, absl::optional<uint8_t> qp) override
+            {
+                OnDecoded(decodedImage);
+                callback->Decoded(decodedImage, decodeTimeMs, qp);
+            }
+
+        private:
+            struct PendingFrame
+            {
+                uint32 rtpTimestamp;
+                int64 decodeStartUs;
+            };
+
+            void OnDecoded(const webrtc::VideoFrame& frame)
+            {
+                int64 decodeTimeUs = 0;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    for (auto& pending : pendingFrames)
+                    {
+                        if (pending.decodeStartUs != 0 && pending.rtpTimestamp == frame.timestamp())
+                        {
+                            decodeTimeUs = rtc::TimeMicros() - pending.decodeStartUs;
+                            pending.decodeStartUs = 0;
+                            break;
+                        }
+                    }
+                }
+                stats->OnFrameDecoded(decodeTimeUs, usingHardware);
+            }
+
+            //the fallback wrapper reports the software decoder's name once it has given up on the hardware
+            void CheckFallback()
+            {
+                if (usingHardware && hardwareName != decoder->ImplementationName())
+                {
+                    usingHardware = false;
+                    stats->OnFallback();
+                }
+            }
+
+            std::unique_ptr<webrtc::VideoDecoder> decoder;
+            const std::string hardwareName;
+            std::shared_ptr<VideoDecoderStatsCollector> stats;
+            webrtc::DecodedImageCallback* callback = nullptr;
+            std::atomic<bool> usingHardware;
+
+            std::mutex mutex;
+            //frames the decoder may still hold, hardware decoders usually keep only a few
+            std::array<PendingFrame, 16> pendingFrames {};
+            size_t nextPendingFrame = 0;
+        };
+    }
+
+    HardwareVideoDecoderFactory::HardwareVideoDecoderFactory(std::unique_ptr<webrtc::VideoDecoderFactory> softwareFactory)
+        : softwareFactory(std::move(softwareFactory)), stats(std::make_shared<VideoDecoderStatsCollector>())
+    {
+    }
+
+    void HardwareVideoDecoderFactory::AddBackend(std::unique_ptr<IHardwareDecoderBackend> backend)
+    {
+        std::lock_guard<std::mutex> lock(backendsMutex);
+        backends.push_back(std::move(backend));
+    }
+
+    std::vector<webrtc::SdpVideoFormat> HardwareVideoDecoderFactory::GetSupportedFormats() const
+    {
+        //every format must keep working when the hardware fails, so only the software formats are offered
+        return softwareFactory->GetSupportedFormats();
+    }
+
+    std::unique_ptr<webrtc::VideoDecoder> HardwareVideoDecoderFactory::CreateVideoDecoder(const webrtc::SdpVideoFormat& format)
+    {
+        std::unique_ptr<webrtc::VideoDecoder> softwareDecoder = softwareFactory->CreateVideoDecoder(format);
+        std::lock_guard<std::mutex> lock(backendsMutex);
+        for (const auto& backend : backends)
+        {
+            if (!backend->IsSupported(format))
+            {
+                continue;
+            }
+            std::unique_ptr<webrtc::VideoDecoder> hardwareDecoder = backend->CreateDecoder(format);
+            if (hardwareDecoder == nullptr)
+            {
+                DebugWarning("%s failed to create a %s decoder", backend->GetName(), format.name.c_str());
+                continue;
+            }
+            std::string hardwareName = hardwareDecoder->ImplementationName();
+            if (softwareDecoder != nullptr)
+            {
+                hardwareDecoder = webrtc::CreateVideoDecoderSoftwareFallbackWrapper(std::move(softwareDecoder), std::move(hardwareDecoder));
+            }
+            return std::make_unique<StatsVideoDecoder>(std::move(hardwareDecoder), std::move(hardwareName), stats);
+        }
+        if (softwareDecoder == nullptr)
+        {
+            return nullptr;
+        }
+        return std::make_unique<StatsVideoDecoder>(std::move(softwareDecoder), std::string(), stats);
+    }
+}
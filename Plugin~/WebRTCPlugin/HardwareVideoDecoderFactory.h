@@ -0,0 +1,68 @@
+#pragma once
+
+#include <mutex>
+
+namespace WebRTC
+{
+    //layout shared with the C# VideoDecoderStats struct
+    struct VideoDecoderStats
+    {
+        uint64 decodedFrames = 0;
+        //frames decoded by a hardware backend, the others went through the software decoders
+        uint64 hardwareDecodedFrames = 0;
+        //hardware decoders which gave up and handed over to the software decoder
+        uint64 fallbackCount = 0;
+        int64 totalDecodeTimeUs = 0;
+        int64 maxDecodeTimeUs = 0;
+    };
+
+    class VideoDecoderStatsCollector
+    {
+    public:
+        void OnFrameDecoded(int64 decodeTimeUs, bool hardware);
+        void OnFallback();
+        VideoDecoderStats GetStats() const;
+    private:
+        mutable std::mutex mutex;
+        VideoDecoderStats stats;
+    };
+
+    // A hardware decoder implementation, CreateDecoder may return nullptr if the
+    // device turns out not to be able to decode the format.
+    // Hosts register theirs with Context::AddVideoDecoderBackend, or with the
+    // ContextAddVideoDecoderBackend export from another native plugin built with the same compiler.
+    class IHardwareDecoderBackend
+    {
+    public:
+        virtual ~IHardwareDecoderBackend() {}
+        virtual const char* GetName() const = 0;
+        virtual bool IsSupported(const webrtc::SdpVideoFormat& format) const = 0;
+        virtual std::unique_ptr<webrtc::VideoDecoder> CreateDecoder(const webrtc::SdpVideoFormat& format) = 0;
+    };
+
+    // HardwareVideoDecoderFactory hands out a decoder of the first backend supporting
+    // the format, wrapped so that webrtc falls back to the builtin software decoder
+    // when the hardware fails to initialize or decode. Without a backend for the
+    // format the software decoder is used directly.
+    // Every decoder reports the time between Decode() and its output to the stats.
+    class HardwareVideoDecoderFactory : public webrtc::VideoDecoderFactory
+    {
+    public:
+        explicit HardwareVideoDecoderFactory(std::unique_ptr<webrtc::VideoDecoderFactory> softwareFactory);
+        // Backends are tried in the order they are added, they apply to the decoders created afterwards.
+        void AddBackend(std::unique_ptr<IHardwareDecoderBackend> backend);
+        VideoDecoderStats GetStats() const { return stats->GetStats(); }
+
+        //webrtc::VideoDecoderFactory
+        std::vector<webrtc::SdpVideoFormat> GetSupportedFormats() const override;
+        std::unique_ptr<webrtc::VideoDecoder> CreateVideoDecoder(const webrtc::SdpVideoFormat& format) override;
+
+    private:
+        std::unique_ptr<webrtc::VideoDecoderFactory> softwareFactory;
+        std::vector<std::unique_ptr<IHardwareDecoderBackend>> backends;
+        //backends are added from the main thread while webrtc creates decoders on its worker thread
+        std::mutex backendsMutex;
+        //shared with the decoders, which may outlive the factory
+        std::shared_ptr<VideoDecoderStatsCollector> stats;
+    };
+}
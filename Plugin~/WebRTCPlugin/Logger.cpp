@@ -1,25 +1,139 @@
 ﻿#include "pch.h"
 
-#if defined(_DEBUG)
-#include <cstdarg>
-#include "WebRTCPlugin.h"
-#endif
-
 namespace WebRTC
 {
-    void LogPrint(const char* fmt, ...)
+    const size_t LogQueue::Capacity;
+
+    namespace
     {
 #if defined(_DEBUG)
-        va_list vl;
-        va_start(vl, fmt);
-        char buf[2048];
-#if defined(_WIN32)
-        vsprintf_s(buf, fmt, vl);
+        std::atomic<int32> s_logLevel { static_cast<int32>(LogLevel::Verbose) };
 #else
-        vsprintf(buf, fmt, vl);
+        std::atomic<int32> s_logLevel { static_cast<int32>(LogLevel::Warning) };
 #endif
-        debugLog(buf);
-        va_end(vl);
+
+        LogQueue& GetLogQueue()
+        {
+            static LogQueue queue;
+            return queue;
+        }
+    }
+
+    LogQueue::LogQueue()
+    {
+        for (size_t i = 0; i < Capacity; i++)
+        {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool LogQueue::Push(LogLevel level, const char* fmt, va_list args)
+    {
+        size_t position = pushPosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;)
+        {
+            slot = &slots[position % Capacity];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == position)
+            {
+                if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (sequence < position)
+            {
+                //the consumer hasn't caught up, never wait on a hot path
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                position = pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+        slot->record.level = level;
+        slot->record.timestampUs = rtc::TimeMicros();
+        //truncated to the record size
+        vsnprintf(slot->record.message, MaxLogMessageSize, fmt, args);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool LogQueue::Pop(LogRecord* record)
+    {
+        size_t position = popPosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;)
+        {
+            slot = &slots[position % Capacity];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == position + 1)
+            {
+                if (popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (sequence < position + 1)
+            {
+                return false;
+            }
+            else
+            {
+                position = popPosition.load(std::memory_order_relaxed);
+            }
+        }
+        *record = slot->record;
+        slot->sequence.store(position + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    void SetLogLevel(LogLevel level)
+    {
+        s_logLevel.store(static_cast<int32>(level), std::memory_order_relaxed);
+    }
+
+    bool IsLogLevelEnabled(LogLevel level)
+    {
+        return static_cast<int32>(level) >= s_logLevel.load(std::memory_order_relaxed);
+    }
+
+    void LogMessage(LogLevel level, const char* fmt, ...)
+    {
+        va_list args;
+        va_start(args, fmt);
+        GetLogQueue().Push(level, fmt, args);
+        va_end(args);
+    }
+
+    int32 DrainLog(LogRecord* records, int32 capacity)
+    {
+        int32 count = 0;
+        while (count < capacity && GetLogQueue().Pop(&records[count]))
+        {
+            count++;
+        }
+        return count;
+    }
+
+    uint64 GetDroppedLogCount()
+    {
+        return GetLogQueue().GetDroppedCount();
+    }
+
+    void LogPrint(const char* fmt, ...)
+    {
+#if WEBRTC_MIN_LOG_LEVEL <= 0
+        if (!IsLogLevelEnabled(LogLevel::Verbose))
+        {
+            return;
+        }
+        va_list args;
+        va_start(args, fmt);
+        GetLogQueue().Push(LogLevel::Verbose, fmt, args);
+        va_end(args);
 #endif
     }
     void checkf(bool result, const char* msg)
@@ -1,6 +1,78 @@
 ﻿#pragma once
 
+#include <atomic>
+#include <cstdarg>
+
+//levels below it are compiled out, verbose messages only exist in debug builds
+#if !defined(WEBRTC_MIN_LOG_LEVEL)
+#if defined(_DEBUG)
+#define WEBRTC_MIN_LOG_LEVEL 0
+#else
+#define WEBRTC_MIN_LOG_LEVEL 1
+#endif
+#endif
+
+//the arguments are only evaluated when the level passes both filters
+#define WEBRTC_LOG(level, ...) \
+    do { \
+        if (static_cast<int>(level) >= WEBRTC_MIN_LOG_LEVEL && ::WebRTC::IsLogLevelEnabled(level)) \
+            ::WebRTC::LogMessage(level, __VA_ARGS__); \
+    } while (false)
+
 namespace WebRTC
 {
+    enum class LogLevel : int32
+    {
+        Verbose,
+        Info,
+        Warning,
+        Error,
+        None
+    };
+
+    const int MaxLogMessageSize = 256;
+
+    struct LogRecord
+    {
+        LogLevel level;
+        int64 timestampUs;
+        char message[MaxLogMessageSize];
+    };
+
+    // Bounded lock free queue of log records, any thread can push and pop.
+    // A record pushed while the queue is full is dropped and counted, the caller never waits.
+    class LogQueue
+    {
+    public:
+        static const size_t Capacity = 256;
+
+        LogQueue();
+        bool Push(LogLevel level, const char* fmt, va_list args);
+        bool Pop(LogRecord* record);
+        uint64 GetDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    private:
+        struct Slot
+        {
+            //equals the position of the next push into the slot when free, that position + 1 once written
+            std::atomic<size_t> sequence;
+            LogRecord record;
+        };
+
+        Slot slots[Capacity];
+        std::atomic<size_t> pushPosition { 0 };
+        std::atomic<size_t> popPosition { 0 };
+        std::atomic<uint64> dropped { 0 };
+    };
+
+    void SetLogLevel(LogLevel level);
+    bool IsLogLevelEnabled(LogLevel level);
+    // Formats the message into a record of the process log queue, the host drains it with DrainLog.
+    void LogMessage(LogLevel level, const char* fmt, ...);
+    // Copies up to capacity records, oldest first, and returns how many were copied.
+    int32 DrainLog(LogRecord* records, int32 capacity);
+    uint64 GetDroppedLogCount();
+
+    // Verbose message, compiled out of release builds.
     void LogPrint(const char* fmt, ...);
 }
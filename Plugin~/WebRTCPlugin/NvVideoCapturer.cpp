@@ -1,32 +1,58 @@
 #include "pch.h"
 #include "NvVideoCapturer.h"
 #include "Codec/EncoderFactory.h"
+#include "FrameTrace.h"
 
 namespace WebRTC
 {
+    const int NvVideoCapturer::MaxSimulcastLayers;
+    const int NvVideoCapturer::MaxPlayoutDelayMs;
+
     NvVideoCapturer::NvVideoCapturer()
+        : link(new rtc::RefCountedObject<CapturerLink>(this))
     {
         set_enable_video_adapter(false);
         SetSupportedFormats(std::vector<cricket::VideoFormat>(1, cricket::VideoFormat(width, height, cricket::VideoFormat::FpsToInterval(framerate), cricket::FOURCC_H264)));
     }
-    void NvVideoCapturer::EncodeVideoData()
+
+    NvVideoCapturer::~NvVideoCapturer()
     {
+        //waits for an encoder queue which is using the capturer
+        link->Detach();
+    }
+
+    void NvVideoCapturer::EncodeVideoData(int64 captureTimeUs)
+    {
+        std::lock_guard<std::mutex> lock(layersMutex);
         if (captureStarted && !captureStopped)
         {
-            if(encoder_ == nullptr)
+            if(layers_.empty())
             {
                 LogPrint("nvEncoder is null");
                 return;
             }
-            if(!encoder_->CopyBuffer(unityRT))
+            //skip surplus frames before touching the GPU when Unity renders faster than the target rate
+            if(!pacer.ShouldEncodeFrame(captureTimeUs))
             {
-                LogPrint("CopyRenderTexture Failed");
                 return;
             }
-            if(!encoder_->EncodeFrame()) {
-                LogPrint("EncodeFrame Failed");
-                return;
+            if(feedback.ShouldEncodeKeyFrame(captureTimeUs / rtc::kNumMicrosecsPerMillisec))
+            {
+                SetIdrFrames();
             }
+            //lower layers first, the full resolution frame carries them to DummyVideoEncoder
+            const size_t topLayer = layers_.size() - 1;
+            for (size_t i = 0; i < topLayer; i++)
+            {
+                SimulcastLayer& layer = *layers_[i];
+                layer.frame = nullptr;
+                if (layer.active)
+                {
+                    EncodeLayer(layer, captureTimeUs);
+                }
+            }
+            //webrtc drives every stream from the frames it receives, so the top layer is always encoded
+            EncodeLayer(*layers_[topLayer], captureTimeUs);
         }
         else
         {
@@ -34,8 +60,52 @@ namespace WebRTC
         }
     }
 
+    bool NvVideoCapturer::EncodeLayer(SimulcastLayer& layer, int64 captureTimeUs)
+    {
+        if(!layer.encoder->CopyBuffer(unityRT, captureTimeUs))
+        {
+            DebugWarning("CopyRenderTexture Failed");
+            return false;
+        }
+        encodingLayer = &layer;
+        bool result;
+        {
+            ScopedTrace trace("EncodeFrame", captureTimeUs);
+            result = layer.encoder->EncodeFrame();
+        }
+        encodingLayer = nullptr;
+        if(!result) {
+            DebugWarning("EncodeFrame Failed");
+            return false;
+        }
+        return true;
+    }
+
     void NvVideoCapturer::CaptureFrame(webrtc::VideoFrame& videoFrame)
     {
+        ScopedTrace trace("CaptureFrame", videoFrame.timestamp_us());
+        if (encoderType != UnityEncoderType::UnityEncoderHardware)
+        {
+            ScopedTrace onFrameTrace("OnFrame", videoFrame.timestamp_us());
+            OnFrame(videoFrame, width, height);
+            return;
+        }
+        FrameBuffer* frameBuffer = static_cast<FrameBuffer*>(videoFrame.video_frame_buffer().get());
+        frameBuffer->SetCapturer(link);
+        if (encodingLayer != nullptr && encodingLayer != layers_.back().get())
+        {
+            encodingLayer->frame = frameBuffer;
+            return;
+        }
+        for (size_t i = 0; i + 1 < layers_.size(); i++)
+        {
+            if (layers_[i]->frame != nullptr)
+            {
+                frameBuffer->AddSimulcastLayer(layers_[i]->frame);
+                layers_[i]->frame = nullptr;
+            }
+        }
+        ScopedTrace onFrameTrace("OnFrame", videoFrame.timestamp_us());
         OnFrame(videoFrame, width, height);
     }
 
@@ -46,11 +116,20 @@ namespace WebRTC
     }
     CodecInitializationResult NvVideoCapturer::GetCodecInitializationResult() const
     {
-        if(encoder_ == nullptr)
+        std::lock_guard<std::mutex> lock(layersMutex);
+        if(layers_.empty())
         {
             return CodecInitializationResult::NotInitialized;
         }
-        return encoder_->GetCodecInitializationResult();
+        for (const auto& layer : layers_)
+        {
+            const CodecInitializationResult result = layer->encoder->GetCodecInitializationResult();
+            if (result != CodecInitializationResult::Success)
+            {
+                return result;
+            }
+        }
+        return CodecInitializationResult::Success;
     }
     
     void NvVideoCapturer::SetFrameBuffer(void* frameBuffer)
@@ -64,36 +143,193 @@ namespace WebRTC
         this->height = height;
     }
 
+    void NvVideoCapturer::SetSimulcastLayers(int layers)
+    {
+        simulcastLayers = std::min(std::max(layers, 1), MaxSimulcastLayers);
+    }
+
     void NvVideoCapturer::SetKeyFrame()
     {
-        encoder_->SetIdrFrame();
+        std::lock_guard<std::mutex> lock(layersMutex);
+        SetIdrFrames();
+    }
+
+    void NvVideoCapturer::SetIdrFrames()
+    {
+        for (const auto& layer : layers_)
+        {
+            layer->encoder->SetIdrFrame();
+        }
     }
+
     void NvVideoCapturer::SetRate(uint32 rate)
     {
-        encoder_->SetRate(rate);
+        std::lock_guard<std::mutex> lock(layersMutex);
+        if (!layers_.empty())
+        {
+            layers_.back()->encoder->SetRate(rate);
+        }
     }
 
-    bool NvVideoCapturer::InitializeEncoder(IGraphicsDevice* device, UnityEncoderType encoderType)
+    void NvVideoCapturer::SetLayerRate(int layer, uint32 rate)
+    {
+        std::lock_guard<std::mutex> lock(layersMutex);
+        ApplyLayerRate(layer, rate);
+    }
+
+    void NvVideoCapturer::ApplyLayerRate(int layer, uint32 rate)
     {
-        try
+        if (layer < 0 || layer >= static_cast<int>(layers_.size()))
+        {
+            return;
+        }
+        //the full resolution layer keeps running even if nobody asks for it
+        if (layer == static_cast<int>(layers_.size()) - 1)
+        {
+            if (rate > 0)
+            {
+                layers_[layer]->encoder->SetRate(rate);
+            }
+            return;
+        }
+        layers_[layer]->active = rate > 0;
+        if (rate > 0)
         {
-            EncoderFactory::GetInstance().Init(width, height, device, encoderType);
+            layers_[layer]->encoder->SetRate(rate);
         }
-        catch(std::runtime_error& exception)
+    }
+
+    bool NvVideoCapturer::GetEncoderStats(int layer, EncoderStats* stats) const
+    {
+        std::lock_guard<std::mutex> lock(layersMutex);
+        if (layer < 0 || layer >= static_cast<int>(layers_.size()))
         {
-            LogPrint(exception.what());
             return false;
         }
-        encoder_ = EncoderFactory::GetInstance().GetEncoder();
-        if (encoder_ == nullptr)
+        *stats = layers_[layer]->encoder->GetStats();
+        return true;
+    }
+
+    void NvVideoCapturer::RequestKeyFrame()
+    {
+        feedback.RequestKeyFrame();
+    }
+
+    void NvVideoCapturer::SetSubscriberRate(const void* subscriber, int layer, uint32 rate)
+    {
+        feedback.SetBitrate(subscriber, layer, rate);
+        const uint32 target = feedback.GetTargetBitrate(layer);
+        std::lock_guard<std::mutex> lock(layersMutex);
+        ApplyLayerRate(layer, target);
+    }
+
+    void NvVideoCapturer::RemoveSubscriber(const void* subscriber)
+    {
+        feedback.RemoveSubscriber(subscriber);
+    }
+
+    bool NvVideoCapturer::IsValidPlayoutDelay(int minMs, int maxMs)
+    {
+        //the extension carries 12 bits in 10ms steps
+        if (minMs < -1 || minMs > MaxPlayoutDelayMs || maxMs < -1 || maxMs > MaxPlayoutDelayMs)
+        {
             return false;
-        encoder_->CaptureFrame.connect(this, &NvVideoCapturer::CaptureFrame);
+        }
+        return minMs == -1 || maxMs == -1 || minMs <= maxMs;
+    }
+
+    void NvVideoCapturer::SetPlayoutDelay(int minMs, int maxMs)
+    {
+        playoutDelay = static_cast<uint64>(static_cast<uint32>(minMs)) << 32 | static_cast<uint32>(maxMs);
+    }
+
+    webrtc::PlayoutDelay NvVideoCapturer::GetPlayoutDelay() const
+    {
+        const uint64 value = playoutDelay;
+        return { static_cast<int32>(static_cast<uint32>(value >> 32)), static_cast<int32>(static_cast<uint32>(value)) };
+    }
+
+    void NvVideoCapturer::SetFramerate(uint32 framerate)
+    {
+        pacer.SetEncoderFramerate(static_cast<int>(framerate));
+    }
+
+    void NvVideoCapturer::OnSinkWantsChanged(const rtc::VideoSinkWants& wants)
+    {
+        VideoCapturer::OnSinkWantsChanged(wants);
+        pacer.SetSinkFramerate(wants.max_framerate_fps);
+    }
+
+    bool NvVideoCapturer::InitializeEncoder(IGraphicsDevice* device, UnityEncoderType encoderType)
+    {
+        this->encoderType = encoderType;
+        //only the hardware encoders take their input from a scaled copy of the render texture
+        int layerCount = encoderType == UnityEncoderType::UnityEncoderHardware ? simulcastLayers : 1;
+        if (layerCount > 1 && !device->SupportsScaling())
+        {
+            DebugWarning("The graphics device can't scale textures, simulcast falls back to a single layer");
+            layerCount = 1;
+        }
+        std::lock_guard<std::mutex> lock(layersMutex);
+        layers_.clear();
+        for (int i = 0; i < layerCount; i++)
+        {
+            const int shift = layerCount - 1 - i;
+            auto layer = std::make_unique<SimulcastLayer>();
+            layer->width = (width >> shift) & ~1;
+            layer->height = (height >> shift) & ~1;
+            try
+            {
+                layer->encoder = EncoderFactory::Create(layer->width, layer->height, device, encoderType);
+                if (layer->encoder == nullptr)
+                    return false;
+                layer->encoder->SetScaleInput(shift > 0);
+                layers_.push_back(std::move(layer));
+                layers_.back()->encoder->InitV();
+            }
+            catch(std::runtime_error& exception)
+            {
+                DebugError("%s", exception.what());
+                return false;
+            }
+            catch(CodecInitializationResult result)
+            {
+                //keep the encoder around so that GetCodecInitializationResult() reports why it failed
+                DebugError("Encoder initialization failed %d", static_cast<int>(result));
+                return false;
+            }
+            layers_.back()->encoder->CaptureFrame.connect(this, &NvVideoCapturer::CaptureFrame);
+        }
         return true;
     }
 
     void NvVideoCapturer::FinalizeEncoder()
     {
-        EncoderFactory::GetInstance().Shutdown();
-        encoder_ = nullptr;
+        std::lock_guard<std::mutex> lock(layersMutex);
+        captureStarted = false;
+        layers_.clear();
+    }
+
+    const std::vector<webrtc::H264::NaluIndex>& FrameBuffer::NaluIndices()
+    {
+        std::call_once(parseOnce, [this]()
+        {
+            naluIndices = webrtc::H264::FindNaluIndices(buffer.cdata(), buffer.size());
+            for (const auto& index : naluIndices)
+            {
+                if (webrtc::H264::ParseNaluType(buffer.cdata()[index.payload_start_offset]) == webrtc::H264::kIdr)
+                {
+                    keyFrame = true;
+                    break;
+                }
+            }
+        });
+        return naluIndices;
+    }
+
+    bool FrameBuffer::IsKeyFrame()
+    {
+        NaluIndices();
+        return keyFrame;
     }
 }
@@ -1,17 +1,54 @@
 #pragma once
 
+#include <atomic>
+#include "rtc_base/copy_on_write_buffer.h"
 #include "Codec/IEncoder.h"
 #include "VideoCapturer.h"
+#include "FramePacer.h"
+#include "BroadcastFeedback.h"
 
 namespace WebRTC
 {
     class ITexture2D;
     class IGraphicsDevice;
+    class FrameBuffer;
+    class NvVideoCapturer;
+
+    // CapturerLink lets the encoders of the peer connections reach the capturer of their frames.
+    // The capturer detaches it when it is destroyed, so an encoder or a queued frame holding
+    // the link never calls into a deleted capturer.
+    class CapturerLink : public rtc::RefCountInterface
+    {
+    public:
+        explicit CapturerLink(NvVideoCapturer* capturer) : capturer(capturer) {}
+        //calls func with the capturer while it can't be destroyed, returns false if it is gone
+        template<typename Func>
+        bool Use(Func func)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (capturer == nullptr)
+            {
+                return false;
+            }
+            func(*capturer);
+            return true;
+        }
+        void Detach()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            capturer = nullptr;
+        }
+    private:
+        std::mutex mutex;
+        NvVideoCapturer* capturer;
+    };
+
     class NvVideoCapturer : public VideoCapturer
     {
     public:
         NvVideoCapturer();
-        void EncodeVideoData();
+        ~NvVideoCapturer() override;
+        void EncodeVideoData(int64 captureTimeUs);
         // Start the video capturer with the specified capture format.
         virtual CaptureState Start(const cricket::VideoFormat& Format) override
         {
@@ -39,10 +76,35 @@ namespace WebRTC
         void FinalizeEncoder();
         void SetKeyFrame();
         void SetSize(int32 width, int32 height);
+        //Must be called before InitializeEncoder. Every layer halves the resolution of the one above it.
+        void SetSimulcastLayers(int layers);
+        static const int MaxSimulcastLayers = 3;
+        int GetSimulcastLayers() const { return simulcastLayers; }
         void SetRate(uint32 rate);
+        //layer 0 is the lowest resolution like webrtc::VideoCodec::simulcastStream, rate 0 disables the layer
+        void SetLayerRate(int layer, uint32 rate);
+        void SetFramerate(uint32 framerate);
+        //feedback of the peer connections sharing this capturer, merged by BroadcastFeedback
+        void RequestKeyFrame();
+        void SetSubscriberRate(const void* subscriber, int layer, uint32 rate);
+        void RemoveSubscriber(const void* subscriber);
+        void SetBitratePolicy(BitratePolicy policy) { feedback.SetPolicy(policy); }
+        //sent with every frame in the playout-delay RTP header extension, -1 leaves a bound to the receiver
+        static const int MaxPlayoutDelayMs = 40950;
+        static bool IsValidPlayoutDelay(int minMs, int maxMs);
+        //the pair is stored in one atomic so that an encoder never reads half of an update
+        void SetPlayoutDelay(int minMs, int maxMs);
+        webrtc::PlayoutDelay GetPlayoutDelay() const;
+        const BroadcastFeedback& GetFeedback() const { return feedback; }
         void CaptureFrame(webrtc::VideoFrame& videoFrame);
         bool CaptureStarted() const { return captureStarted; }
         CodecInitializationResult GetCodecInitializationResult() const;
+        uint64 GetDroppedFrameCount() const { return pacer.GetDroppedFrameCount(); }
+        rtc::scoped_refptr<CapturerLink> GetLink() const { return link; }
+        //layer 0 is the lowest resolution, returns false if the layer doesn't exist
+        bool GetEncoderStats(int layer, EncoderStats* stats) const;
+    protected:
+        void OnSinkWantsChanged(const rtc::VideoSinkWants& wants) override;
     private:
         // subclasses override this virtual method to provide a vector of fourccs, in
         // order of preference, that are expected by the media engine.
@@ -51,9 +113,32 @@ namespace WebRTC
             fourccs->push_back(cricket::FOURCC_H264);
             return true;
         }
+        struct SimulcastLayer
+        {
+            std::unique_ptr<IEncoder> encoder;
+            int32 width = 0;
+            int32 height = 0;
+            std::atomic<bool> active = { true };
+            //output of the current capture, collected until the full resolution layer has been encoded
+            rtc::scoped_refptr<FrameBuffer> frame;
+        };
+        bool EncodeLayer(SimulcastLayer& layer, int64 captureTimeUs);
+        //these expect layersMutex to be held
+        void SetIdrFrames();
+        void ApplyLayerRate(int layer, uint32 rate);
+
         void* unityRT = nullptr;
 
-        IEncoder* encoder_ = nullptr;
+        //each capturer owns its encode sessions so that several tracks can be encoded side by side,
+        //ordered from the lowest resolution, the last one is the full resolution
+        std::vector<std::unique_ptr<SimulcastLayer>> layers_;
+        //layers_ is replaced on the rendering thread and reached from the encoder queues of the peer connections,
+        //CaptureFrame runs inside EncodeFrame and relies on EncodeVideoData holding it
+        mutable std::mutex layersMutex;
+        rtc::scoped_refptr<CapturerLink> link;
+        int simulcastLayers = 1;
+        SimulcastLayer* encodingLayer = nullptr;
+        UnityEncoderType encoderType = UnityEncoderType::UnityEncoderHardware;
 
         //just fake info
         int32 width = 1280;
@@ -63,14 +148,35 @@ namespace WebRTC
         bool captureStarted = false;
         bool captureStopped = false;
 
+        FramePacer pacer { framerate };
+        BroadcastFeedback feedback;
+        //min in the upper and max in the lower 32 bits
+        std::atomic<uint64> playoutDelay { ~0ull };
+
     };
 
+    // FrameBuffer carries one encoded frame to the DummyVideoEncoder of every peer connection.
+    // It owns its bitstream, the encoder queues may send it after the encoder which produced it
+    // has reused its output buffers or has been destroyed.
     class FrameBuffer : public webrtc::VideoFrameBuffer
     {
     public:
-        std::vector<uint8>& buffer;
+        FrameBuffer(int width, int height, const rtc::CopyOnWriteBuffer& data, int64 encodeStartMs, int64 encodeFinishMs)
+            : buffer(data), frameWidth(width), frameHeight(height), encodeStartMs(encodeStartMs), encodeFinishMs(encodeFinishMs) {}
 
-        FrameBuffer(int width, int height, std::vector<uint8>& data) : buffer(data), frameWidth(width), frameHeight(height)  {}
+        //never written after construction
+        const rtc::CopyOnWriteBuffer& Data() const { return buffer; }
+        int64 EncodeStartMs() const { return encodeStartMs; }
+        int64 EncodeFinishMs() const { return encodeFinishMs; }
+        //the capturer which produced this frame, DummyVideoEncoder routes its feedback to it
+        rtc::scoped_refptr<CapturerLink> Capturer() const { return capturer; }
+        void SetCapturer(rtc::scoped_refptr<CapturerLink> source) { capturer = source; }
+        //lower resolution simulcast layers of this frame ordered from the lowest, this frame is the highest
+        const std::vector<rtc::scoped_refptr<FrameBuffer>>& SimulcastLayers() const { return simulcastLayers; }
+        void AddSimulcastLayer(rtc::scoped_refptr<FrameBuffer> layer) { simulcastLayers.push_back(layer); }
+        //parsed once and shared by the DummyVideoEncoder of every peer connection
+        const std::vector<webrtc::H264::NaluIndex>& NaluIndices();
+        bool IsKeyFrame();
 
         //webrtc::VideoFrameBuffer pure virtual functions
         // This function specifies in what pixel format the data is stored in.
@@ -99,7 +205,15 @@ namespace WebRTC
         }
 
     private:
+        const rtc::CopyOnWriteBuffer buffer;
         int frameWidth;
         int frameHeight;
+        int64 encodeStartMs;
+        int64 encodeFinishMs;
+        rtc::scoped_refptr<CapturerLink> capturer;
+        std::vector<rtc::scoped_refptr<FrameBuffer>> simulcastLayers;
+        std::once_flag parseOnce;
+        std::vector<webrtc::H264::NaluIndex> naluIndices;
+        bool keyFrame = false;
     };
 }
@@ -0,0 +1,130 @@
+#include "pch.h"
+#include "OpusSettings.h"
+#include "absl/strings/match.h"
+#include "pc/session_description.h"
+#include "rtc_base/string_to_number.h"
+
+namespace WebRTC
+{
+    const char OpusComplexityParameter[] = "x-unity-complexity";
+
+    namespace
+    {
+        bool IsSupportedFrameSize(int frameSizeMs)
+        {
+            return frameSizeMs == 10 || frameSizeMs == 20 || frameSizeMs == 40 || frameSizeMs == 60;
+        }
+    }
+
+    void ApplyOpusSettings(const OpusSettings& settings, cricket::AudioCodec* codec)
+    {
+        if (settings.bitrate > 0)
+        {
+            codec->SetParam(cricket::kCodecParamMaxAverageBitrate, settings.bitrate);
+        }
+        if (IsSupportedFrameSize(settings.frameSizeMs))
+        {
+            codec->SetParam(cricket::kCodecParamPTime, settings.frameSizeMs);
+            //the frame size has to lie within the range the remote accepts, widen it
+            int value = 0;
+            if (codec->GetParam(cricket::kCodecParamMinPTime, &value) && value > settings.frameSizeMs)
+            {
+                codec->SetParam(cricket::kCodecParamMinPTime, settings.frameSizeMs);
+            }
+            if (codec->GetParam(cricket::kCodecParamMaxPTime, &value) && value < settings.frameSizeMs)
+            {
+                codec->SetParam(cricket::kCodecParamMaxPTime, settings.frameSizeMs);
+            }
+        }
+        else if (settings.frameSizeMs != 0)
+        {
+            LogPrint("unsupported opus frame size %d ms", settings.frameSizeMs);
+        }
+        codec->SetParam(cricket::kCodecParamUseInbandFec, settings.inbandFec ? 1 : 0);
+        codec->SetParam(cricket::kCodecParamUseDtx, settings.dtx ? 1 : 0);
+        codec->SetParam(cricket::kCodecParamStereo, settings.stereo ? 1 : 0);
+        if (settings.complexity >= 0 && settings.complexity <= 10)
+        {
+            codec->SetParam(OpusComplexityParameter, settings.complexity);
+        }
+    }
+
+    void ApplyOpusSettings(webrtc::SessionDescriptionInterface* desc,
+        const std::function<const OpusSettings*(const std::string& mid)>& settingsForSection)
+    {
+        for (auto& content : desc->description()->contents())
+        {
+            cricket::MediaContentDescription* media = content.media_description();
+            if (media == nullptr || media->type() != cricket::MEDIA_TYPE_AUDIO)
+            {
+                continue;
+            }
+            const OpusSettings* settings = settingsForSection(content.name);
+            if (settings == nullptr)
+            {
+                continue;
+            }
+            cricket::AudioContentDescription* audio = media->as_audio();
+            std::vector<cricket::AudioCodec> codecs = audio->codecs();
+            for (auto& codec : codecs)
+            {
+                if (absl::EqualsIgnoreCase(codec.name, cricket::kOpusCodecName))
+                {
+                    ApplyOpusSettings(*settings, &codec);
+                }
+            }
+            audio->set_codecs(codecs);
+        }
+    }
+
+    std::vector<webrtc::AudioCodecSpec> OpusAudioEncoderFactory::GetSupportedEncoders()
+    {
+        std::vector<webrtc::AudioCodecSpec> specs;
+        webrtc::AudioEncoderOpus::AppendSupportedEncoders(&specs);
+        return specs;
+    }
+
+    absl::optional<webrtc::AudioCodecInfo> OpusAudioEncoderFactory::QueryAudioEncoder(const webrtc::SdpAudioFormat& format)
+    {
+        auto config = SdpToConfig(format);
+        if (!config)
+        {
+            return absl::nullopt;
+        }
+        return webrtc::AudioEncoderOpus::QueryAudioEncoder(*config);
+    }
+
+    std::unique_ptr<webrtc::AudioEncoder> OpusAudioEncoderFactory::MakeAudioEncoder(
+        int payloadType,
+        const webrtc::SdpAudioFormat& format,
+        absl::optional<webrtc::AudioCodecPairId> codecPairId)
+    {
+        auto config = SdpToConfig(format);
+        if (!config)
+        {
+            return nullptr;
+        }
+        return webrtc::AudioEncoderOpus::MakeAudioEncoder(*config, payloadType, codecPairId);
+    }
+
+    absl::optional<webrtc::AudioEncoderOpusConfig> OpusAudioEncoderFactory::SdpToConfig(const webrtc::SdpAudioFormat& format)
+    {
+        auto config = webrtc::AudioEncoderOpus::SdpToConfig(format);
+        if (!config)
+        {
+            return absl::nullopt;
+        }
+        auto param = format.parameters.find(OpusComplexityParameter);
+        if (param != format.parameters.end())
+        {
+            const absl::optional<int> complexity = rtc::StringToNumber<int>(param->second);
+            if (complexity && *complexity >= 0 && *complexity <= 10)
+            {
+                //the encoder switches to low_rate_complexity at low bitrates, keep it from raising the cost again
+                config->complexity = *complexity;
+                config->low_rate_complexity = std::min(config->low_rate_complexity, *complexity);
+            }
+        }
+        return config;
+    }
+}
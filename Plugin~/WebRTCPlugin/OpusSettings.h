@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+
+#include "api/audio_codecs/audio_encoder_factory.h"
+#include "media/base/codec.h"
+
+namespace WebRTC
+{
+    struct OpusSettings
+    {
+        //target bitrate in bps, 0 keeps the negotiated one
+        int32 bitrate = 0;
+        //10, 20, 40 or 60, 0 keeps the negotiated one
+        int32 frameSizeMs = 0;
+        bool inbandFec = true;
+        bool dtx = false;
+        bool stereo = false;
+        //0 to 10, lower saves CPU at the cost of quality, -1 keeps the encoder default
+        int32 complexity = -1;
+    };
+
+    // The local encoders are configured from the opus fmtp of the remote description, so the
+    // settings of a track are written into the remote description before it is applied.
+    // Complexity has no fmtp parameter, it is passed with OpusComplexityParameter, which only
+    // OpusAudioEncoderFactory understands and which never leaves this process.
+    extern const char OpusComplexityParameter[];
+
+    void ApplyOpusSettings(const OpusSettings& settings, cricket::AudioCodec* codec);
+    // settingsForSection is called with the mid of every audio section in order, it returns
+    // nullptr to leave the section as it is.
+    void ApplyOpusSettings(webrtc::SessionDescriptionInterface* desc,
+        const std::function<const OpusSettings*(const std::string& mid)>& settingsForSection);
+
+    // OpusAudioEncoderFactory creates opus encoders like CreateAudioEncoderFactory<AudioEncoderOpus>,
+    // and applies OpusComplexityParameter on top of the configuration read from the format.
+    class OpusAudioEncoderFactory : public webrtc::AudioEncoderFactory
+    {
+    public:
+        std::vector<webrtc::AudioCodecSpec> GetSupportedEncoders() override;
+        absl::optional<webrtc::AudioCodecInfo> QueryAudioEncoder(const webrtc::SdpAudioFormat& format) override;
+        std::unique_ptr<webrtc::AudioEncoder> MakeAudioEncoder(
+            int payloadType,
+            const webrtc::SdpAudioFormat& format,
+            absl::optional<webrtc::AudioCodecPairId> codecPairId) override;
+
+        static absl::optional<webrtc::AudioEncoderOpusConfig> SdpToConfig(const webrtc::SdpAudioFormat& format);
+    };
+}
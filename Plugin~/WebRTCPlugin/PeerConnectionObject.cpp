@@ -44,8 +44,8 @@ namespace WebRTC
             return nullptr;
         }
         auto ptr = obj.get();
-        clients[ptr] = std::move(obj);
-        return clients[ptr].get();
+        AddPeerConnection(std::move(obj));
+        return ptr;
     }
 
     PeerConnectionObject* Context::CreatePeerConnection(const std::string& conf)
@@ -59,8 +59,8 @@ namespace WebRTC
             return nullptr;
         }
         auto ptr = obj.get();
-        clients[ptr] = std::move(obj);
-        return clients[ptr].get();
+        AddPeerConnection(std::move(obj));
+        return ptr;
     }
 
     void PeerConnectionObject::OnSuccess(webrtc::SessionDescriptionInterface* desc)
@@ -118,11 +118,20 @@ namespace WebRTC
 
     void PeerConnectionObject::OnTrack(rtc::scoped_refptr<webrtc::RtpTransceiverInterface> transceiver)
     {
+        const auto track = transceiver->receiver()->track();
+        if (track->kind() == webrtc::MediaStreamTrackInterface::kAudioKind)
+        {
+            context.AddRemoteAudioTrack(static_cast<webrtc::AudioTrackInterface*>(track.get()));
+        }
         if (onTrack != nullptr)
         {
             onTrack(this, transceiver.get());
         }
     }
+    void PeerConnectionObject::OnRemoveTrack(rtc::scoped_refptr<webrtc::RtpReceiverInterface> receiver)
+    {
+        context.RemoveRemoteAudioTrack(receiver->track());
+    }
     // Called any time the IceConnectionState changes.
     void PeerConnectionObject::OnIceConnectionChange(webrtc::PeerConnectionInterface::IceConnectionState new_state)
     {
@@ -197,6 +206,7 @@ namespace WebRTC
             DebugLog("SdpParseError:\n%s", error.description.c_str());
             return;
         }
+        context.ApplyOpusSettings(connection, _desc.get());
         auto observer = PeerSDPObserver::Create(this);
         connection->SetRemoteDescription(observer, _desc.release());
     }
@@ -209,7 +219,7 @@ namespace WebRTC
         webrtc::RTCError error = connection->SetConfiguration(_config);
         if (!error.ok())
         {
-            LogPrint(error.message());
+            DebugWarning("%s", error.message());
         }
         return error.type();
     }
@@ -233,6 +243,9 @@ namespace WebRTC
             }
             root["iceServers"].append(jsonIceServer);
         }
+        root["audioJitterBufferMaxPackets"] = _config.audio_jitter_buffer_max_packets;
+        root["audioJitterBufferMinDelayMs"] = _config.audio_jitter_buffer_min_delay_ms;
+        root["audioJitterBufferFastAccelerate"] = _config.audio_jitter_buffer_fast_accelerate;
         Json::StreamWriterBuilder builder;
         config = Json::writeString(builder, root);
     }
@@ -283,6 +296,21 @@ namespace WebRTC
         connection->GetStats(m_statsCollectorCallback);
     }
 
+    void PeerConnectionObject::CollectFilteredStats()
+    {
+        connection->GetStats(&m_filteredStatsCollector);
+    }
+
+    void PeerConnectionObject::SetStatsFilter(const StatsFilterEntry* entries, int count)
+    {
+        m_filteredStatsCollector.SetFilter(std::make_unique<StatsFilter>(entries, count));
+    }
+
+    int PeerConnectionObject::GetFilteredStats(StatsValue* values, int capacity, int64* reportTimestampUs)
+    {
+        return m_filteredStatsCollector.GetValues(values, capacity, reportTimestampUs);
+    }
+
 #pragma warning(push)
 #pragma warning(disable: 4715)
     RTCIceConnectionState PeerConnectionObject::GetIceCandidateState()
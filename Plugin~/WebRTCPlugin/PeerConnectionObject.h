@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "WebRTCPlugin.h"
 #include "DataChannelObject.h"
+#include "StatsCollector.h"
 
 
 namespace WebRTC
@@ -53,6 +54,11 @@ namespace WebRTC
         void SetLocalDescription(const RTCSessionDescription& desc);
         void GetLocalDescription(RTCSessionDescription& desc) const;
         void CollectStats();
+        // Collects the stats selected by SetStatsFilter without serializing the report,
+        // GetFilteredStats returns them once delivered.
+        void CollectFilteredStats();
+        void SetStatsFilter(const StatsFilterEntry* entries, int count);
+        int GetFilteredStats(StatsValue* values, int capacity, int64* reportTimestampUs);
         void SetRemoteDescription(const RTCSessionDescription& desc);
         webrtc::RTCErrorType SetConfiguration(const std::string& config);
         void GetConfiguration(std::string& config) const;
@@ -124,6 +130,8 @@ namespace WebRTC
         // RTCSessionDescription" algorithm:
         // https://w3c.github.io/webrtc-pc/#set-description
         void OnTrack(rtc::scoped_refptr<webrtc::RtpTransceiverInterface> transceiver) override;
+        // Called when signaling indicates that media will no longer be received on a track.
+        void OnRemoveTrack(rtc::scoped_refptr<webrtc::RtpReceiverInterface> receiver) override;
 
         friend class DataChannelObject;
 
@@ -142,6 +150,7 @@ namespace WebRTC
     private:
         Context& context;
         PeerConnectionStatsCollectorCallback* m_statsCollectorCallback;
+        FilteredStatsCollector m_filteredStatsCollector;
 
     };
 }
@@ -0,0 +1,123 @@
+#include "pch.h"
+#include "StatsCollector.h"
+
+namespace WebRTC
+{
+    bool ToDouble(const webrtc::RTCStatsMemberInterface& member, double* value)
+    {
+        if (!member.is_defined())
+        {
+            return false;
+        }
+        switch (member.type())
+        {
+        case webrtc::RTCStatsMemberInterface::kBool:
+            *value = *member.cast_to<webrtc::RTCStatsMember<bool>>() ? 1.0 : 0.0;
+            return true;
+        case webrtc::RTCStatsMemberInterface::kInt32:
+            *value = *member.cast_to<webrtc::RTCStatsMember<int32_t>>();
+            return true;
+        case webrtc::RTCStatsMemberInterface::kUint32:
+            *value = *member.cast_to<webrtc::RTCStatsMember<uint32_t>>();
+            return true;
+        case webrtc::RTCStatsMemberInterface::kInt64:
+            *value = static_cast<double>(*member.cast_to<webrtc::RTCStatsMember<int64_t>>());
+            return true;
+        case webrtc::RTCStatsMemberInterface::kUint64:
+            *value = static_cast<double>(*member.cast_to<webrtc::RTCStatsMember<uint64_t>>());
+            return true;
+        case webrtc::RTCStatsMemberInterface::kDouble:
+            *value = *member.cast_to<webrtc::RTCStatsMember<double>>();
+            return true;
+        default:
+            //strings and sequences
+            return false;
+        }
+    }
+
+    StatsFilter::StatsFilter(const StatsFilterEntry* entries, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            this->entries.push_back(Entry { entries[i].type, entries[i].member, entries[i].perSecond });
+        }
+    }
+
+    void StatsFilter::Apply(const webrtc::RTCStatsReport& report, std::vector<StatsValue>& values)
+    {
+        values.clear();
+        //only the stats objects of this report are kept, ids which went away with a renegotiation are dropped
+        std::map<std::pair<std::string, int32>, Sample> currentSamples;
+        for (const webrtc::RTCStats& stats : report)
+        {
+            const std::vector<const webrtc::RTCStatsMemberInterface*> members = stats.Members();
+            uint32 ssrc = 0;
+            for (const webrtc::RTCStatsMemberInterface* member : members)
+            {
+                if (member->is_defined() && member->type() == webrtc::RTCStatsMemberInterface::kUint32 && strcmp(member->name(), "ssrc") == 0)
+                {
+                    ssrc = *member->cast_to<webrtc::RTCStatsMember<uint32_t>>();
+                }
+            }
+            for (int32 i = 0; i < static_cast<int32>(entries.size()); i++)
+            {
+                const Entry& entry = entries[i];
+                if (entry.type != stats.type())
+                {
+                    continue;
+                }
+                for (const webrtc::RTCStatsMemberInterface* member : members)
+                {
+                    double value;
+                    if (entry.member != member->name() || !ToDouble(*member, &value))
+                    {
+                        continue;
+                    }
+                    const int64 timestampUs = stats.timestamp_us();
+                    if (entry.perSecond)
+                    {
+                        const auto key = std::make_pair(stats.id(), i);
+                        currentSamples[key] = Sample { timestampUs, value };
+                        const auto previous = previousSamples.find(key);
+                        if (previous == previousSamples.end() || timestampUs <= previous->second.timestampUs)
+                        {
+                            break;
+                        }
+                        value = (value - previous->second.value) * rtc::kNumMicrosecsPerSec / (timestampUs - previous->second.timestampUs);
+                    }
+                    values.push_back(StatsValue { i, ssrc, timestampUs, value });
+                    break;
+                }
+            }
+        }
+        previousSamples.swap(currentSamples);
+    }
+
+    void FilteredStatsCollector::SetFilter(std::unique_ptr<StatsFilter> value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        filter = std::move(value);
+        latestValues.clear();
+        latestTimestampUs = 0;
+    }
+
+    int FilteredStatsCollector::GetValues(StatsValue* values, int capacity, int64* reportTimestampUs)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const int count = static_cast<int>(latestValues.size());
+        std::copy(latestValues.begin(), latestValues.begin() + std::max(0, std::min(capacity, count)), values);
+        *reportTimestampUs = latestTimestampUs;
+        return count;
+    }
+
+    void FilteredStatsCollector::OnStatsDelivered(const rtc::scoped_refptr<const webrtc::RTCStatsReport>& report)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (filter == nullptr)
+        {
+            return;
+        }
+        filter->Apply(*report, latestValues);
+        latestTimestampUs = report->timestamp_us();
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+
+namespace WebRTC
+{
+    // One member of the stats objects to collect, e.g. type "outbound-rtp" and member "bytesSent".
+    struct StatsFilterEntry
+    {
+        const char* type;
+        const char* member;
+        //the change per second since the previous collection instead of the value, e.g. a bitrate
+        bool perSecond;
+    };
+
+    struct StatsValue
+    {
+        //index of the entry in the filter
+        int32 entry;
+        //ssrc of RTP stream stats, 0 for the other types
+        uint32 ssrc;
+        int64 timestampUs;
+        double value;
+    };
+
+    // Converts numeric and bool members to double, returns false for undefined, string and sequence members.
+    bool ToDouble(const webrtc::RTCStatsMemberInterface& member, double* value);
+
+    // StatsFilter extracts the members selected by its entries from a stats report as numbers,
+    // one value per stats object of the selected type which has the member defined.
+    // Rates need a previous value of the same stats object, so they are missing from the first
+    // report. It isn't thread safe.
+    class StatsFilter
+    {
+    public:
+        StatsFilter(const StatsFilterEntry* entries, int count);
+
+        size_t GetEntryCount() const { return entries.size(); }
+        void Apply(const webrtc::RTCStatsReport& report, std::vector<StatsValue>& values);
+
+    private:
+        struct Entry
+        {
+            std::string type;
+            std::string member;
+            bool perSecond;
+        };
+        struct Sample
+        {
+            int64 timestampUs;
+            double value;
+        };
+        std::vector<Entry> entries;
+        //by stats id and entry index, of the stats objects of the last report only
+        std::map<std::pair<std::string, int32>, Sample> previousSamples;
+    };
+
+    // FilteredStatsCollector receives the stats reports requested with GetStats and keeps the
+    // values selected by its filter, without serializing the report.
+    class FilteredStatsCollector : public webrtc::RTCStatsCollectorCallback
+    {
+    public:
+        //owned by PeerConnectionObject, outlives the requests
+        void AddRef() const override {}
+        rtc::RefCountReleaseStatus Release() const override { return rtc::RefCountReleaseStatus::kOtherRefsRemained; }
+
+        void SetFilter(std::unique_ptr<StatsFilter> value);
+        // Copies up to capacity values of the latest report and returns how many it has.
+        // reportTimestampUs is 0 until a report was delivered.
+        int GetValues(StatsValue* values, int capacity, int64* reportTimestampUs);
+
+        void OnStatsDelivered(const rtc::scoped_refptr<const webrtc::RTCStatsReport>& report) override;
+
+    private:
+        std::mutex mutex;
+        std::unique_ptr<StatsFilter> filter;
+        std::vector<StatsValue> latestValues;
+        int64 latestTimestampUs = 0;
+    };
+}
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "StatsSampler.h"
+#include "StatsCollector.h"
+#include "api/stats/rtcstats_objects.h"
+
+namespace WebRTC
+{
+    namespace
+    {
+        double GetMember(const webrtc::RTCStats& stats, const char* name)
+        {
+            for (const webrtc::RTCStatsMemberInterface* member : stats.Members())
+            {
+                double value;
+                if (strcmp(member->name(), name) == 0 && ToDouble(*member, &value))
+                {
+                    return value;
+                }
+            }
+            return 0;
+        }
+
+        //of the pair each transport sends on, or of the nominated pairs if no transport names its pair.
+        //the other pairs keep the round trip time of their last connectivity check
+        double GetRoundTripTime(const webrtc::RTCStatsReport& report)
+        {
+            double selected = 0;
+            bool hasSelected = false;
+            for (const webrtc::RTCTransportStats* transport : report.GetStatsOfType<webrtc::RTCTransportStats>())
+            {
+                if (!transport->selected_candidate_pair_id.is_defined())
+                {
+                    continue;
+                }
+                const webrtc::RTCStats* pair = report.Get(*transport->selected_candidate_pair_id);
+                if (pair != nullptr && pair->type() == webrtc::RTCIceCandidatePairStats::kType)
+                {
+                    hasSelected = true;
+                    selected = std::max(selected, GetMember(*pair, "currentRoundTripTime"));
+                }
+            }
+            if (hasSelected)
+            {
+                return selected;
+            }
+            double nominated = 0;
+            for (const webrtc::RTCIceCandidatePairStats* pair : report.GetStatsOfType<webrtc::RTCIceCandidatePairStats>())
+            {
+                if (pair->nominated.is_defined() && *pair->nominated)
+                {
+                    nominated = std::max(nominated, GetMember(*pair, "currentRoundTripTime"));
+                }
+            }
+            return nominated;
+        }
+
+        //counters go down when a stream is removed, that isn't a negative rate
+        double Delta(double current, double previous)
+        {
+            return std::max(current - previous, 0.0);
+        }
+    }
+
+    bool StatsSampleCalculator::Add(const webrtc::RTCStatsReport& report, StatsSample* sample)
+    {
+        const Totals current = Sum(report);
+        const absl::optional<Totals> last = previous;
+        previous = current;
+        if (!last || current.timestampUs <= last->timestampUs)
+        {
+            return false;
+        }
+
+        const double seconds = static_cast<double>(current.timestampUs - last->timestampUs) / rtc::kNumMicrosecsPerSec;
+        const double framesEncoded = Delta(current.framesEncoded, last->framesEncoded);
+        const double packetsLost = Delta(current.packetsLost, last->packetsLost);
+        const double packetsExpected = Delta(current.packetsReceived, last->packetsReceived) + packetsLost;
+
+        sample->timestampUs = current.timestampUs;
+        sample->sendBitrate = Delta(current.bytesSent, last->bytesSent) * 8 / seconds;
+        sample->receiveBitrate = Delta(current.bytesReceived, last->bytesReceived) * 8 / seconds;
+        sample->sendFramesPerSecond = framesEncoded / seconds;
+        sample->receiveFramesPerSecond = Delta(current.framesDecoded, last->framesDecoded) / seconds;
+        sample->packetLossPercent = packetsExpected > 0 ? packetsLost * 100 / packetsExpected : 0;
+        sample->jitterMs = current.jitter * rtc::kNumMillisecsPerSec;
+        sample->roundTripTimeMs = current.roundTripTime * rtc::kNumMillisecsPerSec;
+        sample->encodeMsPerFrame = framesEncoded > 0
+            ? Delta(current.totalEncodeTime, last->totalEncodeTime) * rtc::kNumMillisecsPerSec / framesEncoded : 0;
+        return true;
+    }
+
+    StatsSampleCalculator::Totals StatsSampleCalculator::Sum(const webrtc::RTCStatsReport& report)
+    {
+        Totals totals;
+        totals.timestampUs = report.timestamp_us();
+        for (const webrtc::RTCStats& stats : report)
+        {
+            const std::string type = stats.type();
+            if (type == webrtc::RTCOutboundRTPStreamStats::kType)
+            {
+                totals.bytesSent += GetMember(stats, "bytesSent");
+                totals.framesEncoded += GetMember(stats, "framesEncoded");
+                totals.totalEncodeTime += GetMember(stats, "totalEncodeTime");
+            }
+            else if (type == webrtc::RTCInboundRTPStreamStats::kType)
+            {
+                totals.bytesReceived += GetMember(stats, "bytesReceived");
+                totals.framesDecoded += GetMember(stats, "framesDecoded");
+                totals.packetsReceived += GetMember(stats, "packetsReceived");
+                totals.packetsLost += GetMember(stats, "packetsLost");
+                totals.jitter = std::max(totals.jitter, GetMember(stats, "jitter"));
+            }
+        }
+        totals.roundTripTime = GetRoundTripTime(report);
+        return totals;
+    }
+
+    StatsSampler::StatsSampler(size_t capacity) : ring(std::max<size_t>(capacity, 1))
+    {
+    }
+
+    int StatsSampler::GetSamples(StatsSample* samples, int capacity)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const size_t copied = std::min(count, static_cast<size_t>(std::max(capacity, 0)));
+        //the newest samples if they don't all fit
+        size_t index = (next + ring.size() - copied) % ring.size();
+        for (size_t i = 0; i < copied; i++)
+        {
+            samples[i] = ring[index];
+            index = (index + 1) % ring.size();
+        }
+        return static_cast<int>(copied);
+    }
+
+    void StatsSampler::OnStatsDelivered(const rtc::scoped_refptr<const webrtc::RTCStatsReport>& report)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        StatsSample sample;
+        if (!calculator.Add(*report, &sample))
+        {
+            return;
+        }
+        ring[next] = sample;
+        next = (next + 1) % ring.size();
+        count = std::min(count + 1, ring.size());
+    }
+}
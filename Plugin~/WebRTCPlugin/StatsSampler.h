@@ -0,0 +1,70 @@
+#pragma once
+
+#include <mutex>
+
+namespace WebRTC
+{
+    // Rates of a peer connection between two consecutive stats reports, summed over its RTP streams.
+    struct StatsSample
+    {
+        int64 timestampUs;
+        double sendBitrate;
+        double receiveBitrate;
+        double sendFramesPerSecond;
+        double receiveFramesPerSecond;
+        //packets lost over packets expected by the inbound streams
+        double packetLossPercent;
+        //largest jitter of the inbound streams
+        double jitterMs;
+        //of the active candidate pair
+        double roundTripTimeMs;
+        double encodeMsPerFrame;
+    };
+
+    // StatsSampleCalculator derives a StatsSample from each report and the one passed before it.
+    class StatsSampleCalculator
+    {
+    public:
+        // Returns false for the first report, which has nothing to compare with.
+        bool Add(const webrtc::RTCStatsReport& report, StatsSample* sample);
+
+    private:
+        struct Totals
+        {
+            int64 timestampUs = 0;
+            double bytesSent = 0;
+            double bytesReceived = 0;
+            double framesEncoded = 0;
+            double framesDecoded = 0;
+            double totalEncodeTime = 0;
+            double packetsReceived = 0;
+            double packetsLost = 0;
+            double jitter = 0;
+            double roundTripTime = 0;
+        };
+        static Totals Sum(const webrtc::RTCStatsReport& report);
+
+        absl::optional<Totals> previous;
+    };
+
+    // StatsSampler turns the reports of one peer connection into samples, and keeps the latest
+    // ones in a ring of fixed size.
+    class StatsSampler : public webrtc::RTCStatsCollectorCallback
+    {
+    public:
+        explicit StatsSampler(size_t capacity);
+
+        // Copies up to capacity samples, oldest first, and returns how many were copied.
+        int GetSamples(StatsSample* samples, int capacity);
+
+        void OnStatsDelivered(const rtc::scoped_refptr<const webrtc::RTCStatsReport>& report) override;
+
+    private:
+        std::mutex mutex;
+        StatsSampleCalculator calculator;
+        std::vector<StatsSample> ring;
+        //index of the next sample to write
+        size_t next = 0;
+        size_t count = 0;
+    };
+}
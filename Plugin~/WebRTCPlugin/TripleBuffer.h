@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+
+namespace WebRTC
+{
+    // Lock free triple buffer for a single producer and a single consumer.
+    // The producer fills WriteBuffer() and publishes it, the consumer picks up the
+    // most recently published buffer with Update(). Neither side ever waits,
+    // a buffer published while the previous one wasn't consumed replaces it.
+    template<typename T>
+    class TripleBuffer
+    {
+    public:
+        // Producer side
+        T& WriteBuffer() { return buffers[writeIndex]; }
+        // Returns false if the previously published buffer was never consumed.
+        bool Publish()
+        {
+            const uint8 previous = middle.exchange(writeIndex | DirtyBit, std::memory_order_acq_rel);
+            writeIndex = previous & IndexMask;
+            return (previous & DirtyBit) == 0;
+        }
+
+        // Consumer side
+        // Returns true if a newer buffer has been published since the last call.
+        bool Update()
+        {
+            if ((middle.load(std::memory_order_acquire) & DirtyBit) == 0)
+            {
+                return false;
+            }
+            const uint8 previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+            readIndex = previous & IndexMask;
+            return true;
+        }
+        const T& ReadBuffer() const { return buffers[readIndex]; }
+
+    private:
+        static const uint8 IndexMask = 0x3;
+        static const uint8 DirtyBit = 0x4;
+
+        T buffers[3];
+        //index of the buffer shared between both sides, with the dirty bit set when it holds unread data
+        std::atomic<uint8> middle { 1 };
+        uint8 writeIndex = 0;
+        uint8 readIndex = 2;
+    };
+}
@@ -0,0 +1,47 @@
+#include "pch.h"
+#include "VideoFrameReceiver.h"
+#include "third_party/libyuv/include/libyuv/rotate.h"
+
+namespace WebRTC
+{
+    void VideoFrameReceiver::OnFrame(const webrtc::VideoFrame& frame)
+    {
+        webrtc::VideoFrame upright = frame;
+        if (frame.rotation() != webrtc::kVideoRotation_0)
+        {
+            upright.set_video_frame_buffer(Rotate(frame));
+            upright.set_rotation(webrtc::kVideoRotation_0);
+        }
+        RgbaFrame& rgba = frames.WriteBuffer();
+        rgba.width = upright.width();
+        rgba.height = upright.height();
+        rgba.timestampUs = frame.timestamp_us();
+        //the buffers are recycled, so this only allocates when the resolution grows
+        rgba.data.resize(webrtc::CalcBufferSize(webrtc::VideoType::kABGR, rgba.width, rgba.height));
+        //libyuv ABGR is R, G, B, A in memory which is what RGBA32 textures expect
+        if (webrtc::ConvertFromI420(upright, webrtc::VideoType::kABGR, 0, rgba.data.data()) < 0)
+        {
+            LogPrint("ConvertFromI420 failed");
+            return;
+        }
+        receivedFrameCount++;
+        if (!frames.Publish())
+        {
+            skippedFrameCount++;
+        }
+    }
+
+    rtc::scoped_refptr<webrtc::I420BufferInterface> VideoFrameReceiver::Rotate(const webrtc::VideoFrame& frame)
+    {
+        rtc::scoped_refptr<webrtc::I420BufferInterface> source = frame.video_frame_buffer()->ToI420();
+        const bool swap = frame.rotation() == webrtc::kVideoRotation_90 || frame.rotation() == webrtc::kVideoRotation_270;
+        rtc::scoped_refptr<webrtc::I420Buffer> rotated = rotatedBuffers.CreateBuffer(
+            swap ? source->height() : source->width(), swap ? source->width() : source->height());
+        //webrtc::VideoRotation and libyuv::RotationMode share their values
+        libyuv::I420Rotate(
+            source->DataY(), source->StrideY(), source->DataU(), source->StrideU(), source->DataV(), source->StrideV(),
+            rotated->MutableDataY(), rotated->StrideY(), rotated->MutableDataU(), rotated->StrideU(), rotated->MutableDataV(), rotated->StrideV(),
+            source->width(), source->height(), static_cast<libyuv::RotationMode>(frame.rotation()));
+        return rotated;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "common_video/include/i420_buffer_pool.h"
+#include "TripleBuffer.h"
+
+namespace WebRTC
+{
+    struct RgbaFrame
+    {
+        std::vector<uint8> data;
+        int width = 0;
+        int height = 0;
+        int64 timestampUs = 0;
+    };
+
+    // VideoFrameReceiver is attached to a remote video track and hands its decoded
+    // frames to Unity as tightly packed RGBA32 pixels.
+    // The conversion runs on the decoder thread which calls OnFrame, with the SIMD
+    // row kernels of libyuv, so the rendering thread only uploads the result.
+    // Frames sent with a video orientation are rotated upright first, the published
+    // width and height are those of the rotated frame.
+    class VideoFrameReceiver : public rtc::VideoSinkInterface<webrtc::VideoFrame>
+    {
+    public:
+        VideoFrameReceiver() = default;
+        ~VideoFrameReceiver() override = default;
+
+        //rtc::VideoSinkInterface
+        void OnFrame(const webrtc::VideoFrame& frame) override;
+
+        // Consumer side, must be called from one thread only.
+        // Returns true if a newer frame is available in GetFrame().
+        bool AcquireLatestFrame() { return frames.Update(); }
+        const RgbaFrame& GetFrame() const { return frames.ReadBuffer(); }
+
+        uint64 GetReceivedFrameCount() const { return receivedFrameCount; }
+        // Frames replaced by a newer one before the consumer picked them up.
+        uint64 GetSkippedFrameCount() const { return skippedFrameCount; }
+
+    private:
+        rtc::scoped_refptr<webrtc::I420BufferInterface> Rotate(const webrtc::VideoFrame& frame);
+
+        TripleBuffer<RgbaFrame> frames;
+        //only used by the decoder thread
+        webrtc::I420BufferPool rotatedBuffers;
+        std::atomic<uint64> receivedFrameCount { 0 };
+        std::atomic<uint64> skippedFrameCount { 0 };
+    };
+}
@@ -3,24 +3,13 @@
 #include "PeerConnectionObject.h"
 #include "Context.h"
 #include "Codec/EncoderFactory.h"
+#include "FrameTrace.h"
 
 using namespace WebRTC;
 namespace WebRTC
 {
-    DelegateDebugLog delegateDebugLog = nullptr;
     DelegateSetResolution delegateSetResolution = nullptr;
 
-    void debugLog(const char* buf)
-    {
-        if (delegateDebugLog != nullptr)
-        {
-            if(rtc::ThreadManager::Instance()->IsMainThread())
-            {
-                delegateDebugLog(buf);
-            }
-        }
-    }
-
     void SetResolution(int32* width, int32* length)
     {
         if (delegateSetResolution != nullptr)
@@ -37,6 +26,37 @@ extern "C"
         return context->GetEncoderType();
     }
 
+    UNITY_INTERFACE_EXPORT void ContextSetBitratePolicy(Context* context, BitratePolicy policy)
+    {
+        context->SetBitratePolicy(policy);
+    }
+
+    UNITY_INTERFACE_EXPORT void ContextGetVideoDecoderStats(Context* context, VideoDecoderStats* stats)
+    {
+        *stats = context->GetVideoDecoderStats();
+    }
+
+    //takes the ownership of backend, which has to be allocated with new
+    UNITY_INTERFACE_EXPORT void ContextAddVideoDecoderBackend(Context* context, IHardwareDecoderBackend* backend)
+    {
+        context->AddVideoDecoderBackend(std::unique_ptr<IHardwareDecoderBackend>(backend));
+    }
+
+    UNITY_INTERFACE_EXPORT void ContextStartStatsSampler(Context* context, int32 intervalMs, int32 sampleCount)
+    {
+        context->StartStatsSampler(intervalMs, sampleCount);
+    }
+
+    UNITY_INTERFACE_EXPORT void ContextStopStatsSampler(Context* context)
+    {
+        context->StopStatsSampler();
+    }
+
+    UNITY_INTERFACE_EXPORT int32 ContextGetStatsSamples(Context* context, PeerConnectionObject* obj, StatsSample* samples, int32 capacity)
+    {
+        return context->GetStatsSamples(obj, samples, capacity);
+    }
+
     UNITY_INTERFACE_EXPORT bool GetHardwareEncoderSupport()
     {
         return EncoderFactory::GetHardwareEncoderSupport();
@@ -52,15 +72,29 @@ extern "C"
         return context->CreateVideoStream(rt, width, height);
     }
 
+    UNITY_INTERFACE_EXPORT webrtc::MediaStreamInterface* ContextCreateSimulcastVideoStream(Context* context, void* rt, int32 width, int32 height, int32 simulcastLayers)
+    {
+        return context->CreateVideoStream(rt, width, height, simulcastLayers);
+    }
+
     UNITY_INTERFACE_EXPORT void ContextDeleteVideoStream(Context* context, webrtc::MediaStreamInterface* stream)
     {
         context->DeleteVideoStream(stream);
     }
 
-    //TODO: Multi-track support
     UNITY_INTERFACE_EXPORT void StopMediaStreamTrack(Context* context, webrtc::MediaStreamTrackInterface* track)
     {
-        context->StopCapturer();
+        context->StopCapturer(track);
+    }
+
+    UNITY_INTERFACE_EXPORT bool ContextSetVideoTrackPlayoutDelay(Context* context, webrtc::MediaStreamTrackInterface* track, int32 minMs, int32 maxMs)
+    {
+        return context->SetPlayoutDelay(track, minMs, maxMs);
+    }
+
+    UNITY_INTERFACE_EXPORT bool ContextGetEncoderStats(Context* context, webrtc::MediaStreamTrackInterface* track, int32 layer, EncoderStats* stats)
+    {
+        return context->GetEncoderStats(track, layer, stats);
     }
 
     UNITY_INTERFACE_EXPORT webrtc::MediaStreamInterface* ContextCreateAudioStream(Context* context)
@@ -169,14 +203,45 @@ extern "C"
         track->set_enabled(enabled);
     }
 
-    UNITY_INTERFACE_EXPORT void RegisterDebugLog(DelegateDebugLog func)
+    UNITY_INTERFACE_EXPORT void RegisterSetResolution(DelegateSetResolution func)
     {
-        delegateDebugLog = func;
+        delegateSetResolution = func;
     }
 
-    UNITY_INTERFACE_EXPORT void RegisterSetResolution(DelegateSetResolution func)
+    UNITY_INTERFACE_EXPORT void SetLogLevel(LogLevel level)
     {
-        delegateSetResolution = func;
+        WebRTC::SetLogLevel(level);
+    }
+
+    UNITY_INTERFACE_EXPORT int32 DrainLog(LogRecord* records, int32 capacity)
+    {
+        return WebRTC::DrainLog(records, capacity);
+    }
+
+    UNITY_INTERFACE_EXPORT uint64 GetDroppedLogCount()
+    {
+        return WebRTC::GetDroppedLogCount();
+    }
+
+    UNITY_INTERFACE_EXPORT void SetFrameTraceEnabled(bool enabled)
+    {
+        FrameTrace::SetEnabled(enabled);
+    }
+
+    UNITY_INTERFACE_EXPORT void DumpFrameTrace(int64 windowUs, char** json, int* len)
+    {
+        std::string _json;
+        FrameTrace::Dump(windowUs, _json);
+#pragma warning(suppress: 4267)
+        *len = _json.size();
+        *json = (char*)::CoTaskMemAlloc(_json.size() + sizeof(char));
+        _json.copy(*json, _json.size());
+        (*json)[_json.size()] = '\0';
+    }
+
+    UNITY_INTERFACE_EXPORT void SetNetworkThreadPriority(ThreadPriority priority)
+    {
+        FactoryResources::SetNetworkThreadPriority(priority);
     }
 
     UNITY_INTERFACE_EXPORT Context* ContextCreate(int uid, UnityEncoderType encoderType)
@@ -191,6 +256,19 @@ extern "C"
         return ctx;
     }
 
+    //the context shares its threads and peer connection factory with the other contexts created this way
+    UNITY_INTERFACE_EXPORT Context* ContextCreateWithSharedFactory(int uid, UnityEncoderType encoderType)
+    {
+        auto ctx = ContextManager::GetInstance()->GetContext(uid);
+        if (ctx != nullptr)
+        {
+            DebugLog("Already created context with ID %d", uid);
+            return ctx;
+        }
+        ctx = ContextManager::GetInstance()->CreateContext(uid, encoderType, true);
+        return ctx;
+    }
+
     UNITY_INTERFACE_EXPORT void ContextDestroy(int uid)
     {
         ContextManager::GetInstance()->DestroyContext(uid);
@@ -218,6 +296,34 @@ extern "C"
         return obj->connection->AddTrack(rtc::scoped_refptr <webrtc::MediaStreamTrackInterface>(track), { "unity" }).value().get();
     }
 
+    UNITY_INTERFACE_EXPORT webrtc::RtpSenderInterface* PeerConnectionAddSimulcastTrack(PeerConnectionObject* obj, webrtc::MediaStreamTrackInterface* track, int32 simulcastLayers)
+    {
+        //the capturer can't encode more layers than that, the extra encodings would never be sent
+        if (simulcastLayers < 1 || simulcastLayers > NvVideoCapturer::MaxSimulcastLayers)
+        {
+            DebugError("simulcastLayers must be between 1 and %d", NvVideoCapturer::MaxSimulcastLayers);
+            return nullptr;
+        }
+        //encodings are ordered from the lowest resolution like the layers of NvVideoCapturer
+        webrtc::RtpTransceiverInit init;
+        init.direction = webrtc::RtpTransceiverDirection::kSendOnly;
+        init.stream_ids = { "unity" };
+        for (int i = 0; i < simulcastLayers; i++)
+        {
+            webrtc::RtpEncodingParameters encoding;
+            encoding.rid = std::to_string(i);
+            encoding.scale_resolution_down_by = static_cast<double>(1 << (simulcastLayers - 1 - i));
+            init.send_encodings.push_back(encoding);
+        }
+        auto result = obj->connection->AddTransceiver(rtc::scoped_refptr<webrtc::MediaStreamTrackInterface>(track), init);
+        if (!result.ok())
+        {
+            DebugWarning("AddTransceiver failed %s", result.error().message());
+            return nullptr;
+        }
+        return result.value()->sender().get();
+    }
+
     UNITY_INTERFACE_EXPORT void PeerConnectionRemoveTrack(PeerConnectionObject* obj, webrtc::RtpSenderInterface* sender)
     {
         obj->connection->RemoveTrack(sender);
@@ -254,6 +360,21 @@ extern "C"
         obj->CollectStats();
     }
 
+    UNITY_INTERFACE_EXPORT void PeerConnectionSetStatsFilter(PeerConnectionObject* obj, const StatsFilterEntry* entries, int count)
+    {
+        obj->SetStatsFilter(entries, count);
+    }
+
+    UNITY_INTERFACE_EXPORT void PeerConnectionCollectFilteredStats(PeerConnectionObject* obj)
+    {
+        obj->CollectFilteredStats();
+    }
+
+    UNITY_INTERFACE_EXPORT int PeerConnectionGetFilteredStats(PeerConnectionObject* obj, StatsValue* values, int capacity, int64* reportTimestampUs)
+    {
+        return obj->GetFilteredStats(values, capacity, reportTimestampUs);
+    }
+
     UNITY_INTERFACE_EXPORT void PeerConnectionGetLocalDescription(PeerConnectionObject* obj, RTCSessionDescription* desc)
     {
         obj->GetLocalDescription(*desc);
@@ -338,6 +459,37 @@ extern "C"
         return obj->receiver()->track().get();
     }
 
+    //a negative delay restores the default jitter buffer behaviour
+    UNITY_INTERFACE_EXPORT void RtpTransceiverInterfaceSetJitterBufferMinimumDelay(webrtc::RtpTransceiverInterface* obj, double delaySeconds)
+    {
+        obj->receiver()->SetJitterBufferMinimumDelay(
+            delaySeconds < 0 ? absl::nullopt : absl::optional<double>(delaySeconds));
+    }
+
+    UNITY_INTERFACE_EXPORT VideoFrameReceiver* ContextCreateVideoReceiver(Context* context, webrtc::MediaStreamTrackInterface* track)
+    {
+        return context->CreateVideoReceiver(track);
+    }
+
+    UNITY_INTERFACE_EXPORT void ContextDeleteVideoReceiver(Context* context, VideoFrameReceiver* receiver)
+    {
+        context->DeleteVideoReceiver(receiver);
+    }
+
+    //returns the RGBA32 pixels of the newest frame, or nullptr if no frame arrived since the last call.
+    //the pixels stay valid until the next call.
+    UNITY_INTERFACE_EXPORT const uint8* VideoReceiverAcquireFrame(VideoFrameReceiver* receiver, int32* width, int32* height)
+    {
+        if (!receiver->AcquireLatestFrame())
+        {
+            return nullptr;
+        }
+        const RgbaFrame& frame = receiver->GetFrame();
+        *width = frame.width;
+        *height = frame.height;
+        return frame.data.data();
+    }
+
     UNITY_INTERFACE_EXPORT int DataChannelGetID(DataChannelObject* dataChannelObj)
     {
         return dataChannelObj->GetID();
@@ -362,6 +514,74 @@ extern "C"
         dataChannelObj->Send(msg, len);
     }
 
+    UNITY_INTERFACE_EXPORT int DataChannelSendBatch(DataChannelObject* dataChannelObj, const byte* data, int size, const int* offsets, int count)
+    {
+        return dataChannelObj->Send(data, size, offsets, count);
+    }
+
+    UNITY_INTERFACE_EXPORT DataChannelBuffer* DataChannelAcquireBuffer(DataChannelObject* dataChannelObj, int capacity, byte** data)
+    {
+        DataChannelBuffer* buffer = dataChannelObj->AcquireBuffer(capacity);
+        *data = buffer != nullptr ? buffer->data.data() + buffer->offset : nullptr;
+        return buffer;
+    }
+
+    UNITY_INTERFACE_EXPORT bool DataChannelSendBuffer(DataChannelObject* dataChannelObj, DataChannelBuffer* buffer, int size)
+    {
+        return dataChannelObj->Send(buffer, size);
+    }
+
+    UNITY_INTERFACE_EXPORT void DataChannelReleaseBuffer(DataChannelObject* dataChannelObj, DataChannelBuffer* buffer)
+    {
+        dataChannelObj->ReleaseBuffer(buffer);
+    }
+
+    UNITY_INTERFACE_EXPORT bool DataChannelTrySendBinary(DataChannelObject* dataChannelObj, const byte* msg, int len)
+    {
+        return dataChannelObj->TrySend(msg, len);
+    }
+
+    UNITY_INTERFACE_EXPORT uint64 DataChannelGetBufferedAmount(DataChannelObject* dataChannelObj)
+    {
+        return dataChannelObj->GetBufferedAmount();
+    }
+
+    UNITY_INTERFACE_EXPORT void DataChannelSetBufferedAmountThresholds(DataChannelObject* dataChannelObj, uint64 low, uint64 high)
+    {
+        dataChannelObj->SetBufferedAmountLowThreshold(low);
+        dataChannelObj->SetBufferedAmountHighThreshold(high);
+    }
+
+    UNITY_INTERFACE_EXPORT bool DataChannelPollBufferedAmountLow(DataChannelObject* dataChannelObj)
+    {
+        return dataChannelObj->PollBufferedAmountLow();
+    }
+
+    UNITY_INTERFACE_EXPORT bool DataChannelEnableChunking(DataChannelObject* dataChannelObj, int chunkSize)
+    {
+        return chunkSize > 0 && dataChannelObj->EnableChunking(chunkSize);
+    }
+
+    UNITY_INTERFACE_EXPORT uint64 DataChannelGetPendingChunkedSize(DataChannelObject* dataChannelObj)
+    {
+        return dataChannelObj->GetPendingChunkedSize();
+    }
+
+    UNITY_INTERFACE_EXPORT bool DataChannelEnableReceiveQueue(DataChannelObject* dataChannelObj, int capacity)
+    {
+        return capacity > 0 && dataChannelObj->EnableReceiveQueue(capacity);
+    }
+
+    UNITY_INTERFACE_EXPORT int DataChannelReceiveMessages(DataChannelObject* dataChannelObj, byte* data, int size, int* sizes, int count)
+    {
+        return dataChannelObj->ReceiveMessages(data, size, sizes, count);
+    }
+
+    UNITY_INTERFACE_EXPORT int DataChannelGetNextMessageSize(DataChannelObject* dataChannelObj)
+    {
+        return dataChannelObj->GetNextMessageSize();
+    }
+
     UNITY_INTERFACE_EXPORT void DataChannelClose(DataChannelObject* dataChannelObj)
     {
         dataChannelObj->Close();
@@ -382,18 +602,48 @@ extern "C"
         dataChannelObj->RegisterOnClose(callback);
     }
 
+    UNITY_INTERFACE_EXPORT void DataChannelRegisterOnBufferedAmountLow(DataChannelObject* dataChannelObj, DelegateOnBufferedAmountLow callback)
+    {
+        dataChannelObj->RegisterOnBufferedAmountLow(callback);
+    }
+
     UNITY_INTERFACE_EXPORT void SetCurrentContext(Context* context)
     {
         ContextManager::GetInstance()->curContext = context;
     }
 
-    UNITY_INTERFACE_EXPORT void ProcessAudio(float* data, int32 size)
+    UNITY_INTERFACE_EXPORT void ProcessAudio(float* data, int32 size, int32 sampleRate, int32 channels)
     {
         if (ContextManager::GetInstance()->curContext)
         {
-            ContextManager::GetInstance()->curContext->ProcessAudioData(data, size);
+            ContextManager::GetInstance()->curContext->ProcessAudioData(nullptr, data, size, sampleRate, channels);
         }
     }
+
+    UNITY_INTERFACE_EXPORT void ContextProcessAudio(Context* context, webrtc::MediaStreamTrackInterface* track, float* data, int32 size, int32 sampleRate, int32 channels)
+    {
+        context->ProcessAudioData(track, data, size, sampleRate, channels);
+    }
+
+    UNITY_INTERFACE_EXPORT void ContextSetAudioTrackOpusSettings(Context* context, webrtc::MediaStreamTrackInterface* track, const OpusSettings* settings)
+    {
+        context->SetOpusSettings(track, *settings);
+    }
+
+    UNITY_INTERFACE_EXPORT void ContextSetAudioPacing(Context* context, bool enable)
+    {
+        context->SetAudioPacing(enable);
+    }
+
+    UNITY_INTERFACE_EXPORT bool ContextGetAudioCaptureStats(Context* context, webrtc::MediaStreamTrackInterface* track, AudioCaptureStats* stats)
+    {
+        return context->GetAudioCaptureStats(track, stats);
+    }
+
+    UNITY_INTERFACE_EXPORT int32 ContextReadAudioPlayout(Context* context, float* data, int32 size, int32 sampleRate, int32 channels)
+    {
+        return context->ReadAudioPlayoutData(data, size, sampleRate, channels);
+    }
 }
 
 
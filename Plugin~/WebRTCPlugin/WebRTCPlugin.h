@@ -10,14 +10,11 @@ namespace WebRTC
     struct RTCError;
     struct MediaStreamEvent;
 
-    using DelegateDebugLog = void(*)(const char*);
     using DelegateSetResolution = void(*)(int32*, int32*);
     using DelegateRTCPeerConnectionOnTrack = void(*)();
     using DelegateRTCPeerConnectionOnConnectionStateChange = void(*)();
 
-    void debugLog(const char* buf);
     void SetResolution(int32* width, int32* length);
-    extern DelegateDebugLog delegateDebugLog;
 
     enum class RTCPeerConnectionState
     {
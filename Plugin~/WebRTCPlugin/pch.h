@@ -31,6 +31,7 @@
 #include "rtc_base/third_party/sigslot/sigslot.h"
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/async_tcp_socket.h"
+#include "rtc_base/helpers.h"
 
 #ifdef _WIN32
 #include "rtc_base/win32.h"
@@ -55,6 +56,9 @@
 
 #include "common_video/h264/h264_bitstream_parser.h"
 #include "common_video/h264/h264_common.h"
+#include "common_video/libyuv/include/webrtc_libyuv.h"
+
+#include "system_wrappers/include/clock.h"
 
 #include "media/base/video_broadcaster.h"
 #pragma endregion
@@ -95,9 +99,9 @@ namespace WebRTC
     void LogPrint(const char* fmt, ...);
     void LogPrint(const wchar_t* fmt, ...);
     void checkf(bool result, const char* msg);
-#define DebugLog(...)       LogPrint("webrtc Log: " __VA_ARGS__)
-#define DebugWarning(...)   LogPrint("webrtc Warning: " __VA_ARGS__)
-#define DebugError(...)     LogPrint("webrtc Error: "  __VA_ARGS__)
+#define DebugLog(...)       WEBRTC_LOG(::WebRTC::LogLevel::Info, "webrtc Log: " __VA_ARGS__)
+#define DebugWarning(...)   WEBRTC_LOG(::WebRTC::LogLevel::Warning, "webrtc Warning: " __VA_ARGS__)
+#define DebugError(...)     WEBRTC_LOG(::WebRTC::LogLevel::Error, "webrtc Error: "  __VA_ARGS__)
 #define DebugLogW(...)      LogPrint(L"webrtc Log: " __VA_ARGS__)
 #define DebugWarningW(...)  LogPrint(L"webrtc Warning: " __VA_ARGS__)
 #define DebugErrorW(...)    LogPrint(L"webrtc Error: "  __VA_ARGS__)
@@ -138,3 +142,5 @@ namespace WebRTC
         UnityEncoderHardware = 1,
     };
 }
+
+#include "Logger.h"
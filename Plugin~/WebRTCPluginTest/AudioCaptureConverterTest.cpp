@@ -0,0 +1,110 @@
+#include "pch.h"
+#include "../WebRTCPlugin/AudioCaptureConverter.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    const int OutputSampleRate = 48000;
+    const int OutputChannels = 2;
+    const size_t OutputBlockSize = OutputSampleRate / 100 * OutputChannels;
+    const float Pi = 3.14159265f;
+
+    std::vector<float> CreateTone(int sampleRate, int channels, float frequency, size_t frames)
+    {
+        std::vector<float> samples(frames * channels);
+        for (size_t i = 0; i < frames; i++)
+        {
+            const float value = 0.5f * std::sin(2.0f * Pi * frequency * i / sampleRate);
+            std::fill_n(samples.begin() + i * channels, channels, value);
+        }
+        return samples;
+    }
+
+    //rising zero crossings of the left channel
+    int CountPeriods(const std::vector<float>& samples, int channels)
+    {
+        int count = 0;
+        for (size_t i = channels; i < samples.size(); i += channels)
+        {
+            if (samples[i - channels] < 0.0f && samples[i] >= 0.0f)
+                count++;
+        }
+        return count;
+    }
+}
+
+TEST(AudioCaptureConverterTest, SupportedFormats) {
+    EXPECT_TRUE(AudioCaptureConverter::IsSupportedFormat(44100, 2));
+    EXPECT_TRUE(AudioCaptureConverter::IsSupportedFormat(48000, 6));
+    EXPECT_TRUE(AudioCaptureConverter::IsSupportedFormat(96000, 8));
+    EXPECT_FALSE(AudioCaptureConverter::IsSupportedFormat(22050, 2));
+    EXPECT_FALSE(AudioCaptureConverter::IsSupportedFormat(48000, 0));
+    EXPECT_FALSE(AudioCaptureConverter::IsSupportedFormat(48000, 9));
+
+    AudioCaptureConverter converter(OutputSampleRate, OutputChannels);
+    const float data[4] = {};
+    EXPECT_FALSE(converter.Process(data, 4, 22050, 2, [](const float*, size_t) { FAIL(); }));
+}
+
+TEST(AudioCaptureConverterTest, MixChannels) {
+    //FL FR FC LFE SL SR
+    const float surround[6] = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+    float stereo[2];
+    AudioCaptureConverter::MixChannels(surround, 6, stereo, 2, 1);
+    EXPECT_GT(stereo[0], 0.0f);
+    //the LFE doesn't leak into the front channels
+    EXPECT_FLOAT_EQ(0.0f, stereo[1]);
+
+    //a centered source stays centered and within range
+    const float center[6] = { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f };
+    AudioCaptureConverter::MixChannels(center, 6, stereo, 2, 1);
+    EXPECT_FLOAT_EQ(stereo[0], stereo[1]);
+    EXPECT_LE(stereo[0], 1.0f);
+
+    //FL FR FC BL BR, both surround channels reach their side
+    const float backLeft[5] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+    AudioCaptureConverter::MixChannels(backLeft, 5, stereo, 2, 1);
+    EXPECT_GT(stereo[0], 0.0f);
+    EXPECT_FLOAT_EQ(0.0f, stereo[1]);
+    const float backRight[5] = { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+    float mirrored[2];
+    AudioCaptureConverter::MixChannels(backRight, 5, mirrored, 2, 1);
+    EXPECT_FLOAT_EQ(0.0f, mirrored[0]);
+    EXPECT_FLOAT_EQ(stereo[0], mirrored[1]);
+
+    const float mono[2] = { 0.25f, -0.5f };
+    float upmixed[4];
+    AudioCaptureConverter::MixChannels(mono, 1, upmixed, 2, 2);
+    EXPECT_FLOAT_EQ(0.25f, upmixed[0]);
+    EXPECT_FLOAT_EQ(0.25f, upmixed[1]);
+    EXPECT_FLOAT_EQ(-0.5f, upmixed[2]);
+    EXPECT_FLOAT_EQ(-0.5f, upmixed[3]);
+}
+
+TEST(AudioCaptureConverterTest, ResampleKeepsPitch) {
+    const int inputSampleRate = 44100;
+    const int inputChannels = 6;
+    const float frequency = 441.0f;
+    //one second delivered in Unity sized callbacks, which don't line up with 10ms blocks
+    const std::vector<float> tone = CreateTone(inputSampleRate, inputChannels, frequency, inputSampleRate);
+    const size_t callbackSize = 1024 * inputChannels;
+
+    AudioCaptureConverter converter(OutputSampleRate, OutputChannels);
+    std::vector<float> output;
+    for (size_t offset = 0; offset < tone.size(); offset += callbackSize)
+    {
+        const size_t size = std::min(callbackSize, tone.size() - offset);
+        EXPECT_TRUE(converter.Process(tone.data() + offset, size, inputSampleRate, inputChannels,
+            [&output](const float* block, size_t blockSize)
+        {
+            EXPECT_EQ(OutputBlockSize, blockSize);
+            output.insert(output.end(), block, block + blockSize);
+        }));
+    }
+    EXPECT_EQ(inputSampleRate, converter.GetInputSampleRate());
+    EXPECT_EQ(inputChannels, converter.GetInputChannels());
+    ASSERT_EQ(OutputBlockSize * 100, output.size());
+    //pitch shifted audio would show up as a different number of periods per second
+    EXPECT_NEAR(frequency, CountPeriods(output, OutputChannels), 2);
+}
@@ -0,0 +1,47 @@
+#include "pch.h"
+#include "../WebRTCPlugin/AudioPlayoutSink.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    const size_t FramesPerChunk = 480;
+    const int16 Level = 8192;
+}
+
+TEST(AudioPlayoutSinkTest, MixStereo) {
+    AudioPlayoutSink sink;
+    const std::vector<int16> chunk(FramesPerChunk * 2, Level);
+    sink.OnData(chunk.data(), 16, 48000, 2, FramesPerChunk);
+
+    //the sink adds to what is already there
+    std::vector<float> mix(FramesPerChunk * 4, 0.25f);
+    EXPECT_EQ(FramesPerChunk * 2, sink.MixInto(mix.data(), mix.size()));
+    for (size_t i = 0; i < FramesPerChunk * 2; i++)
+    {
+        EXPECT_FLOAT_EQ(0.25f + Level / 32768.0f, mix[i]);
+    }
+    EXPECT_FLOAT_EQ(0.25f, mix.back());
+    EXPECT_EQ(0u, sink.MixInto(mix.data(), mix.size()));
+}
+
+TEST(AudioPlayoutSinkTest, ConvertMono) {
+    AudioPlayoutSink sink;
+    const std::vector<int16> chunk(FramesPerChunk, Level);
+    sink.OnData(chunk.data(), 16, 48000, 1, FramesPerChunk);
+
+    std::vector<float> mix(FramesPerChunk * 2, 0.0f);
+    EXPECT_EQ(FramesPerChunk * 2, sink.MixInto(mix.data(), mix.size()));
+    for (float sample : mix)
+    {
+        EXPECT_FLOAT_EQ(Level / 32768.0f, sample);
+    }
+}
+
+TEST(AudioPlayoutSinkTest, IgnoreOtherSampleFormats) {
+    AudioPlayoutSink sink;
+    const std::vector<uint8> chunk(FramesPerChunk * 2, 0x40);
+    sink.OnData(chunk.data(), 8, 48000, 2, FramesPerChunk);
+    std::vector<float> mix(FramesPerChunk * 2, 0.0f);
+    EXPECT_EQ(0u, sink.MixInto(mix.data(), mix.size()));
+}
@@ -0,0 +1,211 @@
+#include "pch.h"
+#include "../WebRTCPlugin/AudioRingBuffer.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    const size_t ChunkSize = 960;
+
+    std::vector<float> CreateSignal(size_t count)
+    {
+        std::vector<float> samples(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            samples[i] = std::sin(static_cast<float>(i) * 0.01f) * 0.8f;
+        }
+        return samples;
+    }
+
+    //the implementation DummyAudioDevice used before the ring buffer, kept as the benchmark baseline
+    class LegacyRecordingBuffer
+    {
+    public:
+        template<typename Deliver>
+        void Process(const float* data, size_t size, Deliver deliver)
+        {
+            for (size_t i = 0; i < size; i++)
+            {
+                convertedAudioData.push_back(static_cast<int16>(data[i] >= 0 ? data[i] * SHRT_MAX : data[i] * -SHRT_MIN));
+            }
+            while (convertedAudioData.size() > ChunkSize)
+            {
+                deliver(convertedAudioData.data());
+                convertedAudioData.erase(convertedAudioData.begin(), convertedAudioData.begin() + ChunkSize);
+            }
+        }
+    private:
+        std::vector<int16> convertedAudioData;
+    };
+}
+
+TEST(AudioRingBufferTest, ConvertFloatToInt16Saturates) {
+    //long enough to go through both the vectorized loop and the scalar tail
+    const float src[] = { 0.0f, 0.5f, -0.5f, 1.0f, -1.0f, 2.0f, -2.0f, 1e10f, -1e10f, 0.25f, -0.25f };
+    const size_t count = sizeof(src) / sizeof(src[0]);
+    int16 dst[count];
+    ConvertFloatToInt16(src, dst, count);
+    EXPECT_EQ(0, dst[0]);
+    EXPECT_EQ(16384, dst[1]);
+    EXPECT_EQ(-16384, dst[2]);
+    EXPECT_EQ(SHRT_MAX, dst[3]);
+    EXPECT_EQ(SHRT_MIN, dst[4]);
+    EXPECT_EQ(SHRT_MAX, dst[5]);
+    EXPECT_EQ(SHRT_MIN, dst[6]);
+    EXPECT_EQ(SHRT_MAX, dst[7]);
+    EXPECT_EQ(SHRT_MIN, dst[8]);
+    EXPECT_EQ(8192, dst[9]);
+    EXPECT_EQ(-8192, dst[10]);
+}
+
+TEST(AudioRingBufferTest, ConvertFloatToInt16Rounds) {
+    const float step = 1.0f / 32768.0f;
+    const float src[] = { 0.7f * step, -0.7f * step, 0.3f * step, -0.3f * step, 100.6f * step, -100.6f * step, 100.4f * step, -100.4f * step };
+    const int16 expected[] = { 1, -1, 0, 0, 101, -101, 100, -100 };
+    const size_t count = sizeof(src) / sizeof(src[0]);
+    //all at once goes through the vectorized loop, one by one through the scalar tail
+    int16 vectorized[count];
+    ConvertFloatToInt16(src, vectorized, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        int16 scalar;
+        ConvertFloatToInt16(src + i, &scalar, 1);
+        EXPECT_EQ(expected[i], vectorized[i]) << i;
+        EXPECT_EQ(expected[i], scalar) << i;
+    }
+}
+
+TEST(AudioRingBufferTest, ChunksAreReadInPlace) {
+    AudioRingBuffer buffer(ChunkSize * 4);
+    EXPECT_EQ(nullptr, buffer.Peek(ChunkSize));
+
+    const std::vector<float> signal = CreateSignal(ChunkSize * 2 + 100);
+    EXPECT_EQ(signal.size(), buffer.Write(signal.data(), signal.size()));
+    EXPECT_EQ(signal.size(), buffer.GetReadableSize());
+
+    std::vector<int16> expected(signal.size());
+    ConvertFloatToInt16(signal.data(), expected.data(), signal.size());
+    for (size_t offset = 0; offset < ChunkSize * 2; offset += ChunkSize)
+    {
+        const int16* chunk = buffer.Peek(ChunkSize);
+        ASSERT_NE(nullptr, chunk);
+        EXPECT_TRUE(std::equal(chunk, chunk + ChunkSize, expected.begin() + offset));
+        buffer.Consume(ChunkSize);
+    }
+    EXPECT_EQ(nullptr, buffer.Peek(ChunkSize));
+    EXPECT_EQ(100u, buffer.GetReadableSize());
+}
+
+TEST(AudioRingBufferTest, WrapAroundAndOverflow) {
+    AudioRingBuffer buffer(ChunkSize * 2);
+    const std::vector<float> signal = CreateSignal(ChunkSize * 3 + 10);
+    std::vector<int16> expected(signal.size());
+    ConvertFloatToInt16(signal.data(), expected.data(), signal.size());
+
+    //a full ring drops what doesn't fit
+    EXPECT_EQ(ChunkSize * 2, buffer.Write(signal.data(), ChunkSize * 3));
+    EXPECT_EQ(ChunkSize, buffer.GetDroppedSampleCount());
+
+    //a chunk which is not aligned to the capacity wraps around the end of the ring
+    buffer.Consume(ChunkSize + 10);
+    EXPECT_EQ(ChunkSize + 10, buffer.Write(signal.data() + ChunkSize * 2, ChunkSize + 10));
+    const int16* chunk = buffer.Peek(ChunkSize);
+    ASSERT_NE(nullptr, chunk);
+    EXPECT_TRUE(std::equal(chunk, chunk + ChunkSize, expected.begin() + ChunkSize + 10));
+
+    buffer.Clear();
+    EXPECT_EQ(0u, buffer.GetReadableSize());
+}
+
+TEST(AudioRingBufferTest, ReadAnyBlockSize) {
+    AudioRingBuffer buffer(ChunkSize * 2);
+    std::vector<int16> chunk(ChunkSize);
+    for (size_t i = 0; i < chunk.size(); i++)
+    {
+        chunk[i] = static_cast<int16>(i * 16);
+    }
+    size_t written = 0;
+
+    //the reader's block size has nothing to do with the chunk size and wraps around the ring
+    std::vector<float> block(700);
+    size_t total = 0;
+    do
+    {
+        while (written < ChunkSize * 6 && buffer.GetReadableSize() + ChunkSize <= buffer.GetCapacity())
+        {
+            written += buffer.Write(chunk.data(), chunk.size());
+        }
+        const size_t read = buffer.Read(block.data(), block.size());
+        for (size_t i = 0; i < read; i++)
+        {
+            EXPECT_FLOAT_EQ(chunk[(total + i) % ChunkSize] / 32768.0f, block[i]);
+        }
+        total += read;
+    } while (buffer.GetReadableSize() > 0);
+    EXPECT_EQ(ChunkSize * 6, total);
+}
+
+TEST(AudioRingBufferTest, ConcurrentProducerAndConsumer) {
+    AudioRingBuffer buffer(ChunkSize * 8);
+    const size_t blockSize = 1024;
+    const size_t blocks = 200;
+    const std::vector<float> signal = CreateSignal(blockSize * blocks);
+    std::vector<int16> expected(signal.size());
+    ConvertFloatToInt16(signal.data(), expected.data(), signal.size());
+
+    std::thread producer([&]()
+    {
+        for (size_t offset = 0; offset < signal.size();)
+        {
+            offset += buffer.Write(signal.data() + offset, std::min(blockSize, signal.size() - offset));
+            std::this_thread::yield();
+        }
+    });
+    size_t received = 0;
+    while (received + ChunkSize <= signal.size())
+    {
+        if (const int16* chunk = buffer.Peek(ChunkSize))
+        {
+            ASSERT_TRUE(std::equal(chunk, chunk + ChunkSize, expected.begin() + received));
+            buffer.Consume(ChunkSize);
+            received += ChunkSize;
+        }
+    }
+    producer.join();
+}
+
+//a benchmark, run it with --gtest_also_run_disabled_tests
+TEST(AudioRingBufferTest, DISABLED_BenchmarkAgainstLegacyBuffer) {
+    //a Unity audio callback delivers 1024 stereo frames, run about a minute of audio through both
+    const size_t callbackSize = 2048;
+    const int iterations = 2800;
+    const std::vector<float> signal = CreateSignal(callbackSize);
+    int64 sink = 0;
+
+    LegacyRecordingBuffer legacy;
+    const int64 legacyStart = rtc::TimeMicros();
+    for (int i = 0; i < iterations; i++)
+    {
+        legacy.Process(signal.data(), signal.size(), [&sink](const int16* chunk) { sink += chunk[0]; });
+    }
+    const int64 legacyUs = rtc::TimeMicros() - legacyStart;
+
+    AudioRingBuffer buffer(ChunkSize * 16);
+    const int64 ringStart = rtc::TimeMicros();
+    for (int i = 0; i < iterations; i++)
+    {
+        buffer.Write(signal.data(), signal.size());
+        while (const int16* chunk = buffer.Peek(ChunkSize))
+        {
+            sink += chunk[0];
+            buffer.Consume(ChunkSize);
+        }
+    }
+    const int64 ringUs = rtc::TimeMicros() - ringStart;
+
+    EXPECT_EQ(0u, buffer.GetDroppedSampleCount());
+    RecordProperty("LegacyUs", static_cast<int>(legacyUs));
+    RecordProperty("RingBufferUs", static_cast<int>(ringUs));
+    //keeps the loops from being optimized away
+    RecordProperty("Checksum", static_cast<int>(sink));
+}
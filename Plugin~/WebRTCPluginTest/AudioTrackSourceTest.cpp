@@ -0,0 +1,153 @@
+#include "pch.h"
+#include "../WebRTCPlugin/AudioTrackSource.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    class FakeAudioSink : public webrtc::AudioTrackSinkInterface
+    {
+    public:
+        void OnData(const void* audio_data, int bits_per_sample, int sample_rate,
+            size_t number_of_channels, size_t number_of_frames) override
+        {
+            EXPECT_EQ(16, bits_per_sample);
+            EXPECT_EQ(48000, sample_rate);
+            EXPECT_EQ(2u, number_of_channels);
+            frames += number_of_frames;
+            lastSample = static_cast<const int16*>(audio_data)[0];
+        }
+        size_t frames = 0;
+        int16 lastSample = 0;
+    };
+}
+
+class AudioTrackSourceTest : public testing::Test
+{
+protected:
+    //pushes audio as an application whose audio clock runs driftPpm faster than the pacer
+    void RunPaced(int ticks, double driftPpm)
+    {
+        const double framesPerTick = 480.0 * (1.0 + driftPpm / 1e6);
+        double due = 0;
+        std::vector<float> data;
+        for (int i = 0; i < ticks; i++)
+        {
+            due += framesPerTick;
+            const size_t frames = static_cast<size_t>(due);
+            due -= frames;
+            data.assign(frames * 2, 0.1f);
+            source->ProcessAudioData(data.data(), static_cast<int32>(data.size()), 48000, 2);
+            source->DeliverPacedAudio();
+        }
+    }
+
+    rtc::scoped_refptr<AudioTrackSource> source = AudioTrackSource::Create(cricket::AudioOptions());
+    FakeAudioSink sink;
+};
+
+TEST_F(AudioTrackSourceTest, DeliverTenMillisecondChunks) {
+    EXPECT_EQ(webrtc::MediaSourceInterface::kLive, source->state());
+    EXPECT_FALSE(source->remote());
+    source->AddSink(&sink);
+
+    //Unity sized callback of 48kHz stereo, the remainder stays buffered
+    std::vector<float> data(2048, 0.5f);
+    source->ProcessAudioData(data.data(), static_cast<int32>(data.size()), 48000, 2);
+    EXPECT_EQ(960u, sink.frames);
+    EXPECT_EQ(16384, sink.lastSample);
+
+    source->RemoveSink(&sink);
+    source->ProcessAudioData(data.data(), static_cast<int32>(data.size()), 48000, 2);
+    EXPECT_EQ(960u, sink.frames);
+}
+
+TEST_F(AudioTrackSourceTest, ResampleInput) {
+    source->AddSink(&sink);
+    //100ms of 44.1kHz mono
+    std::vector<float> data(4410, 0.25f);
+    source->ProcessAudioData(data.data(), static_cast<int32>(data.size()), 44100, 1);
+    EXPECT_EQ(4800u, sink.frames);
+    source->RemoveSink(&sink);
+}
+
+TEST_F(AudioTrackSourceTest, SourcesAreIndependent) {
+    rtc::scoped_refptr<AudioTrackSource> other = AudioTrackSource::Create(cricket::AudioOptions());
+    FakeAudioSink otherSink;
+    source->AddSink(&sink);
+    other->AddSink(&otherSink);
+
+    std::vector<float> data(960, 0.5f);
+    source->ProcessAudioData(data.data(), static_cast<int32>(data.size()), 48000, 2);
+    EXPECT_EQ(480u, sink.frames);
+    EXPECT_EQ(0u, otherSink.frames);
+
+    source->RemoveSink(&sink);
+    other->RemoveSink(&otherSink);
+}
+
+TEST_F(AudioTrackSourceTest, PacedDeliveryWaitsForTargetLevel) {
+    source->AddSink(&sink);
+    source->EnablePacing(true);
+
+    //20ms is below the target level, nothing is delivered yet
+    std::vector<float> data(1920, 0.5f);
+    source->ProcessAudioData(data.data(), static_cast<int32>(data.size()), 48000, 2);
+    source->DeliverPacedAudio();
+    EXPECT_EQ(0u, sink.frames);
+    EXPECT_DOUBLE_EQ(20.0, source->GetCaptureStats().fillLevelMs);
+
+    source->ProcessAudioData(data.data(), static_cast<int32>(data.size()), 48000, 2);
+    source->DeliverPacedAudio();
+    EXPECT_EQ(480u, sink.frames);
+    const AudioCaptureStats stats = source->GetCaptureStats();
+    EXPECT_DOUBLE_EQ(40.0, stats.fillLevelMs);
+    EXPECT_DOUBLE_EQ(30.0, stats.targetFillLevelMs);
+    source->RemoveSink(&sink);
+}
+
+TEST_F(AudioTrackSourceTest, PacedUnderrunAndOverrun) {
+    source->AddSink(&sink);
+    source->EnablePacing(true);
+
+    //more than the 160ms the buffer holds
+    std::vector<float> data(48000 * 2 / 5, 0.5f);
+    source->ProcessAudioData(data.data(), static_cast<int32>(data.size()), 48000, 2);
+    EXPECT_EQ(48000u * 2 / 5 - 960 * 16, source->GetCaptureStats().overrunSamples);
+
+    //drain it without pushing anything
+    for (int i = 0; i < 20; i++)
+    {
+        source->DeliverPacedAudio();
+    }
+    EXPECT_LT(0u, source->GetCaptureStats().underrunSamples);
+    //delivery stops until the buffer is filled to the target again
+    const size_t frames = sink.frames;
+    source->DeliverPacedAudio();
+    EXPECT_EQ(frames, sink.frames);
+    source->RemoveSink(&sink);
+}
+
+TEST_F(AudioTrackSourceTest, CompensateFastClock) {
+    source->AddSink(&sink);
+    source->EnablePacing(true);
+    //a minute of audio from a clock 2000ppm fast would pile up 120ms
+    RunPaced(6000, 2000);
+    const AudioCaptureStats stats = source->GetCaptureStats();
+    EXPECT_NEAR(stats.targetFillLevelMs, stats.fillLevelMs, 10.0);
+    EXPECT_NEAR(2000.0, stats.rateAdjustmentPpm, 500.0);
+    EXPECT_EQ(0u, stats.overrunSamples);
+    EXPECT_EQ(0u, stats.underrunSamples);
+    source->RemoveSink(&sink);
+}
+
+TEST_F(AudioTrackSourceTest, CompensateSlowClock) {
+    source->AddSink(&sink);
+    source->EnablePacing(true);
+    RunPaced(6000, -2000);
+    const AudioCaptureStats stats = source->GetCaptureStats();
+    EXPECT_NEAR(stats.targetFillLevelMs, stats.fillLevelMs, 10.0);
+    EXPECT_NEAR(-2000.0, stats.rateAdjustmentPpm, 500.0);
+    EXPECT_EQ(0u, stats.underrunSamples);
+    source->RemoveSink(&sink);
+}
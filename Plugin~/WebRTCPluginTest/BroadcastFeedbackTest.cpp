@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "../WebRTCPlugin/BroadcastFeedback.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    //opaque subscriber ids, only their addresses matter
+    const int subscribers[4] = {};
+}
+
+TEST(BroadcastFeedbackTest, LatestRateWinsByDefault) {
+    BroadcastFeedback feedback;
+    EXPECT_EQ(BitratePolicy::Latest, feedback.GetPolicy());
+    EXPECT_EQ(0u, feedback.GetTargetBitrate(0));
+    feedback.SetBitrate(&subscribers[0], 0, 1000000);
+    feedback.SetBitrate(&subscribers[1], 0, 300000);
+    EXPECT_EQ(300000u, feedback.GetTargetBitrate(0));
+    EXPECT_EQ(2u, feedback.GetSubscriberCount());
+}
+
+TEST(BroadcastFeedbackTest, MinimumPolicy) {
+    BroadcastFeedback feedback;
+    feedback.SetPolicy(BitratePolicy::Minimum);
+    feedback.SetBitrate(&subscribers[0], 0, 1000000);
+    feedback.SetBitrate(&subscribers[1], 0, 300000);
+    feedback.SetBitrate(&subscribers[2], 0, 2000000);
+    //a subscriber which doesn't use the layer doesn't hold it down
+    feedback.SetBitrate(&subscribers[3], 0, 0);
+    EXPECT_EQ(300000u, feedback.GetTargetBitrate(0));
+
+    feedback.RemoveSubscriber(&subscribers[1]);
+    EXPECT_EQ(1000000u, feedback.GetTargetBitrate(0));
+}
+
+TEST(BroadcastFeedbackTest, MedianPolicy) {
+    BroadcastFeedback feedback;
+    feedback.SetPolicy(BitratePolicy::Median);
+    feedback.SetBitrate(&subscribers[0], 0, 1000000);
+    feedback.SetBitrate(&subscribers[1], 0, 300000);
+    feedback.SetBitrate(&subscribers[2], 0, 2000000);
+    EXPECT_EQ(1000000u, feedback.GetTargetBitrate(0));
+    feedback.SetBitrate(&subscribers[3], 0, 500000);
+    EXPECT_EQ(500000u, feedback.GetTargetBitrate(0));
+}
+
+TEST(BroadcastFeedbackTest, PerLayerPolicy) {
+    BroadcastFeedback feedback;
+    feedback.SetPolicy(BitratePolicy::PerLayer);
+    //a congested spectator only receives the low layer
+    feedback.SetBitrate(&subscribers[0], 0, 150000);
+    feedback.SetBitrate(&subscribers[0], 1, 0);
+    //the others receive both layers
+    feedback.SetBitrate(&subscribers[1], 0, 200000);
+    feedback.SetBitrate(&subscribers[1], 1, 2000000);
+    feedback.SetBitrate(&subscribers[2], 0, 300000);
+    feedback.SetBitrate(&subscribers[2], 1, 1500000);
+    EXPECT_EQ(150000u, feedback.GetTargetBitrate(0));
+    EXPECT_EQ(1500000u, feedback.GetTargetBitrate(1));
+
+    //nobody tops out at the low layer anymore, fall back to the lowest request
+    feedback.RemoveSubscriber(&subscribers[0]);
+    EXPECT_EQ(200000u, feedback.GetTargetBitrate(0));
+}
+
+TEST(BroadcastFeedbackTest, CoalesceKeyFrameRequests) {
+    BroadcastFeedback feedback(500);
+    EXPECT_FALSE(feedback.ShouldEncodeKeyFrame(0));
+
+    //the first request is served on the next frame
+    feedback.RequestKeyFrame();
+    EXPECT_TRUE(feedback.ShouldEncodeKeyFrame(0));
+    EXPECT_FALSE(feedback.ShouldEncodeKeyFrame(16));
+
+    //requests within the interval wait for a single key frame
+    for (int i = 0; i < 10; i++)
+    {
+        feedback.RequestKeyFrame();
+    }
+    EXPECT_FALSE(feedback.ShouldEncodeKeyFrame(100));
+    EXPECT_FALSE(feedback.ShouldEncodeKeyFrame(499));
+    EXPECT_TRUE(feedback.ShouldEncodeKeyFrame(500));
+    EXPECT_FALSE(feedback.ShouldEncodeKeyFrame(516));
+    EXPECT_EQ(9u, feedback.GetCoalescedKeyFrameRequestCount());
+}
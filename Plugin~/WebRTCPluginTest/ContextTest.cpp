@@ -1,17 +1,37 @@
 #include "pch.h"
 #include "GraphicsDeviceTestBase.h"
 #include "../WebRTCPlugin/GraphicsDevice/ITexture2D.h"
-#include "../WebRTCPlugin/Codec/EncoderFactory.h"
 #include "../WebRTCPlugin/Codec/IEncoder.h"
 #include "../WebRTCPlugin/Context.h"
 
 using namespace WebRTC;
 using namespace testing;
 
+namespace
+{
+    //counts the decoders it is asked for and leaves them to the software decoder
+    class CountingDecoderBackend : public IHardwareDecoderBackend
+    {
+    public:
+        explicit CountingDecoderBackend(int* created) : created(created) {}
+        const char* GetName() const override { return "Counting"; }
+        bool IsSupported(const webrtc::SdpVideoFormat& format) const override
+        {
+            return format.name == cricket::kVp8CodecName;
+        }
+        std::unique_ptr<webrtc::VideoDecoder> CreateDecoder(const webrtc::SdpVideoFormat& format) override
+        {
+            (*created)++;
+            return nullptr;
+        }
+    private:
+        int* created;
+    };
+}
+
 class ContextTest : public GraphicsDeviceTestBase
 {
 protected:
-    IEncoder* encoder_ = nullptr;
     const int width = 256;
     const int height = 256;
     std::unique_ptr<Context> context;
@@ -20,38 +40,85 @@ protected:
         GraphicsDeviceTestBase::SetUp();
         EXPECT_NE(nullptr, m_device);
 
-        EncoderFactory::GetInstance().Init(width, height, m_device, encoderType);
-        encoder_ = EncoderFactory::GetInstance().GetEncoder();
-        EXPECT_NE(nullptr, encoder_);
-
-        context = std::make_unique<Context>();
+        context = std::make_unique<Context>(0, encoderType);
     }
     void TearDown() override {
-        EncoderFactory::GetInstance().Shutdown();
         GraphicsDeviceTestBase::TearDown();
     }
 };
 TEST_P(ContextTest, InitializeAndFinalizeEncoder) {
-    EXPECT_EQ(CodecInitializationResult::NotInitialized, context->GetCodecInitializationResult());
-    EXPECT_TRUE(context->InitializeEncoder(m_device));
-    EXPECT_EQ(CodecInitializationResult::Success, context->GetCodecInitializationResult());
-    context->FinalizeEncoder();
-    EXPECT_EQ(CodecInitializationResult::NotInitialized, context->GetCodecInitializationResult());
+    auto tex = m_device->CreateDefaultTextureV(width, height);
+    const auto stream = context->CreateVideoStream(tex->GetEncodeTexturePtrV(), width, height);
+    const auto track = stream->GetVideoTracks()[0].get();
+    EXPECT_EQ(CodecInitializationResult::NotInitialized, context->GetCodecInitializationResult(track));
+    EXPECT_TRUE(context->InitializeEncoder(m_device, track));
+    EXPECT_EQ(CodecInitializationResult::Success, context->GetCodecInitializationResult(track));
+    EXPECT_TRUE(context->HasInitializedEncoder());
+    context->FinalizeEncoder(track);
+    EXPECT_EQ(CodecInitializationResult::NotInitialized, context->GetCodecInitializationResult(track));
+    EXPECT_FALSE(context->HasInitializedEncoder());
+    context->DeleteVideoStream(stream);
 }
 
 TEST_P(ContextTest, CreateAndDeleteVideoStream) {
-    context->InitializeEncoder(m_device);
     auto tex = m_device->CreateDefaultTextureV(width, height);
     const auto stream = context->CreateVideoStream(tex->GetEncodeTexturePtrV(), width, height);
+    context->InitializeEncoder(m_device);
     context->DeleteVideoStream(stream);
     context->FinalizeEncoder();
 }
 
+TEST_P(ContextTest, MultipleVideoStreams) {
+    auto tex1 = m_device->CreateDefaultTextureV(width, height);
+    auto tex2 = m_device->CreateDefaultTextureV(width, height);
+    const auto stream1 = context->CreateVideoStream(tex1->GetEncodeTexturePtrV(), width, height);
+    const auto stream2 = context->CreateVideoStream(tex2->GetEncodeTexturePtrV(), width, height);
+    EXPECT_NE(stream1->id(), stream2->id());
+    const auto track1 = stream1->GetVideoTracks()[0].get();
+    const auto track2 = stream2->GetVideoTracks()[0].get();
+    EXPECT_NE(track1->id(), track2->id());
+
+    // each track owns its encoder, initializing one must not touch the other
+    EXPECT_TRUE(context->InitializeEncoder(m_device, track1));
+    EXPECT_EQ(CodecInitializationResult::Success, context->GetCodecInitializationResult(track1));
+    EXPECT_EQ(CodecInitializationResult::NotInitialized, context->GetCodecInitializationResult(track2));
+    EXPECT_TRUE(context->InitializeEncoder(m_device, track2));
+    EXPECT_EQ(CodecInitializationResult::Success, context->GetCodecInitializationResult());
+
+    context->EncodeFrame(track1, rtc::TimeMicros());
+    context->EncodeFrame(track2, rtc::TimeMicros());
+
+    context->FinalizeEncoder(track1);
+    EXPECT_EQ(CodecInitializationResult::NotInitialized, context->GetCodecInitializationResult(track1));
+    EXPECT_EQ(CodecInitializationResult::Success, context->GetCodecInitializationResult(track2));
+    EXPECT_TRUE(context->HasInitializedEncoder());
+    context->FinalizeEncoder(track2);
+    EXPECT_FALSE(context->HasInitializedEncoder());
+
+    context->DeleteVideoStream(stream1);
+    context->DeleteVideoStream(stream2);
+}
+
 TEST_P(ContextTest, CreateAndDeleteAudioStream) {
     const auto stream = context->CreateAudioStream();
     context->DeleteAudioStream(stream);
 }
 
+TEST_P(ContextTest, ConvertLowLatencyConfiguration) {
+    webrtc::PeerConnectionInterface::RTCConfiguration config;
+    Convert("{\"iceServers\":[],\"audioJitterBufferMaxPackets\":10,\"audioJitterBufferMinDelayMs\":20,\"audioJitterBufferFastAccelerate\":true}", config);
+    EXPECT_EQ(10, config.audio_jitter_buffer_max_packets);
+    EXPECT_EQ(20, config.audio_jitter_buffer_min_delay_ms);
+    EXPECT_TRUE(config.audio_jitter_buffer_fast_accelerate);
+
+    //omitted or zero values keep the webrtc defaults
+    Convert("{\"iceServers\":[],\"audioJitterBufferMaxPackets\":0}", config);
+    const webrtc::PeerConnectionInterface::RTCConfiguration defaultConfig;
+    EXPECT_EQ(defaultConfig.audio_jitter_buffer_max_packets, config.audio_jitter_buffer_max_packets);
+    EXPECT_EQ(0, config.audio_jitter_buffer_min_delay_ms);
+    EXPECT_FALSE(config.audio_jitter_buffer_fast_accelerate);
+}
+
 TEST_P(ContextTest, CreateAndDeletePeerConnection) {
     const auto connection = context->CreatePeerConnection();
     context->DeletePeerConnection(connection);
@@ -66,4 +133,78 @@ TEST_P(ContextTest, CreateAndDeleteDataChannel) {
     context->DeletePeerConnection(connection);
 }
 
+TEST_P(ContextTest, AddVideoDecoderBackend) {
+    int created = 0;
+    context->AddVideoDecoderBackend(std::make_unique<CountingDecoderBackend>(&created));
+    const auto decoder = context->GetVideoDecoderFactory()->CreateVideoDecoder(webrtc::SdpVideoFormat(cricket::kVp8CodecName));
+    EXPECT_EQ(1, created);
+    //the backend gave up, the software decoder is used
+    EXPECT_NE(nullptr, decoder);
+}
+
+TEST_P(ContextTest, AcquireSharedFactory) {
+    auto resources = FactoryResources::AcquireShared(encoderType);
+    EXPECT_EQ(resources, FactoryResources::AcquireShared(encoderType));
+    std::weak_ptr<FactoryResources> released = resources;
+    resources.reset();
+    EXPECT_TRUE(released.expired());
+}
+
+TEST_P(ContextTest, ShareFactory) {
+    auto context1 = std::make_unique<Context>(1, encoderType, true);
+    auto context2 = std::make_unique<Context>(2, encoderType, true);
+    const auto connection1 = context1->CreatePeerConnection();
+    const auto connection2 = context2->CreatePeerConnection();
+    context1->DeletePeerConnection(connection1);
+    //the shared threads outlive the context which created them
+    context1.reset();
+    const auto stream = context2->CreateAudioStream();
+    EXPECT_NE(nullptr, stream);
+    context2->DeleteAudioStream(stream);
+    context2->DeletePeerConnection(connection2);
+}
+
+TEST_P(ContextTest, PlayoutPerContext) {
+    auto context1 = std::make_unique<Context>(1, encoderType, true);
+    auto context2 = std::make_unique<Context>(2, encoderType, true);
+    const auto stream = context1->CreateAudioStream();
+    const auto track = stream->GetAudioTracks()[0];
+    //stands for a remote track of a connection of the second context
+    context2->AddRemoteAudioTrack(track);
+
+    const std::vector<float> samples(960, 0.5f);
+    context1->ProcessAudioData(track, samples.data(), static_cast<int32>(samples.size()), 48000, 2);
+    std::vector<float> block(960, 1.0f);
+    EXPECT_EQ(0, context1->ReadAudioPlayoutData(block.data(), static_cast<int32>(block.size()), 48000, 2));
+    EXPECT_EQ(0.0f, block[0]);
+    EXPECT_EQ(960, context2->ReadAudioPlayoutData(block.data(), static_cast<int32>(block.size()), 48000, 2));
+    EXPECT_NEAR(0.5f, block[0], 1e-3f);
+
+    context2->RemoveRemoteAudioTrack(track);
+    context1->DeleteAudioStream(stream);
+}
+
+TEST_P(ContextTest, PlayoutAtCallerSampleRate) {
+    auto context = std::make_unique<Context>(1, encoderType, true);
+    const auto stream = context->CreateAudioStream();
+    const auto track = stream->GetAudioTracks()[0];
+    context->AddRemoteAudioTrack(track);
+
+    //100ms at 48kHz are played as 100ms at 44.1kHz
+    const std::vector<float> samples(9600, 0.5f);
+    context->ProcessAudioData(track, samples.data(), static_cast<int32>(samples.size()), 48000, 2);
+    std::vector<float> block(882);
+    int32 total = 0;
+    int32 read = 0;
+    while ((read = context->ReadAudioPlayoutData(block.data(), static_cast<int32>(block.size()), 44100, 2)) > 0)
+    {
+        total += read;
+    }
+    EXPECT_EQ(8820, total);
+    EXPECT_EQ(0, context->ReadAudioPlayoutData(block.data(), static_cast<int32>(block.size()), 22050, 2));
+
+    context->RemoveRemoteAudioTrack(track);
+    context->DeleteAudioStream(stream);
+}
+
 INSTANTIATE_TEST_CASE_P(GraphicsDeviceParameters, ContextTest, ValuesIn(VALUES_TEST_ENV));
@@ -0,0 +1,274 @@
+#include "pch.h"
+#include <thread>
+#include "../WebRTCPlugin/DataChannelChunking.h"
+#include "../WebRTCPlugin/Context.h"
+#include "../WebRTCPlugin/PeerConnectionObject.h"
+#include "../WebRTCPlugin/DataChannelObject.h"
+#include "LoopbackPeer.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    std::vector<byte> CreateMessage(size_t size, uint32 seed)
+    {
+        std::vector<byte> message(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            message[i] = static_cast<byte>(i * 31 + seed);
+        }
+        return message;
+    }
+
+    //sends everything queued in sender to receiver, in the order the chunks are handed out
+    void Loopback(ChunkedMessageSender& sender, ChunkedMessageReceiver& receiver, std::vector<std::vector<byte>>& received)
+    {
+        std::vector<byte> chunk(sender.GetChunkSize());
+        while (size_t size = sender.NextChunk(chunk.data()))
+        {
+            EXPECT_TRUE(receiver.Receive(chunk.data(), size, [&received](const byte* data, size_t size)
+            {
+                received.emplace_back(data, data + size);
+            }));
+        }
+    }
+
+    std::vector<std::vector<byte>> SplitIntoChunks(ChunkedMessageSender& sender)
+    {
+        std::vector<std::vector<byte>> chunks;
+        std::vector<byte> chunk(sender.GetChunkSize());
+        while (size_t size = sender.NextChunk(chunk.data()))
+        {
+            chunks.emplace_back(chunk.begin(), chunk.begin() + size);
+        }
+        return chunks;
+    }
+
+    std::atomic<uint64> s_bytesReceived { 0 };
+
+    //sends the messages through two chunking data channels connected over loopback, returns the megabytes per second received
+    double MeasureChunkedThroughput(size_t chunkSize, size_t messageSize, int messageCount)
+    {
+        const int64 timeoutUs = 60 * rtc::kNumMicrosecsPerSec;
+        const auto resources = FactoryResources::Create(UnityEncoderType::UnityEncoderSoftware);
+        LoopbackPeer offerer(resources->Factory());
+        LoopbackPeer answerer(resources->Factory());
+        EXPECT_TRUE(ConnectLoopback(offerer, answerer, "chunking"));
+
+        Context context { 0, UnityEncoderType::UnityEncoderSoftware };
+        PeerConnectionObject connection { context };
+        DataChannelObject sender(offerer.GetChannel(), connection);
+        DataChannelObject receiver(answerer.GetChannel(), connection);
+        EXPECT_TRUE(sender.EnableChunking(chunkSize));
+        EXPECT_TRUE(receiver.EnableChunking(chunkSize));
+        s_bytesReceived = 0;
+        receiver.RegisterOnMessage([](DataChannelObject*, const byte*, int size) { s_bytesReceived += size; });
+
+        const std::vector<byte> message(messageSize);
+        const uint64 total = static_cast<uint64>(messageSize) * messageCount;
+        const int64 start = rtc::TimeMicros();
+        for (int i = 0; i < messageCount; i++)
+        {
+            //a couple of messages queued keep the channel busy without holding every message in memory
+            while (sender.GetPendingChunkedSize() > 2 * messageSize && rtc::TimeMicros() - start < timeoutUs)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            EXPECT_TRUE(sender.TrySend(message.data(), static_cast<int>(messageSize)));
+        }
+        while (s_bytesReceived < total && rtc::TimeMicros() - start < timeoutUs)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const int64 elapsedUs = std::max<int64>(rtc::TimeMicros() - start, 1);
+        EXPECT_EQ(total, s_bytesReceived.load());
+        return static_cast<double>(s_bytesReceived) / elapsedUs;
+    }
+}
+
+TEST(DataChannelChunkingTest, WholeMessage) {
+    const std::vector<byte> message = CreateMessage(10, 1);
+    std::vector<byte> framed(WholeMessageHeaderSize + message.size());
+    ChunkedMessageSender::WriteWholeMessageHeader(framed.data());
+    std::copy(message.begin(), message.end(), framed.begin() + WholeMessageHeaderSize);
+
+    ChunkedMessageReceiver receiver;
+    std::vector<byte> received;
+    EXPECT_TRUE(receiver.Receive(framed.data(), framed.size(), [&received](const byte* data, size_t size)
+    {
+        received.assign(data, data + size);
+    }));
+    EXPECT_EQ(message, received);
+}
+
+TEST(DataChannelChunkingTest, SplitAndReassemble) {
+    const size_t chunkSize = 1024;
+    ChunkedMessageSender sender(chunkSize);
+    EXPECT_EQ(chunkSize - WholeMessageHeaderSize, sender.GetMaxWholeMessageSize());
+    const std::vector<byte> message = CreateMessage(10 * chunkSize + 7, 2);
+    sender.Enqueue(message.data(), message.size());
+    EXPECT_EQ(message.size(), sender.GetPendingSize());
+
+    ChunkedMessageReceiver receiver;
+    std::vector<std::vector<byte>> received;
+    Loopback(sender, receiver, received);
+    ASSERT_EQ(1u, received.size());
+    EXPECT_EQ(message, received[0]);
+    EXPECT_EQ(0u, sender.GetPendingSize());
+    EXPECT_EQ(0u, receiver.GetPendingTransferCount());
+}
+
+TEST(DataChannelChunkingTest, TransfersTakeTurns) {
+    ChunkedMessageSender sender(ChunkHeaderSize + 100);
+    const std::vector<byte> large = CreateMessage(1000, 3);
+    const std::vector<byte> small = CreateMessage(150, 4);
+    sender.Enqueue(large.data(), large.size());
+    sender.Enqueue(small.data(), small.size());
+
+    //the small transfer completes after its second chunk, long before the large one
+    ChunkedMessageReceiver receiver;
+    std::vector<std::vector<byte>> received;
+    std::vector<byte> chunk(sender.GetChunkSize());
+    int chunks = 0;
+    while (size_t size = sender.NextChunk(chunk.data()))
+    {
+        chunks++;
+        receiver.Receive(chunk.data(), size, [&](const byte* data, size_t size)
+        {
+            received.emplace_back(data, data + size);
+            if (received.size() == 1)
+            {
+                EXPECT_EQ(4, chunks);
+            }
+        });
+    }
+    ASSERT_EQ(2u, received.size());
+    EXPECT_EQ(small, received[0]);
+    EXPECT_EQ(large, received[1]);
+}
+
+TEST(DataChannelChunkingTest, ChunksInAnyOrder) {
+    ChunkedMessageSender sender(ChunkHeaderSize + 64);
+    const std::vector<byte> message = CreateMessage(64 * 5, 5);
+    sender.Enqueue(message.data(), message.size());
+    std::vector<std::vector<byte>> chunks = SplitIntoChunks(sender);
+    std::reverse(chunks.begin(), chunks.end());
+
+    ChunkedMessageReceiver receiver;
+    std::vector<byte> received;
+    for (const auto& c : chunks)
+    {
+        receiver.Receive(c.data(), c.size(), [&received](const byte* data, size_t size) { received.assign(data, data + size); });
+    }
+    EXPECT_EQ(message, received);
+}
+
+TEST(DataChannelChunkingTest, RejectMalformed) {
+    ChunkedMessageReceiver receiver(1000);
+    const auto fail = [](const byte*, size_t) { FAIL(); };
+    const byte unknownType[] = { 7, 0 };
+    EXPECT_FALSE(receiver.Receive(unknownType, sizeof(unknownType), fail));
+    EXPECT_FALSE(receiver.Receive(nullptr, 0, fail));
+
+    ChunkedMessageSender sender(ChunkHeaderSize + 10);
+    const std::vector<byte> message = CreateMessage(2000, 6);
+    sender.Enqueue(message.data(), message.size());
+    std::vector<byte> chunk(sender.GetChunkSize());
+    const size_t size = sender.NextChunk(chunk.data());
+    //larger than the receiver accepts
+    EXPECT_FALSE(receiver.Receive(chunk.data(), size, fail));
+    //truncated header
+    EXPECT_FALSE(receiver.Receive(chunk.data(), ChunkHeaderSize - 1, fail));
+    EXPECT_EQ(0u, receiver.GetPendingTransferCount());
+}
+
+TEST(DataChannelChunkingTest, BigEndianHeader) {
+    ChunkedMessageSender sender(ChunkHeaderSize + 100);
+    const std::vector<byte> message = CreateMessage(258, 8);
+    sender.Enqueue(message.data(), message.size());
+    sender.Enqueue(message.data(), message.size());
+    const std::vector<std::vector<byte>> chunks = SplitIntoChunks(sender);
+    //the second chunk handed out is the first chunk of transfer 1
+    const std::vector<byte> header(chunks[1].begin(), chunks[1].begin() + ChunkHeaderSize);
+    const std::vector<byte> expected = { 1, 0, 0, 0, 1, 0, 0, 1, 2, 0, 0, 0, 0 };
+    EXPECT_EQ(expected, header);
+}
+
+TEST(DataChannelChunkingTest, DuplicateChunksCountOnce) {
+    ChunkedMessageSender sender(ChunkHeaderSize + 64);
+    const std::vector<byte> message = CreateMessage(64 * 4, 9);
+    sender.Enqueue(message.data(), message.size());
+    const std::vector<std::vector<byte>> chunks = SplitIntoChunks(sender);
+    ASSERT_EQ(4u, chunks.size());
+
+    ChunkedMessageReceiver receiver;
+    std::vector<std::vector<byte>> received;
+    const auto onMessage = [&received](const byte* data, size_t size) { received.emplace_back(data, data + size); };
+    //as many bytes as the message, but only half of it
+    for (size_t i : { 0, 0, 1, 1 })
+    {
+        EXPECT_TRUE(receiver.Receive(chunks[i].data(), chunks[i].size(), onMessage));
+    }
+    EXPECT_TRUE(received.empty());
+    for (size_t i : { 2, 3 })
+    {
+        EXPECT_TRUE(receiver.Receive(chunks[i].data(), chunks[i].size(), onMessage));
+    }
+    ASSERT_EQ(1u, received.size());
+    EXPECT_EQ(message, received[0]);
+}
+
+TEST(DataChannelChunkingTest, PendingTransferCountIsLimited) {
+    ChunkedMessageSender sender(ChunkHeaderSize + 10);
+    std::vector<std::vector<byte>> messages;
+    for (uint32 i = 0; i < 3; i++)
+    {
+        messages.push_back(CreateMessage(200, 10 + i));
+        sender.Enqueue(messages[i].data(), messages[i].size());
+    }
+
+    //the first chunk of the third transfer drops the first one, whose remaining chunks are ignored
+    ChunkedMessageReceiver receiver(1000, 1000, 2);
+    std::vector<std::vector<byte>> received;
+    Loopback(sender, receiver, received);
+    ASSERT_EQ(2u, received.size());
+    EXPECT_EQ(messages[1], received[0]);
+    EXPECT_EQ(messages[2], received[1]);
+    EXPECT_EQ(1u, receiver.GetDroppedTransferCount());
+    EXPECT_EQ(0u, receiver.GetPendingTransferCount());
+    EXPECT_EQ(0u, receiver.GetPendingSize());
+}
+
+TEST(DataChannelChunkingTest, PendingSizeIsLimited) {
+    ChunkedMessageSender sender(ChunkHeaderSize + 10);
+    const std::vector<byte> first = CreateMessage(200, 13);
+    const std::vector<byte> second = CreateMessage(200, 14);
+    sender.Enqueue(first.data(), first.size());
+    sender.Enqueue(second.data(), second.size());
+
+    ChunkedMessageReceiver receiver(1000, 300);
+    std::vector<std::vector<byte>> received;
+    Loopback(sender, receiver, received);
+    ASSERT_EQ(1u, received.size());
+    EXPECT_EQ(second, received[0]);
+    EXPECT_EQ(1u, receiver.GetDroppedTransferCount());
+
+    //a message which can't fit at all is rejected
+    const std::vector<byte> large = CreateMessage(400, 15);
+    sender.Enqueue(large.data(), large.size());
+    std::vector<byte> chunk(sender.GetChunkSize());
+    const size_t size = sender.NextChunk(chunk.data());
+    EXPECT_FALSE(receiver.Receive(chunk.data(), size, [](const byte*, size_t) { FAIL(); }));
+    EXPECT_EQ(0u, receiver.GetPendingTransferCount());
+}
+
+//a benchmark, run it with --gtest_also_run_disabled_tests
+TEST(DataChannelChunkingTest, DISABLED_BenchmarkDataChannelThroughput) {
+    const size_t messageSize = 8 * 1024 * 1024;
+    const int messageCount = 8;
+    for (size_t chunkSize : { 16 * 1024, 64 * 1024, 256 * 1024 })
+    {
+        const double megabytesPerSecond = MeasureChunkedThroughput(chunkSize, messageSize, messageCount);
+        RecordProperty("DataChannelMBps_" + std::to_string(chunkSize / 1024) + "KiB", std::to_string(megabytesPerSecond));
+    }
+}
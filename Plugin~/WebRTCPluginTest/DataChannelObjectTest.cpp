@@ -0,0 +1,223 @@
+#include "pch.h"
+#include "../WebRTCPlugin/Context.h"
+#include "../WebRTCPlugin/PeerConnectionObject.h"
+#include "../WebRTCPlugin/DataChannelObject.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    //records the messages instead of sending them
+    class FakeDataChannel : public webrtc::DataChannelInterface
+    {
+    public:
+        void RegisterObserver(webrtc::DataChannelObserver* observer) override {}
+        void UnregisterObserver() override {}
+        std::string label() const override { return "fake"; }
+        bool reliable() const override { return true; }
+        int id() const override { return 0; }
+        DataState state() const override { return kOpen; }
+        uint32_t messages_sent() const override { return static_cast<uint32_t>(messages.size()); }
+        uint64_t bytes_sent() const override { return 0; }
+        uint32_t messages_received() const override { return 0; }
+        uint64_t bytes_received() const override { return 0; }
+        uint64_t buffered_amount() const override { return bufferedAmount; }
+        void Close() override {}
+        bool Send(const webrtc::DataBuffer& buffer) override
+        {
+            if (messages.size() >= capacity)
+                return false;
+            messages.push_back(buffer.data);
+            bufferedAmount += buffer.size();
+            return true;
+        }
+
+        size_t capacity = std::numeric_limits<size_t>::max();
+        uint64_t bufferedAmount = 0;
+        std::vector<rtc::CopyOnWriteBuffer> messages;
+    };
+}
+
+class DataChannelObjectTest : public testing::Test
+{
+protected:
+    Context context { 0, UnityEncoderType::UnityEncoderSoftware };
+    PeerConnectionObject connection { context };
+    rtc::scoped_refptr<FakeDataChannel> channel = new rtc::RefCountedObject<FakeDataChannel>();
+    DataChannelObject dataChannel { channel, connection };
+};
+
+TEST_F(DataChannelObjectTest, SendBatch) {
+    const byte data[] = { 1, 2, 3, 4, 5, 6 };
+    const int offsets[] = { 0, 1, 1, 3 };
+    EXPECT_EQ(4, dataChannel.Send(data, 6, offsets, 4));
+    ASSERT_EQ(4u, channel->messages.size());
+    EXPECT_EQ(rtc::CopyOnWriteBuffer(data, 1), channel->messages[0]);
+    //empty messages are allowed
+    EXPECT_EQ(0u, channel->messages[1].size());
+    EXPECT_EQ(rtc::CopyOnWriteBuffer(data + 1, 2), channel->messages[2]);
+    EXPECT_EQ(rtc::CopyOnWriteBuffer(data + 3, 3), channel->messages[3]);
+}
+
+TEST_F(DataChannelObjectTest, SendBatchStopsAtFailure) {
+    const byte data[] = { 1, 2, 3, 4 };
+    const int offsets[] = { 0, 1, 2, 3 };
+    channel->capacity = 2;
+    EXPECT_EQ(2, dataChannel.Send(data, 4, offsets, 4));
+
+    const int invalidOffsets[] = { 0, 5 };
+    channel->capacity = 10;
+    EXPECT_EQ(1, dataChannel.Send(data, 4, invalidOffsets, 2));
+}
+
+TEST_F(DataChannelObjectTest, SendBuffer) {
+    DataChannelBuffer* buffer = dataChannel.AcquireBuffer(16);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(16u, buffer->data.size());
+    memset(buffer->data.data(), 7, 16);
+    const byte* memory = buffer->data.cdata();
+    EXPECT_TRUE(dataChannel.Send(buffer, 4));
+    ASSERT_EQ(1u, channel->messages.size());
+    EXPECT_EQ(4u, channel->messages[0].size());
+    //the message is sent without copy
+    EXPECT_EQ(memory, channel->messages[0].cdata());
+    //the buffer went back to the channel
+    EXPECT_FALSE(dataChannel.Send(buffer, 4));
+}
+
+TEST_F(DataChannelObjectTest, RecycleBuffer) {
+    DataChannelBuffer* buffer1 = dataChannel.AcquireBuffer(8);
+    dataChannel.ReleaseBuffer(buffer1);
+    DataChannelBuffer* buffer2 = dataChannel.AcquireBuffer(8);
+    EXPECT_EQ(buffer1, buffer2);
+
+    //a buffer still held by a sent message isn't overwritten
+    memset(buffer2->data.data(), 1, 8);
+    EXPECT_TRUE(dataChannel.Send(buffer2, 8));
+    DataChannelBuffer* buffer3 = dataChannel.AcquireBuffer(8);
+    memset(buffer3->data.data(), 2, 8);
+    EXPECT_EQ(1, channel->messages[0].cdata()[0]);
+    dataChannel.ReleaseBuffer(buffer3);
+
+    //buffers of other channels are ignored
+    DataChannelBuffer foreign;
+    EXPECT_FALSE(dataChannel.Send(&foreign, 0));
+    dataChannel.ReleaseBuffer(&foreign);
+}
+
+TEST_F(DataChannelObjectTest, ReceiveQueue) {
+    int messageCount = 0;
+    static int* counter = &messageCount;
+    dataChannel.RegisterOnMessage([](DataChannelObject*, const byte*, int) { (*counter)++; });
+    dataChannel.OnMessage(webrtc::DataBuffer("callback"));
+    EXPECT_EQ(1, messageCount);
+    EXPECT_EQ(-1, dataChannel.GetNextMessageSize());
+
+    EXPECT_TRUE(dataChannel.EnableReceiveQueue(1024));
+    EXPECT_FALSE(dataChannel.EnableReceiveQueue(1024));
+    dataChannel.OnMessage(webrtc::DataBuffer("hello"));
+    dataChannel.OnMessage(webrtc::DataBuffer("world!"));
+    //queued messages don't go through the callback
+    EXPECT_EQ(1, messageCount);
+    EXPECT_EQ(5, dataChannel.GetNextMessageSize());
+
+    byte data[64];
+    int sizes[4];
+    ASSERT_EQ(2, dataChannel.ReceiveMessages(data, sizeof(data), sizes, 4));
+    EXPECT_EQ(5, sizes[0]);
+    EXPECT_EQ(6, sizes[1]);
+    EXPECT_EQ("helloworld!", std::string(reinterpret_cast<char*>(data), 11));
+    EXPECT_EQ(0, dataChannel.ReceiveMessages(data, sizeof(data), sizes, 4));
+}
+
+TEST_F(DataChannelObjectTest, TrySendStopsAtHighThreshold) {
+    const byte data[100] = {};
+    //no limit by default
+    EXPECT_TRUE(dataChannel.TrySend(data, 100));
+    dataChannel.SetBufferedAmountHighThreshold(250);
+    EXPECT_TRUE(dataChannel.TrySend(data, 100));
+    EXPECT_EQ(200u, dataChannel.GetBufferedAmount());
+    EXPECT_FALSE(dataChannel.TrySend(data, 100));
+    EXPECT_TRUE(dataChannel.TrySend(data, 50));
+    EXPECT_EQ(3u, channel->messages.size());
+}
+
+TEST_F(DataChannelObjectTest, BufferedAmountLow) {
+    int lowCount = 0;
+    static int* counter = &lowCount;
+    dataChannel.RegisterOnBufferedAmountLow([](DataChannelObject*) { (*counter)++; });
+    dataChannel.SetBufferedAmountLowThreshold(100);
+
+    const byte data[100] = {};
+    dataChannel.Send(data, 100);
+    //not above the threshold, nothing to report
+    channel->bufferedAmount = 0;
+    dataChannel.OnBufferedAmountChange(100);
+    EXPECT_EQ(0, lowCount);
+    EXPECT_FALSE(dataChannel.PollBufferedAmountLow());
+
+    dataChannel.Send(data, 100);
+    dataChannel.Send(data, 100);
+    channel->bufferedAmount = 150;
+    dataChannel.OnBufferedAmountChange(50);
+    EXPECT_EQ(0, lowCount);
+    channel->bufferedAmount = 100;
+    dataChannel.OnBufferedAmountChange(50);
+    EXPECT_EQ(1, lowCount);
+    //reported once per crossing
+    channel->bufferedAmount = 0;
+    dataChannel.OnBufferedAmountChange(100);
+    EXPECT_EQ(1, lowCount);
+    EXPECT_TRUE(dataChannel.PollBufferedAmountLow());
+    EXPECT_FALSE(dataChannel.PollBufferedAmountLow());
+}
+
+TEST_F(DataChannelObjectTest, ChunkedLoopback) {
+    rtc::scoped_refptr<FakeDataChannel> remoteChannel = new rtc::RefCountedObject<FakeDataChannel>();
+    DataChannelObject remote(remoteChannel, connection);
+    EXPECT_TRUE(dataChannel.EnableChunking(1024));
+    EXPECT_FALSE(dataChannel.EnableChunking(1024));
+    EXPECT_TRUE(remote.EnableChunking(1024));
+    EXPECT_TRUE(remote.EnableReceiveQueue(1 << 20));
+
+    std::vector<byte> large(100000);
+    for (size_t i = 0; i < large.size(); i++)
+    {
+        large[i] = static_cast<byte>(i);
+    }
+    const byte small[] = { 1, 2, 3 };
+    dataChannel.Send(large.data(), static_cast<int>(large.size()));
+    //the send window is full, the rest waits for the channel to drain
+    EXPECT_LT(0u, dataChannel.GetPendingChunkedSize());
+    dataChannel.Send(small, sizeof(small));
+    DataChannelBuffer* buffer = dataChannel.AcquireBuffer(2);
+    buffer->data.data()[buffer->offset] = 4;
+    buffer->data.data()[buffer->offset + 1] = 5;
+    EXPECT_TRUE(dataChannel.Send(buffer, 2));
+
+    //deliver everything sent so far, then let the sender refill the window
+    size_t delivered = 0;
+    while (delivered < channel->messages.size())
+    {
+        for (; delivered < channel->messages.size(); delivered++)
+        {
+            EXPECT_GE(1024u, channel->messages[delivered].size());
+            remote.OnMessage(webrtc::DataBuffer(channel->messages[delivered], true));
+        }
+        channel->bufferedAmount = 0;
+        dataChannel.OnBufferedAmountChange(0);
+    }
+    EXPECT_EQ(0u, dataChannel.GetPendingChunkedSize());
+
+    std::vector<byte> data(200000);
+    int sizes[4];
+    ASSERT_EQ(3, remote.ReceiveMessages(data.data(), static_cast<int>(data.size()), sizes, 4));
+    //small messages overtake the large one
+    EXPECT_EQ(3, sizes[0]);
+    EXPECT_EQ(std::vector<byte>(small, small + 3), std::vector<byte>(data.begin(), data.begin() + 3));
+    EXPECT_EQ(2, sizes[1]);
+    EXPECT_EQ(4, data[3]);
+    EXPECT_EQ(5, data[4]);
+    ASSERT_EQ(static_cast<int>(large.size()), sizes[2]);
+    EXPECT_EQ(large, std::vector<byte>(data.begin() + 5, data.begin() + 5 + large.size()));
+}
@@ -0,0 +1,119 @@
+#include "pch.h"
+#include "../WebRTCPlugin/DataChannelReceiveQueue.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    std::vector<byte> CreateMessage(uint32 index)
+    {
+        //sizes from 0 to 12 bytes, each byte tells the index of the message
+        return std::vector<byte>(index % 13, static_cast<byte>(index));
+    }
+
+    void Push(DataChannelReceiveQueue& queue, uint32 index)
+    {
+        const std::vector<byte> message = CreateMessage(index);
+        queue.Push(message.data(), message.size());
+    }
+
+    //checks the popped messages and returns the index of the next expected one
+    uint32 Expect(const byte* data, const int* sizes, int count, uint32 index)
+    {
+        for (int i = 0; i < count; i++, index++)
+        {
+            const std::vector<byte> expected = CreateMessage(index);
+            EXPECT_EQ(expected, std::vector<byte>(data, data + sizes[i]));
+            data += sizes[i];
+        }
+        return index;
+    }
+}
+
+TEST(DataChannelReceiveQueueTest, PopInOrder) {
+    DataChannelReceiveQueue queue(64);
+    EXPECT_EQ(-1, queue.GetNextMessageSize());
+    for (uint32 i = 1; i <= 3; i++)
+    {
+        Push(queue, i);
+    }
+    EXPECT_EQ(1, queue.GetNextMessageSize());
+
+    byte data[16];
+    int sizes[8];
+    //only the first message fits into 2 bytes
+    EXPECT_EQ(1, queue.Pop(data, 2, sizes, 8));
+    EXPECT_EQ(2u, Expect(data, sizes, 1, 1));
+    //count limits the number of messages too
+    EXPECT_EQ(1, queue.Pop(data, sizeof(data), sizes, 1));
+    EXPECT_EQ(3u, Expect(data, sizes, 1, 2));
+    EXPECT_EQ(1, queue.Pop(data, sizeof(data), sizes, 8));
+    EXPECT_EQ(4u, Expect(data, sizes, 1, 3));
+    EXPECT_EQ(0, queue.Pop(data, sizeof(data), sizes, 8));
+    EXPECT_EQ(0u, queue.GetOverflowCount());
+}
+
+TEST(DataChannelReceiveQueueTest, WrapAround) {
+    DataChannelReceiveQueue queue(37);
+    byte data[64];
+    int sizes[8];
+    uint32 pushed = 0;
+    uint32 popped = 0;
+    for (int round = 0; round < 100; round++)
+    {
+        Push(queue, pushed++);
+        Push(queue, pushed++);
+        const int count = queue.Pop(data, sizeof(data), sizes, 8);
+        popped = Expect(data, sizes, count, popped);
+    }
+    EXPECT_EQ(pushed, popped);
+    EXPECT_EQ(0u, queue.GetOverflowCount());
+}
+
+TEST(DataChannelReceiveQueueTest, OverflowKeepsOrder) {
+    DataChannelReceiveQueue queue(32);
+    //doesn't fit into the arena at all
+    const std::vector<byte> large(100, 7);
+    Push(queue, 12);
+    queue.Push(large.data(), large.size());
+    //would fit again, but has to wait behind the overflowed message
+    Push(queue, 1);
+    EXPECT_EQ(2u, queue.GetOverflowCount());
+
+    byte data[128];
+    int sizes[8];
+    EXPECT_EQ(12, queue.GetNextMessageSize());
+    EXPECT_EQ(1, queue.Pop(data, 20, sizes, 8));
+    EXPECT_EQ(100, queue.GetNextMessageSize());
+    EXPECT_EQ(2, queue.Pop(data, sizeof(data), sizes, 8));
+    EXPECT_EQ(large, std::vector<byte>(data, data + sizes[0]));
+    EXPECT_EQ(2u, Expect(data + sizes[0], sizes + 1, 1, 1));
+
+    //back to the arena
+    Push(queue, 3);
+    EXPECT_EQ(2u, queue.GetOverflowCount());
+    EXPECT_EQ(1, queue.Pop(data, sizeof(data), sizes, 8));
+    EXPECT_EQ(-1, queue.GetNextMessageSize());
+}
+
+TEST(DataChannelReceiveQueueTest, ConcurrentProducerAndConsumer) {
+    DataChannelReceiveQueue queue(256);
+    const uint32 count = 200000;
+    std::thread producer([&queue]()
+    {
+        for (uint32 i = 0; i < count; i++)
+        {
+            Push(queue, i);
+        }
+    });
+    byte data[1024];
+    int sizes[64];
+    uint32 popped = 0;
+    while (popped < count)
+    {
+        const int received = queue.Pop(data, sizeof(data), sizes, 64);
+        popped = Expect(data, sizes, received, popped);
+    }
+    producer.join();
+    EXPECT_EQ(0, queue.Pop(data, sizeof(data), sizes, 64));
+}
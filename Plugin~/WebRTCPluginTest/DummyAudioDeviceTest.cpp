@@ -0,0 +1,72 @@
+#include "pch.h"
+#include "../WebRTCPlugin/DummyAudioDevice.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    const int16 PlayoutLevel = 8192;
+
+    //plays a constant level
+    class FakeAudioTransport : public webrtc::AudioTransport
+    {
+    public:
+        int32_t RecordedDataIsAvailable(const void* audioSamples, const size_t nSamples, const size_t nBytesPerSample,
+            const size_t nChannels, const uint32_t samplesPerSec, const uint32_t totalDelayMS, const int32_t clockDrift,
+            const uint32_t currentMicLevel, const bool keyPressed, uint32_t& newMicLevel) override
+        {
+            return 0;
+        }
+        int32_t NeedMorePlayData(const size_t nSamples, const size_t nBytesPerSample, const size_t nChannels,
+            const uint32_t samplesPerSec, void* audioSamples, size_t& nSamplesOut,
+            int64_t* elapsed_time_ms, int64_t* ntp_time_ms) override
+        {
+            int16* samples = static_cast<int16*>(audioSamples);
+            std::fill(samples, samples + nSamples * nChannels, PlayoutLevel);
+            nSamplesOut = nSamples;
+            pulls++;
+            return 0;
+        }
+        void PullRenderData(int bits_per_sample, int sample_rate, size_t number_of_channels, size_t number_of_frames,
+            void* audio_data, int64_t* elapsed_time_ms, int64_t* ntp_time_ms) override
+        {
+        }
+
+        std::atomic<int> pulls {0};
+    };
+}
+
+class DummyAudioDeviceTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        device = new rtc::RefCountedObject<DummyAudioDevice>();
+        device->Init();
+        device->RegisterAudioCallback(&transport);
+    }
+    void TearDown() override
+    {
+        device->Terminate();
+    }
+    rtc::scoped_refptr<DummyAudioDevice> device;
+    FakeAudioTransport transport;
+};
+
+TEST_F(DummyAudioDeviceTest, PullPlayout) {
+    EXPECT_FALSE(device->PlayoutIsInitialized());
+    EXPECT_NE(0, device->StartPlayout());
+    EXPECT_EQ(0, device->InitPlayout());
+    EXPECT_TRUE(device->PlayoutIsInitialized());
+    EXPECT_EQ(0, device->StartPlayout());
+    EXPECT_TRUE(device->Playing());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_LT(0, transport.pulls);
+
+    EXPECT_EQ(0, device->StopPlayout());
+    EXPECT_FALSE(device->Playing());
+    const int pulls = transport.pulls;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(pulls, transport.pulls);
+}
@@ -0,0 +1,94 @@
+#include "pch.h"
+#include "../WebRTCPlugin/DummyVideoEncoder.h"
+#include "../WebRTCPlugin/NvVideoCapturer.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    class EncodedImageCounter : public webrtc::EncodedImageCallback
+    {
+    public:
+        Result OnEncodedImage(const webrtc::EncodedImage& encodedImage,
+            const webrtc::CodecSpecificInfo* codecSpecificInfo,
+            const webrtc::RTPFragmentationHeader* fragmentation) override
+        {
+            frames++;
+            image.assign(encodedImage.data(), encodedImage.data() + encodedImage.size());
+            for (size_t i = 0; i < fragmentation->fragmentationVectorSize; i++)
+            {
+                fragmentsInImage &= fragmentation->fragmentationOffset[i] + fragmentation->fragmentationLength[i] <= encodedImage.size();
+            }
+            return Result(Result::OK);
+        }
+        int frames = 0;
+        std::vector<uint8> image;
+        bool fragmentsInImage = true;
+    };
+
+    webrtc::VideoFrame CreateFrame(rtc::scoped_refptr<CapturerLink> capturer, std::vector<uint8>& data)
+    {
+        rtc::scoped_refptr<FrameBuffer> buffer = new rtc::RefCountedObject<FrameBuffer>(256, 256, rtc::CopyOnWriteBuffer(data.data(), data.size()), 0, 0);
+        buffer->SetCapturer(capturer);
+        return webrtc::VideoFrame::Builder()
+            .set_video_frame_buffer(buffer)
+            .set_timestamp_us(rtc::TimeMicros())
+            .build();
+    }
+
+    webrtc::VideoEncoder::RateControlParameters CreateRates(uint32 bitrate)
+    {
+        webrtc::VideoBitrateAllocation allocation;
+        allocation.SetBitrate(0, 0, bitrate);
+        return webrtc::VideoEncoder::RateControlParameters(allocation, 30.0);
+    }
+}
+
+class DummyVideoEncoderTest : public testing::Test
+{
+protected:
+    void SetUp() override {
+        webrtc::VideoCodec codec;
+        encoder.InitEncode(&codec, 1, 1200);
+        encoder.RegisterEncodeCompleteCallback(&callback);
+    }
+    //an IDR slice is enough for the NAL unit parser
+    std::vector<uint8> data = { 0, 0, 0, 1, 0x65, 0x88, 0x84, 0x00 };
+    EncodedImageCounter callback;
+    DummyVideoEncoder encoder;
+};
+
+TEST_F(DummyVideoEncoderTest, RatesBeforeFirstFrameReachCapturer) {
+    NvVideoCapturer capturer;
+    encoder.SetRates(CreateRates(500000));
+    EXPECT_EQ(0u, capturer.GetFeedback().GetTargetBitrate(0));
+
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder.Encode(CreateFrame(capturer.GetLink(), data), nullptr));
+    EXPECT_EQ(1, callback.frames);
+    EXPECT_EQ(500000u, capturer.GetFeedback().GetTargetBitrate(0));
+}
+
+TEST_F(DummyVideoEncoderTest, CapturerDeletedWhileBound) {
+    auto capturer = std::make_unique<NvVideoCapturer>();
+    const webrtc::VideoFrame frame = CreateFrame(capturer->GetLink(), data);
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder.Encode(frame, nullptr));
+
+    //the track has been deleted while the encoder and a queued frame still refer to its capturer
+    capturer.reset();
+    encoder.SetRates(CreateRates(300000));
+    const std::vector<webrtc::VideoFrameType> keyFrame = { webrtc::VideoFrameType::kVideoFrameKey };
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder.Encode(frame, &keyFrame));
+    EXPECT_EQ(2, callback.frames);
+}
+
+TEST_F(DummyVideoEncoderTest, FrameKeepsItsBitstream) {
+    NvVideoCapturer capturer;
+    const std::vector<uint8> encoded = data;
+    const webrtc::VideoFrame frame = CreateFrame(capturer.GetLink(), data);
+
+    //the hardware encoder has rewritten its output buffer while the frame was queued
+    data.assign(2, 0xff);
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder.Encode(frame, nullptr));
+    EXPECT_EQ(encoded, callback.image);
+    EXPECT_TRUE(callback.fragmentsInImage);
+}
@@ -0,0 +1,55 @@
+#include "pch.h"
+#include "../WebRTCPlugin/Codec/EncoderStats.h"
+
+using namespace WebRTC;
+
+TEST(DurationHistogramTest, BucketsCoverDurations) {
+    for (uint64 durationUs = 0; durationUs < 100000; durationUs++)
+    {
+        const size_t index = DurationHistogram::GetBucketIndex(durationUs);
+        ASSERT_LE(durationUs, DurationHistogram::GetBucketUpperBound(index));
+        //bounded relative error
+        ASSERT_LE(DurationHistogram::GetBucketUpperBound(index), durationUs + durationUs / 8);
+        if (index > 0)
+        {
+            ASSERT_GT(durationUs, DurationHistogram::GetBucketUpperBound(index - 1));
+        }
+    }
+}
+
+TEST(DurationHistogramTest, Percentiles) {
+    DurationHistogram histogram;
+    EXPECT_EQ(0.0, histogram.GetAverage());
+    EXPECT_EQ(0.0, histogram.GetPercentile(99));
+    for (int i = 0; i < 99; i++)
+    {
+        histogram.Add(1000);
+    }
+    histogram.Add(50000);
+    EXPECT_DOUBLE_EQ(1490.0, histogram.GetAverage());
+    EXPECT_NEAR(1000.0, histogram.GetPercentile(99), 1000.0 / 8);
+    EXPECT_NEAR(50000.0, histogram.GetPercentile(100), 50000.0 / 8);
+    //negative durations from a clock going backwards count as 0
+    histogram.Add(-5);
+    EXPECT_EQ(0.0, histogram.GetPercentile(0.5));
+}
+
+TEST(EncoderStatsCountersTest, Get) {
+    EncoderStatsCounters counters;
+    counters.OnCopy(200);
+    counters.OnFrameSubmitted();
+    counters.OnFrameEncoded(3000);
+    counters.OnFrameSubmitted();
+    counters.OnFrameDropped();
+    counters.OnForcedIdrFrame();
+    counters.OnReconfigure();
+    const EncoderStats stats = counters.Get();
+    EXPECT_EQ(2u, stats.framesSubmitted);
+    EXPECT_EQ(1u, stats.framesEncoded);
+    EXPECT_EQ(1u, stats.framesDropped);
+    EXPECT_EQ(1u, stats.forcedIdrFrames);
+    EXPECT_EQ(1u, stats.reconfigures);
+    EXPECT_EQ(200.0, stats.averageCopyTimeUs);
+    EXPECT_EQ(3000.0, stats.averageEncodeTimeUs);
+    EXPECT_NEAR(3000.0, stats.p99EncodeTimeUs, 3000.0 / 8);
+}
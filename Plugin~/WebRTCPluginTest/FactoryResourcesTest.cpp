@@ -0,0 +1,169 @@
+#include "pch.h"
+#include <thread>
+#include "api/stats/rtcstats_objects.h"
+#include "../WebRTCPlugin/FactoryResources.h"
+#include "LoopbackPeer.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    const int FrameWidth = 640;
+    const int FrameHeight = 360;
+    const int Framerate = 30;
+    const int MinBitrateBps = 4000000;
+    const int MaxBitrateBps = 8000000;
+
+    //feeds the builtin software encoders with noise, which keeps their output at the target bitrate
+    class NoiseVideoSource : public rtc::AdaptedVideoTrackSource
+    {
+    public:
+        void PushFrame()
+        {
+            rtc::scoped_refptr<webrtc::I420Buffer> buffer = webrtc::I420Buffer::Create(FrameWidth, FrameHeight);
+            for (int i = 0; i < buffer->StrideY() * FrameHeight; i++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                buffer->MutableDataY()[i] = static_cast<uint8>(seed >> 24);
+            }
+            memset(buffer->MutableDataU(), 128, buffer->StrideU() * buffer->ChromaHeight());
+            memset(buffer->MutableDataV(), 128, buffer->StrideV() * buffer->ChromaHeight());
+            OnFrame(webrtc::VideoFrame::Builder()
+                .set_video_frame_buffer(buffer)
+                .set_timestamp_us(rtc::TimeMicros())
+                .build());
+        }
+
+        SourceState state() const override { return kLive; }
+        bool remote() const override { return false; }
+        bool is_screencast() const override { return false; }
+        absl::optional<bool> needs_denoising() const override { return false; }
+
+    private:
+        uint32 seed = 1;
+    };
+
+    class StatsWaiter : public webrtc::RTCStatsCollectorCallback
+    {
+    public:
+        void OnStatsDelivered(const rtc::scoped_refptr<const webrtc::RTCStatsReport>& value) override
+        {
+            report = value;
+            done.Set();
+        }
+        rtc::scoped_refptr<const webrtc::RTCStatsReport> report;
+        rtc::Event done;
+    };
+
+    //packetsSent of the outbound RTP streams, the connections carry video only
+    uint64 CountPacketsSent(webrtc::PeerConnectionInterface* connection)
+    {
+        rtc::scoped_refptr<StatsWaiter> waiter = new rtc::RefCountedObject<StatsWaiter>();
+        connection->GetStats(waiter);
+        if (!waiter->done.Wait(LoopbackPeer::TimeoutMs))
+        {
+            return 0;
+        }
+        uint64 packets = 0;
+        for (const auto* stats : waiter->report->GetStatsOfType<webrtc::RTCOutboundRTPStreamStats>())
+        {
+            if (stats->packets_sent.is_defined())
+            {
+                packets += *stats->packets_sent;
+            }
+        }
+        return packets;
+    }
+
+    void PushFrames(NoiseVideoSource& source, int64 durationUs)
+    {
+        const auto interval = std::chrono::microseconds(rtc::kNumMicrosecsPerSec / Framerate);
+        auto next = std::chrono::steady_clock::now();
+        const int64 start = rtc::TimeMicros();
+        while (rtc::TimeMicros() - start < durationUs)
+        {
+            source.PushFrame();
+            next += interval;
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    //sends software encoded video on every connection, returns the RTP packets sent per second by all of them
+    double MeasurePacketRate(bool dedicatedNetworkThread, int connections, int64 durationUs)
+    {
+        FactoryResources::SetDedicatedNetworkThread(dedicatedNetworkThread);
+        const auto resources = FactoryResources::Create(UnityEncoderType::UnityEncoderSoftware);
+        FactoryResources::SetDedicatedNetworkThread(true);
+
+        rtc::scoped_refptr<NoiseVideoSource> source = new rtc::RefCountedObject<NoiseVideoSource>();
+        const auto track = resources->Factory()->CreateVideoTrack("benchmark", source);
+        std::vector<std::pair<std::unique_ptr<LoopbackPeer>, std::unique_ptr<LoopbackPeer>>> peers;
+        for (int i = 0; i < connections; i++)
+        {
+            auto offerer = std::make_unique<LoopbackPeer>(resources->Factory());
+            auto answerer = std::make_unique<LoopbackPeer>(resources->Factory());
+            const auto sender = offerer->connection->AddTrack(track, { "benchmark" });
+            EXPECT_TRUE(sender.ok());
+            EXPECT_TRUE(ConnectLoopback(*offerer, *answerer, "benchmark"));
+            //skip the bandwidth estimation ramp up, the encoders start at a high bitrate
+            webrtc::BitrateSettings bitrate;
+            bitrate.min_bitrate_bps = MinBitrateBps;
+            bitrate.start_bitrate_bps = MinBitrateBps;
+            bitrate.max_bitrate_bps = MaxBitrateBps;
+            offerer->connection->SetBitrate(bitrate);
+            if (sender.ok())
+            {
+                webrtc::RtpParameters parameters = sender.value()->GetParameters();
+                for (auto& encoding : parameters.encodings)
+                {
+                    encoding.max_bitrate_bps = MaxBitrateBps;
+                }
+                sender.value()->SetParameters(parameters);
+            }
+            peers.emplace_back(std::move(offerer), std::move(answerer));
+        }
+
+        //let the encoders settle before counting
+        PushFrames(*source, rtc::kNumMicrosecsPerSec);
+        uint64 startPackets = 0;
+        for (auto& pair : peers)
+        {
+            startPackets += CountPacketsSent(pair.first->connection);
+        }
+        const int64 start = rtc::TimeMicros();
+        PushFrames(*source, durationUs);
+        uint64 endPackets = 0;
+        for (auto& pair : peers)
+        {
+            endPackets += CountPacketsSent(pair.first->connection);
+        }
+        const int64 elapsedUs = rtc::TimeMicros() - start;
+        EXPECT_LT(startPackets, endPackets);
+        return static_cast<double>(endPackets - startPackets) * rtc::kNumMicrosecsPerSec / elapsedUs;
+    }
+}
+
+TEST(FactoryResourcesTest, DedicatedNetworkThread) {
+    const auto resources = FactoryResources::Create(UnityEncoderType::UnityEncoderSoftware);
+    EXPECT_NE(resources->WorkerThread(), resources->NetworkThread());
+
+    FactoryResources::SetDedicatedNetworkThread(false);
+    const auto combined = FactoryResources::Create(UnityEncoderType::UnityEncoderSoftware);
+    FactoryResources::SetDedicatedNetworkThread(true);
+    EXPECT_EQ(combined->WorkerThread(), combined->NetworkThread());
+}
+
+//a benchmark, run it with --gtest_also_run_disabled_tests
+TEST(FactoryResourcesTest, DISABLED_BenchmarkOutboundPacketRate) {
+    const int64 durationUs = 5 * rtc::kNumMicrosecsPerSec;
+    for (int connections : { 1, 4, 8 })
+    {
+        for (bool dedicated : { false, true })
+        {
+            const double packetsPerSecond = MeasurePacketRate(dedicated, connections, durationUs);
+            const std::string name = std::string(dedicated ? "NetworkThread" : "WorkerThread")
+                + "PacketsPerSecond_" + std::to_string(connections) + "PC";
+            RecordProperty(name, std::to_string(packetsPerSecond));
+        }
+    }
+}
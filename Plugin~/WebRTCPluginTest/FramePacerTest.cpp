@@ -0,0 +1,68 @@
+#include "pch.h"
+#include "../WebRTCPlugin/FramePacer.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    int CountEncodedFrames(FramePacer& pacer, int inputFramerate, int seconds)
+    {
+        const int64 intervalUs = rtc::kNumMicrosecsPerSec / inputFramerate;
+        int encoded = 0;
+        for (int64 i = 0; i < inputFramerate * seconds; i++)
+        {
+            if (pacer.ShouldEncodeFrame(i * intervalUs))
+            {
+                encoded++;
+            }
+        }
+        return encoded;
+    }
+}
+
+TEST(FramePacerTest, PassesThroughWhenUnderTarget) {
+    FramePacer pacer(60);
+    EXPECT_EQ(30, CountEncodedFrames(pacer, 30, 1));
+    EXPECT_EQ(0u, pacer.GetDroppedFrameCount());
+}
+
+TEST(FramePacerTest, DropsSurplusFrames) {
+    FramePacer pacer(60);
+    pacer.SetEncoderFramerate(30);
+    const int encoded = CountEncodedFrames(pacer, 144, 10);
+    EXPECT_NEAR(300, encoded, 2);
+    EXPECT_EQ(static_cast<uint64>(1440 - encoded), pacer.GetDroppedFrameCount());
+}
+
+TEST(FramePacerTest, TargetIsLowestConstraint) {
+    FramePacer pacer(60);
+    EXPECT_EQ(60, pacer.GetTargetFramerate());
+    pacer.SetEncoderFramerate(30);
+    EXPECT_EQ(30, pacer.GetTargetFramerate());
+    pacer.SetSinkFramerate(15);
+    EXPECT_EQ(15, pacer.GetTargetFramerate());
+    pacer.SetSinkFramerate(std::numeric_limits<int>::max());
+    pacer.SetEncoderFramerate(0);
+    EXPECT_EQ(60, pacer.GetTargetFramerate());
+}
+
+TEST(FramePacerTest, KeepsIntervalsEven) {
+    FramePacer pacer(60);
+    pacer.SetEncoderFramerate(30);
+    const int64 inputIntervalUs = rtc::kNumMicrosecsPerSec / 144;
+    std::vector<int64> encoded;
+    for (int64 i = 0; i < 144; i++)
+    {
+        const int64 timestampUs = i * inputIntervalUs;
+        if (pacer.ShouldEncodeFrame(timestampUs))
+        {
+            encoded.push_back(timestampUs);
+        }
+    }
+    //the first interval is shortened by the half interval offset of the grid,
+    //afterwards the output can only deviate by one input interval from 1/30s
+    for (size_t i = 2; i < encoded.size(); i++)
+    {
+        EXPECT_NEAR(rtc::kNumMicrosecsPerSec / 30, encoded[i] - encoded[i - 1], inputIntervalUs);
+    }
+}
@@ -0,0 +1,99 @@
+#include "pch.h"
+#include "../WebRTCPlugin/FrameTrace.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    int CountEvents(const std::string& json, const std::string& name)
+    {
+        const std::string key = "\"name\":\"" + name + "\"";
+        int count = 0;
+        for (size_t pos = json.find(key); pos != std::string::npos; pos = json.find(key, pos + 1))
+        {
+            count++;
+        }
+        return count;
+    }
+
+    class FrameTraceTest : public testing::Test
+    {
+    protected:
+        void SetUp() override { FrameTrace::Clear(); }
+        void TearDown() override
+        {
+            FrameTrace::SetEnabled(false);
+            FrameTrace::Clear();
+        }
+    };
+}
+
+TEST_F(FrameTraceTest, DisabledRecordsNothing) {
+    {
+        ScopedTrace trace("EncodeFrame");
+    }
+    std::string json;
+    FrameTrace::Dump(rtc::kNumMicrosecsPerSec, json);
+    EXPECT_EQ("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}", json);
+}
+
+TEST_F(FrameTraceTest, RecordsScopes) {
+    FrameTrace::SetEnabled(true);
+    {
+        ScopedTrace outer("OnRenderEvent", 1234);
+        ScopedTrace inner("EncodeFrame");
+    }
+    std::string json;
+    FrameTrace::Dump(rtc::kNumMicrosecsPerSec, json);
+    EXPECT_EQ(1, CountEvents(json, "OnRenderEvent"));
+    EXPECT_EQ(1, CountEvents(json, "EncodeFrame"));
+    EXPECT_NE(std::string::npos, json.find("\"frameUs\":1234"));
+}
+
+TEST_F(FrameTraceTest, KeepsLatestEventsOfEachThread) {
+    FrameTrace::SetEnabled(true);
+    const int64 nowUs = rtc::TimeMicros();
+    for (size_t i = 0; i < FrameTrace::EventsPerThread + 10; i++)
+    {
+        FrameTrace::Record(i < 10 ? "Old" : "New", nowUs, nowUs + 1, 0);
+    }
+    std::thread thread([nowUs]() { FrameTrace::Record("OnEncodedImage", nowUs, nowUs + 1, 0); });
+    thread.join();
+
+    std::string json;
+    FrameTrace::Dump(rtc::kNumMicrosecsPerSec, json);
+    EXPECT_EQ(0, CountEvents(json, "Old"));
+    EXPECT_EQ(static_cast<int>(FrameTrace::EventsPerThread), CountEvents(json, "New"));
+    //events of a thread that has exited are still dumped
+    EXPECT_EQ(1, CountEvents(json, "OnEncodedImage"));
+}
+
+TEST_F(FrameTraceTest, DumpsWindow) {
+    FrameTrace::SetEnabled(true);
+    const int64 nowUs = rtc::TimeMicros();
+    FrameTrace::Record("CaptureFrame", nowUs - 10 * rtc::kNumMicrosecsPerSec, nowUs, 0);
+    FrameTrace::Record("OnFrame", nowUs, nowUs, 0);
+    std::string json;
+    FrameTrace::Dump(rtc::kNumMicrosecsPerSec, json);
+    EXPECT_EQ(0, CountEvents(json, "CaptureFrame"));
+    EXPECT_EQ(1, CountEvents(json, "OnFrame"));
+}
+
+TEST_F(FrameTraceTest, DumpWhileRecording) {
+    FrameTrace::SetEnabled(true);
+    std::atomic<bool> running { true };
+    std::thread writer([&running]() {
+        while (running)
+        {
+            ScopedTrace trace("DummyVideoEncoder::Encode");
+        }
+    });
+    std::string json;
+    for (int i = 0; i < 100; i++)
+    {
+        FrameTrace::Dump(rtc::kNumMicrosecsPerSec, json);
+        EXPECT_LE(CountEvents(json, "DummyVideoEncoder::Encode"), static_cast<int>(FrameTrace::EventsPerThread));
+    }
+    running = false;
+    writer.join();
+}
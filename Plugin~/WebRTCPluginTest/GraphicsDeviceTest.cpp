@@ -51,6 +51,19 @@ TEST_P(GraphicsDeviceTest, CopyResourceNativeV) {
     EXPECT_TRUE(m_device->CopyResourceFromNativeV(dst, src->GetEncodeTexturePtrV()));
     EXPECT_FALSE(m_device->CopyResourceFromNativeV(dst, dst->GetEncodeTexturePtrV()));
 }
+
+TEST_P(GraphicsDeviceTest, ScaleResourceFromNativeV) {
+    const auto width = 256;
+    const auto height = 256;
+    const auto src = m_device->CreateDefaultTextureV(width, height);
+    const auto dst = m_device->CreateDefaultTextureV(width, height);
+    const auto half = m_device->CreateDefaultTextureV(width / 2, height / 2);
+    const auto quarter = m_device->CreateDefaultTextureV(width / 4, height / 4);
+    EXPECT_TRUE(m_device->ScaleResourceFromNativeV(dst, src->GetEncodeTexturePtrV()));
+    EXPECT_TRUE(m_device->ScaleResourceFromNativeV(half, src->GetEncodeTexturePtrV()));
+    EXPECT_TRUE(m_device->ScaleResourceFromNativeV(quarter, src->GetEncodeTexturePtrV()));
+    EXPECT_FALSE(m_device->ScaleResourceFromNativeV(dst, dst->GetEncodeTexturePtrV()));
+}
 #endif
 
 INSTANTIATE_TEST_CASE_P(GraphicsDeviceParameters, GraphicsDeviceTest, ValuesIn(VALUES_TEST_ENV));
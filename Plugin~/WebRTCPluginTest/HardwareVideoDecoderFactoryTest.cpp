@@ -0,0 +1,144 @@
+#include "pch.h"
+#include "../WebRTCPlugin/HardwareVideoDecoderFactory.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    const char* const StubDecoderName = "StubHardwareDecoder";
+
+    //stands in for a hardware decoder so the hardware path can be tested on any machine
+    class StubVideoDecoder : public webrtc::VideoDecoder
+    {
+    public:
+        explicit StubVideoDecoder(bool failInit) : failInit(failInit) {}
+
+        int32_t InitDecode(const webrtc::VideoCodec* codecSettings, int32_t numberOfCores) override
+        {
+            if (failInit)
+                return WEBRTC_VIDEO_CODEC_ERROR;
+            width = codecSettings->width;
+            height = codecSettings->height;
+            return WEBRTC_VIDEO_CODEC_OK;
+        }
+        int32_t Decode(const webrtc::EncodedImage& inputImage, bool missingFrames, int64_t renderTimeMs) override
+        {
+            rtc::scoped_refptr<webrtc::I420Buffer> buffer = webrtc::I420Buffer::Create(width, height);
+            webrtc::I420Buffer::SetBlack(buffer);
+            webrtc::VideoFrame frame = webrtc::VideoFrame::Builder()
+                .set_video_frame_buffer(buffer)
+                .set_timestamp_rtp(inputImage.Timestamp())
+                .build();
+            callback->Decoded(frame, absl::nullopt, absl::nullopt);
+            return WEBRTC_VIDEO_CODEC_OK;
+        }
+        int32_t RegisterDecodeCompleteCallback(webrtc::DecodedImageCallback* decodeCompleteCallback) override
+        {
+            callback = decodeCompleteCallback;
+            return WEBRTC_VIDEO_CODEC_OK;
+        }
+        int32_t Release() override { return WEBRTC_VIDEO_CODEC_OK; }
+        const char* ImplementationName() const override { return StubDecoderName; }
+
+    private:
+        const bool failInit;
+        int width = 0;
+        int height = 0;
+        webrtc::DecodedImageCallback* callback = nullptr;
+    };
+
+    class StubDecoderBackend : public IHardwareDecoderBackend
+    {
+    public:
+        explicit StubDecoderBackend(bool failInit) : failInit(failInit) {}
+        const char* GetName() const override { return "Stub"; }
+        bool IsSupported(const webrtc::SdpVideoFormat& format) const override
+        {
+            return format.name == cricket::kVp8CodecName;
+        }
+        std::unique_ptr<webrtc::VideoDecoder> CreateDecoder(const webrtc::SdpVideoFormat& format) override
+        {
+            return std::make_unique<StubVideoDecoder>(failInit);
+        }
+    private:
+        const bool failInit;
+    };
+
+    class FrameCounter : public webrtc::DecodedImageCallback
+    {
+    public:
+        int32_t Decoded(webrtc::VideoFrame& decodedImage) override
+        {
+            count++;
+            return WEBRTC_VIDEO_CODEC_OK;
+        }
+        int count = 0;
+    };
+
+    webrtc::VideoCodec CreateCodecSettings(webrtc::VideoCodecType type)
+    {
+        webrtc::VideoCodec codec;
+        codec.codecType = type;
+        codec.width = 320;
+        codec.height = 240;
+        return codec;
+    }
+}
+
+class HardwareVideoDecoderFactoryTest : public testing::Test
+{
+protected:
+    HardwareVideoDecoderFactory factory { webrtc::CreateBuiltinVideoDecoderFactory() };
+};
+
+TEST_F(HardwareVideoDecoderFactoryTest, SoftwareWithoutBackend) {
+    auto formats = factory.GetSupportedFormats();
+    EXPECT_NE(formats.end(), std::find(formats.begin(), formats.end(), webrtc::SdpVideoFormat(cricket::kVp8CodecName)));
+    auto decoder = factory.CreateVideoDecoder(webrtc::SdpVideoFormat(cricket::kVp8CodecName));
+    ASSERT_NE(nullptr, decoder);
+    EXPECT_STRNE(StubDecoderName, decoder->ImplementationName());
+}
+
+TEST_F(HardwareVideoDecoderFactoryTest, DecodeWithHardwareBackend) {
+    factory.AddBackend(std::make_unique<StubDecoderBackend>(false));
+    auto decoder = factory.CreateVideoDecoder(webrtc::SdpVideoFormat(cricket::kVp8CodecName));
+    ASSERT_NE(nullptr, decoder);
+    FrameCounter counter;
+    decoder->RegisterDecodeCompleteCallback(&counter);
+    const webrtc::VideoCodec codec = CreateCodecSettings(webrtc::kVideoCodecVP8);
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder->InitDecode(&codec, 1));
+    EXPECT_STREQ(StubDecoderName, decoder->ImplementationName());
+
+    webrtc::EncodedImage image;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        image.SetTimestamp(i * 3000);
+        EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder->Decode(image, false, 0));
+    }
+    EXPECT_EQ(3, counter.count);
+    const VideoDecoderStats stats = factory.GetStats();
+    EXPECT_EQ(3u, stats.decodedFrames);
+    EXPECT_EQ(3u, stats.hardwareDecodedFrames);
+    EXPECT_EQ(0u, stats.fallbackCount);
+    EXPECT_GE(stats.totalDecodeTimeUs, stats.maxDecodeTimeUs);
+    decoder->Release();
+}
+
+TEST_F(HardwareVideoDecoderFactoryTest, FallbackToSoftware) {
+    factory.AddBackend(std::make_unique<StubDecoderBackend>(true));
+    auto decoder = factory.CreateVideoDecoder(webrtc::SdpVideoFormat(cricket::kVp8CodecName));
+    ASSERT_NE(nullptr, decoder);
+    const webrtc::VideoCodec codec = CreateCodecSettings(webrtc::kVideoCodecVP8);
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder->InitDecode(&codec, 1));
+    EXPECT_STRNE(StubDecoderName, decoder->ImplementationName());
+    EXPECT_EQ(1u, factory.GetStats().fallbackCount);
+    decoder->Release();
+}
+
+TEST_F(HardwareVideoDecoderFactoryTest, UnsupportedFormatUsesSoftware) {
+    factory.AddBackend(std::make_unique<StubDecoderBackend>(false));
+    auto decoder = factory.CreateVideoDecoder(webrtc::SdpVideoFormat(cricket::kVp9CodecName));
+    ASSERT_NE(nullptr, decoder);
+    EXPECT_STRNE(StubDecoderName, decoder->ImplementationName());
+    EXPECT_EQ(0u, factory.GetStats().fallbackCount);
+}
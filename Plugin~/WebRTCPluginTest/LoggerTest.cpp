@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "../WebRTCPlugin/Logger.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    bool Push(LogQueue& queue, LogLevel level, const char* fmt, ...)
+    {
+        va_list args;
+        va_start(args, fmt);
+        const bool result = queue.Push(level, fmt, args);
+        va_end(args);
+        return result;
+    }
+
+    void DrainAll()
+    {
+        LogRecord records[16];
+        while (DrainLog(records, 16) > 0)
+        {
+        }
+    }
+}
+
+TEST(LogQueueTest, PopsInOrder) {
+    std::unique_ptr<LogQueue> queue = std::make_unique<LogQueue>();
+    LogRecord record;
+    EXPECT_FALSE(queue->Pop(&record));
+    EXPECT_TRUE(Push(*queue, LogLevel::Warning, "frame %d", 1));
+    EXPECT_TRUE(Push(*queue, LogLevel::Error, "frame %d", 2));
+    ASSERT_TRUE(queue->Pop(&record));
+    EXPECT_EQ(LogLevel::Warning, record.level);
+    EXPECT_STREQ("frame 1", record.message);
+    ASSERT_TRUE(queue->Pop(&record));
+    EXPECT_EQ(LogLevel::Error, record.level);
+    EXPECT_STREQ("frame 2", record.message);
+    EXPECT_FALSE(queue->Pop(&record));
+}
+
+TEST(LogQueueTest, TruncatesLongMessages) {
+    std::unique_ptr<LogQueue> queue = std::make_unique<LogQueue>();
+    const std::string message(MaxLogMessageSize * 2, 'a');
+    Push(*queue, LogLevel::Info, "%s", message.c_str());
+    LogRecord record;
+    ASSERT_TRUE(queue->Pop(&record));
+    EXPECT_EQ(static_cast<size_t>(MaxLogMessageSize - 1), strlen(record.message));
+}
+
+TEST(LogQueueTest, DropsWhenFull) {
+    std::unique_ptr<LogQueue> queue = std::make_unique<LogQueue>();
+    for (size_t i = 0; i < LogQueue::Capacity; i++)
+    {
+        EXPECT_TRUE(Push(*queue, LogLevel::Info, "%zu", i));
+    }
+    EXPECT_FALSE(Push(*queue, LogLevel::Info, "dropped"));
+    EXPECT_EQ(1u, queue->GetDroppedCount());
+    LogRecord record;
+    ASSERT_TRUE(queue->Pop(&record));
+    EXPECT_STREQ("0", record.message);
+    EXPECT_TRUE(Push(*queue, LogLevel::Info, "again"));
+}
+
+TEST(LogQueueTest, ConcurrentProducers) {
+    std::unique_ptr<LogQueue> queue = std::make_unique<LogQueue>();
+    const int threadCount = 4;
+    const int messagesPerThread = 10000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threadCount; t++)
+    {
+        producers.emplace_back([&queue, t]() {
+            for (int i = 0; i < messagesPerThread; i++)
+            {
+                while (!Push(*queue, LogLevel::Info, "%d %d", t, i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    //each producer's messages come out in order
+    std::vector<int> next(threadCount, 0);
+    int received = 0;
+    LogRecord record;
+    while (received < threadCount * messagesPerThread)
+    {
+        if (!queue->Pop(&record))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        int t = 0, i = 0;
+        ASSERT_EQ(2, sscanf(record.message, "%d %d", &t, &i));
+        ASSERT_EQ(next[t], i);
+        next[t]++;
+        received++;
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+}
+
+TEST(LoggerTest, FiltersByLevel) {
+    DrainAll();
+    SetLogLevel(LogLevel::Warning);
+    int evaluated = 0;
+    WEBRTC_LOG(LogLevel::Info, "skipped %d", ++evaluated);
+    WEBRTC_LOG(LogLevel::Error, "logged %d", ++evaluated);
+    //the arguments of a skipped message are not evaluated
+    EXPECT_EQ(1, evaluated);
+
+    LogRecord records[4];
+    ASSERT_EQ(1, DrainLog(records, 4));
+    EXPECT_EQ(LogLevel::Error, records[0].level);
+    EXPECT_STREQ("logged 1", records[0].message);
+
+    SetLogLevel(LogLevel::None);
+    WEBRTC_LOG(LogLevel::Error, "skipped");
+    EXPECT_EQ(0, DrainLog(records, 4));
+    SetLogLevel(LogLevel::Warning);
+}
@@ -0,0 +1,149 @@
+#include "pch.h"
+#include "LoopbackPeer.h"
+
+namespace
+{
+    class CreateDescriptionObserver : public webrtc::CreateSessionDescriptionObserver
+    {
+    public:
+        void OnSuccess(webrtc::SessionDescriptionInterface* desc) override
+        {
+            description.reset(desc);
+            done.Set();
+        }
+        void OnFailure(webrtc::RTCError error) override
+        {
+            done.Set();
+        }
+        std::unique_ptr<webrtc::SessionDescriptionInterface> description;
+        rtc::Event done;
+    };
+
+    class SetDescriptionObserver : public webrtc::SetSessionDescriptionObserver
+    {
+    public:
+        void OnSuccess() override
+        {
+            succeeded = true;
+            done.Set();
+        }
+        void OnFailure(const std::string& error) override
+        {
+            done.Set();
+        }
+        bool succeeded = false;
+        rtc::Event done;
+    };
+
+    std::unique_ptr<webrtc::SessionDescriptionInterface> CreateDescription(LoopbackPeer& peer, webrtc::SdpType type)
+    {
+        rtc::scoped_refptr<CreateDescriptionObserver> observer = new rtc::RefCountedObject<CreateDescriptionObserver>();
+        if (type == webrtc::SdpType::kOffer)
+        {
+            peer.connection->CreateOffer(observer, webrtc::PeerConnectionInterface::RTCOfferAnswerOptions());
+        }
+        else
+        {
+            peer.connection->CreateAnswer(observer, webrtc::PeerConnectionInterface::RTCOfferAnswerOptions());
+        }
+        observer->done.Wait(LoopbackPeer::TimeoutMs);
+        return std::move(observer->description);
+    }
+
+    bool SetDescription(LoopbackPeer& peer, std::unique_ptr<webrtc::SessionDescriptionInterface> desc, bool local)
+    {
+        if (desc == nullptr)
+        {
+            return false;
+        }
+        rtc::scoped_refptr<SetDescriptionObserver> observer = new rtc::RefCountedObject<SetDescriptionObserver>();
+        if (local)
+        {
+            peer.connection->SetLocalDescription(observer, desc.release());
+        }
+        else
+        {
+            peer.connection->SetRemoteDescription(observer, desc.release());
+        }
+        return observer->done.Wait(LoopbackPeer::TimeoutMs) && observer->succeeded;
+    }
+
+    //the local description with every gathered candidate, so that no candidate has to be trickled
+    std::unique_ptr<webrtc::SessionDescriptionInterface> CopyLocalDescription(LoopbackPeer& peer)
+    {
+        if (!peer.gathered.Wait(LoopbackPeer::TimeoutMs))
+        {
+            return nullptr;
+        }
+        const webrtc::SessionDescriptionInterface* desc = peer.connection->local_description();
+        std::string sdp;
+        desc->ToString(&sdp);
+        return webrtc::CreateSessionDescription(desc->GetType(), sdp);
+    }
+}
+
+LoopbackPeer::LoopbackPeer(webrtc::PeerConnectionFactoryInterface* factory)
+{
+    webrtc::PeerConnectionInterface::RTCConfiguration config;
+    config.sdp_semantics = webrtc::SdpSemantics::kUnifiedPlan;
+    connection = factory->CreatePeerConnection(config, nullptr, nullptr, this);
+}
+
+LoopbackPeer::~LoopbackPeer()
+{
+    if (GetChannel() != nullptr)
+    {
+        GetChannel()->UnregisterObserver();
+    }
+    connection->Close();
+}
+
+void LoopbackPeer::CreateChannel(const std::string& label)
+{
+    webrtc::DataChannelInit init;
+    SetChannel(connection->CreateDataChannel(label, &init));
+}
+
+rtc::scoped_refptr<webrtc::DataChannelInterface> LoopbackPeer::GetChannel()
+{
+    std::lock_guard<std::mutex> lock(channelMutex);
+    return channel;
+}
+
+void LoopbackPeer::OnIceGatheringChange(webrtc::PeerConnectionInterface::IceGatheringState new_state)
+{
+    if (new_state == webrtc::PeerConnectionInterface::kIceGatheringComplete)
+    {
+        gathered.Set();
+    }
+}
+
+void LoopbackPeer::OnStateChange()
+{
+    const auto current = GetChannel();
+    if (current != nullptr && current->state() == webrtc::DataChannelInterface::kOpen)
+    {
+        opened.Set();
+    }
+}
+
+void LoopbackPeer::SetChannel(rtc::scoped_refptr<webrtc::DataChannelInterface> value)
+{
+    {
+        std::lock_guard<std::mutex> lock(channelMutex);
+        channel = value;
+    }
+    value->RegisterObserver(this);
+    OnStateChange();
+}
+
+bool ConnectLoopback(LoopbackPeer& offerer, LoopbackPeer& answerer, const std::string& label)
+{
+    offerer.CreateChannel(label);
+    return SetDescription(offerer, CreateDescription(offerer, webrtc::SdpType::kOffer), true)
+        && SetDescription(answerer, CopyLocalDescription(offerer), false)
+        && SetDescription(answerer, CreateDescription(answerer, webrtc::SdpType::kAnswer), true)
+        && SetDescription(offerer, CopyLocalDescription(answerer), false)
+        && offerer.opened.Wait(LoopbackPeer::TimeoutMs)
+        && answerer.opened.Wait(LoopbackPeer::TimeoutMs);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include "api/peer_connection_interface.h"
+#include "rtc_base/event.h"
+
+//one end of a loopback connection with a single data channel, counts the bytes it receives
+class LoopbackPeer : public webrtc::PeerConnectionObserver, public webrtc::DataChannelObserver
+{
+public:
+    static const int TimeoutMs = 10000;
+
+    explicit LoopbackPeer(webrtc::PeerConnectionFactoryInterface* factory);
+    ~LoopbackPeer() override;
+
+    void CreateChannel(const std::string& label);
+    rtc::scoped_refptr<webrtc::DataChannelInterface> GetChannel();
+
+    //webrtc::PeerConnectionObserver
+    void OnSignalingChange(webrtc::PeerConnectionInterface::SignalingState new_state) override {}
+    void OnDataChannel(rtc::scoped_refptr<webrtc::DataChannelInterface> data_channel) override { SetChannel(data_channel); }
+    void OnRenegotiationNeeded() override {}
+    void OnIceConnectionChange(webrtc::PeerConnectionInterface::IceConnectionState new_state) override {}
+    void OnIceGatheringChange(webrtc::PeerConnectionInterface::IceGatheringState new_state) override;
+    void OnIceCandidate(const webrtc::IceCandidateInterface* candidate) override {}
+
+    //webrtc::DataChannelObserver
+    void OnStateChange() override;
+    void OnMessage(const webrtc::DataBuffer& buffer) override { bytesReceived += buffer.size(); }
+
+    rtc::scoped_refptr<webrtc::PeerConnectionInterface> connection;
+    rtc::Event gathered;
+    rtc::Event opened;
+    std::atomic<uint64_t> bytesReceived { 0 };
+
+private:
+    void SetChannel(rtc::scoped_refptr<webrtc::DataChannelInterface> value);
+
+    rtc::scoped_refptr<webrtc::DataChannelInterface> channel;
+    std::mutex channelMutex;
+};
+
+//negotiates the connection without trickling candidates and waits for the data channel to open on both ends
+bool ConnectLoopback(LoopbackPeer& offerer, LoopbackPeer& answerer, const std::string& label);
@@ -35,7 +35,7 @@ TEST_P(NvEncoderTest, CopyBuffer) {
     const auto width = 256;
     const auto height = 256;
     auto tex = m_device->CreateDefaultTextureV(width, height);
-    const auto result = encoder_->CopyBuffer(tex->GetEncodeTexturePtrV());
+    const auto result = encoder_->CopyBuffer(tex->GetEncodeTexturePtrV(), rtc::TimeMicros());
     EXPECT_TRUE(result);
 }
 
@@ -46,4 +46,50 @@ TEST_P(NvEncoderTest, EncodeFrame) {
     EXPECT_EQ(before + 1, after);
 }
 
+TEST_P(NvEncoderTest, CountsEncodedFrames) {
+    auto tex = m_device->CreateDefaultTextureV(256, 256);
+    EXPECT_TRUE(encoder_->CopyBuffer(tex->GetEncodeTexturePtrV(), rtc::TimeMicros()));
+    encoder_->SetIdrFrame();
+    EXPECT_TRUE(encoder_->EncodeFrame());
+    const EncoderStats stats = encoder_->GetStats();
+    EXPECT_EQ(1u, stats.framesSubmitted);
+    EXPECT_EQ(1u, stats.framesEncoded);
+    EXPECT_EQ(0u, stats.framesDropped);
+    EXPECT_EQ(1u, stats.forcedIdrFrames);
+    EXPECT_GT(stats.p99EncodeTimeUs, 0.0);
+}
+
+TEST_P(NvEncoderTest, RateFollowsTargetBothWays) {
+    encoder_->SetRate(6000000);
+    EXPECT_TRUE(encoder_->EncodeFrame());
+    EXPECT_EQ(1u, encoder_->GetStats().reconfigures);
+    //a raised target is applied too, not only lowered ones
+    encoder_->SetRate(8000000);
+    EXPECT_TRUE(encoder_->EncodeFrame());
+    EXPECT_EQ(2u, encoder_->GetStats().reconfigures);
+    //the floor still applies
+    encoder_->SetRate(1000);
+    EXPECT_TRUE(encoder_->EncodeFrame());
+    EXPECT_EQ(3u, encoder_->GetStats().reconfigures);
+}
+
+class CaptureFrameReceiver : public sigslot::has_slots<>
+{
+public:
+    void OnCaptureFrame(webrtc::VideoFrame& frame) { timestampUs = frame.timestamp_us(); }
+    int64 timestampUs = 0;
+};
+
+TEST_P(NvEncoderTest, CaptureTimeIsPropagated) {
+    const auto width = 256;
+    const auto height = 256;
+    auto tex = m_device->CreateDefaultTextureV(width, height);
+    CaptureFrameReceiver receiver;
+    encoder_->CaptureFrame.connect(&receiver, &CaptureFrameReceiver::OnCaptureFrame);
+    const int64 captureTimeUs = rtc::TimeMicros();
+    EXPECT_TRUE(encoder_->CopyBuffer(tex->GetEncodeTexturePtrV(), captureTimeUs));
+    EXPECT_TRUE(encoder_->EncodeFrame());
+    EXPECT_EQ(captureTimeUs, receiver.timestampUs);
+}
+
 INSTANTIATE_TEST_CASE_P( GraphicsDeviceParameters, NvEncoderTest, ValuesIn(VALUES_TEST_ENV));
@@ -0,0 +1,127 @@
+#include "pch.h"
+#include "../WebRTCPlugin/OpusSettings.h"
+#include "pc/session_description.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    const char* const AudioOffer =
+        "v=0\r\n"
+        "o=- 0 2 IN IP4 127.0.0.1\r\n"
+        "s=-\r\n"
+        "t=0 0\r\n"
+        "a=group:BUNDLE 0 1\r\n"
+        "m=audio 9 UDP/TLS/RTP/SAVPF 111\r\n"
+        "c=IN IP4 0.0.0.0\r\n"
+        "a=ice-ufrag:ufrag\r\n"
+        "a=ice-pwd:passwordpasswordpassword\r\n"
+        "a=fingerprint:sha-256 00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00\r\n"
+        "a=setup:actpass\r\n"
+        "a=mid:0\r\n"
+        "a=sendrecv\r\n"
+        "a=rtcp-mux\r\n"
+        "a=rtpmap:111 opus/48000/2\r\n"
+        "a=fmtp:111 minptime=10;useinbandfec=1\r\n"
+        "m=audio 9 UDP/TLS/RTP/SAVPF 111\r\n"
+        "c=IN IP4 0.0.0.0\r\n"
+        "a=ice-ufrag:ufrag\r\n"
+        "a=ice-pwd:passwordpasswordpassword\r\n"
+        "a=fingerprint:sha-256 00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00:00\r\n"
+        "a=setup:actpass\r\n"
+        "a=mid:1\r\n"
+        "a=sendrecv\r\n"
+        "a=rtcp-mux\r\n"
+        "a=rtpmap:111 opus/48000/2\r\n"
+        "a=fmtp:111 minptime=10;useinbandfec=1\r\n";
+
+    OpusSettings CreateLowLatencySettings()
+    {
+        OpusSettings settings;
+        settings.bitrate = 32000;
+        settings.frameSizeMs = 10;
+        settings.inbandFec = false;
+        settings.dtx = true;
+        settings.stereo = true;
+        settings.complexity = 3;
+        return settings;
+    }
+
+    const cricket::AudioCodec& GetOpusCodec(webrtc::SessionDescriptionInterface* desc, const std::string& mid)
+    {
+        return desc->description()->GetContentDescriptionByName(mid)->as_audio()->codecs()[0];
+    }
+}
+
+TEST(OpusSettingsTest, ApplyToCodec) {
+    cricket::AudioCodec codec(111, cricket::kOpusCodecName, 48000, 0, 2);
+    codec.SetParam(cricket::kCodecParamMinPTime, 20);
+    ApplyOpusSettings(CreateLowLatencySettings(), &codec);
+
+    int value = 0;
+    EXPECT_TRUE(codec.GetParam(cricket::kCodecParamMaxAverageBitrate, &value));
+    EXPECT_EQ(32000, value);
+    EXPECT_TRUE(codec.GetParam(cricket::kCodecParamPTime, &value));
+    EXPECT_EQ(10, value);
+    //widened so the frame size is allowed
+    EXPECT_TRUE(codec.GetParam(cricket::kCodecParamMinPTime, &value));
+    EXPECT_EQ(10, value);
+    EXPECT_TRUE(codec.GetParam(cricket::kCodecParamUseInbandFec, &value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(codec.GetParam(cricket::kCodecParamUseDtx, &value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(codec.GetParam(cricket::kCodecParamStereo, &value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(codec.GetParam(OpusComplexityParameter, &value));
+    EXPECT_EQ(3, value);
+}
+
+TEST(OpusSettingsTest, DefaultsKeepNegotiatedValues) {
+    cricket::AudioCodec codec(111, cricket::kOpusCodecName, 48000, 0, 2);
+    ApplyOpusSettings(OpusSettings(), &codec);
+    int value = 0;
+    EXPECT_FALSE(codec.GetParam(cricket::kCodecParamMaxAverageBitrate, &value));
+    EXPECT_FALSE(codec.GetParam(cricket::kCodecParamPTime, &value));
+    EXPECT_FALSE(codec.GetParam(OpusComplexityParameter, &value));
+}
+
+TEST(OpusSettingsTest, ApplyToSingleSection) {
+    webrtc::SdpParseError error;
+    auto desc = webrtc::CreateSessionDescription(webrtc::SdpType::kAnswer, AudioOffer, &error);
+    ASSERT_NE(nullptr, desc) << error.description;
+
+    const OpusSettings settings = CreateLowLatencySettings();
+    std::vector<std::string> mids;
+    ApplyOpusSettings(desc.get(), [&](const std::string& mid) -> const OpusSettings*
+    {
+        mids.push_back(mid);
+        return mid == "1" ? &settings : nullptr;
+    });
+    EXPECT_EQ(std::vector<std::string>({ "0", "1" }), mids);
+
+    int value = 0;
+    EXPECT_FALSE(GetOpusCodec(desc.get(), "0").GetParam(cricket::kCodecParamUseDtx, &value));
+    EXPECT_TRUE(GetOpusCodec(desc.get(), "1").GetParam(cricket::kCodecParamUseDtx, &value));
+    EXPECT_EQ(1, value);
+}
+
+TEST(OpusSettingsTest, EncoderFollowsSettings) {
+    cricket::AudioCodec codec(111, cricket::kOpusCodecName, 48000, 0, 2);
+    ApplyOpusSettings(CreateLowLatencySettings(), &codec);
+    const webrtc::SdpAudioFormat format(codec.name, codec.clockrate, codec.channels, codec.params);
+
+    auto config = OpusAudioEncoderFactory::SdpToConfig(format);
+    ASSERT_TRUE(config);
+    EXPECT_EQ(3, config->complexity);
+    EXPECT_EQ(10, config->frame_size_ms);
+    EXPECT_TRUE(config->dtx_enabled);
+    EXPECT_FALSE(config->fec_enabled);
+
+    rtc::scoped_refptr<OpusAudioEncoderFactory> factory = new rtc::RefCountedObject<OpusAudioEncoderFactory>();
+    EXPECT_TRUE(factory->QueryAudioEncoder(format));
+    auto encoder = factory->MakeAudioEncoder(111, format, absl::nullopt);
+    ASSERT_NE(nullptr, encoder);
+    EXPECT_EQ(2u, encoder->NumChannels());
+    EXPECT_EQ(1u, encoder->Num10MsFramesInNextPacket());
+    EXPECT_EQ(32000, encoder->GetTargetBitrate());
+}
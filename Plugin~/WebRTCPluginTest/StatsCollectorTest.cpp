@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "api/stats/rtcstats_objects.h"
+#include "../WebRTCPlugin/StatsCollector.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    const StatsFilterEntry Entries[] =
+    {
+        { "outbound-rtp", "bytesSent", true },
+        { "outbound-rtp", "framesEncoded", false },
+        { "inbound-rtp", "packetsLost", false },
+        { "candidate-pair", "currentRoundTripTime", false },
+    };
+
+    rtc::scoped_refptr<webrtc::RTCStatsReport> CreateReport(int64 timestampUs, uint64 bytesSent)
+    {
+        auto report = webrtc::RTCStatsReport::Create(timestampUs);
+        for (uint32 ssrc = 1; ssrc <= 2; ssrc++)
+        {
+            auto outbound = std::make_unique<webrtc::RTCOutboundRTPStreamStats>("outbound" + std::to_string(ssrc), timestampUs);
+            outbound->ssrc = ssrc;
+            outbound->bytes_sent = bytesSent * ssrc;
+            outbound->frames_encoded = 30;
+            report->AddStats(std::move(outbound));
+        }
+        auto inbound = std::make_unique<webrtc::RTCInboundRTPStreamStats>("inbound", timestampUs);
+        inbound->ssrc = 3;
+        inbound->packets_lost = 5;
+        report->AddStats(std::move(inbound));
+        //no round trip time measured yet
+        report->AddStats(std::make_unique<webrtc::RTCIceCandidatePairStats>("pair", timestampUs));
+        return report;
+    }
+
+    const StatsValue* Find(const std::vector<StatsValue>& values, int32 entry, uint32 ssrc)
+    {
+        for (const StatsValue& value : values)
+        {
+            if (value.entry == entry && value.ssrc == ssrc)
+                return &value;
+        }
+        return nullptr;
+    }
+}
+
+TEST(StatsFilterTest, SelectsMembers) {
+    StatsFilter filter(Entries, 4);
+    std::vector<StatsValue> values;
+    filter.Apply(*CreateReport(1000000, 1000), values);
+    //no rate in the first report, no undefined member
+    ASSERT_EQ(3u, values.size());
+    ASSERT_NE(nullptr, Find(values, 1, 1));
+    EXPECT_EQ(30.0, Find(values, 1, 1)->value);
+    EXPECT_EQ(1000000, Find(values, 1, 1)->timestampUs);
+    ASSERT_NE(nullptr, Find(values, 1, 2));
+    ASSERT_NE(nullptr, Find(values, 2, 3));
+    EXPECT_EQ(5.0, Find(values, 2, 3)->value);
+    EXPECT_EQ(nullptr, Find(values, 3, 0));
+}
+
+TEST(StatsFilterTest, RatePerSecond) {
+    StatsFilter filter(Entries, 1);
+    std::vector<StatsValue> values;
+    filter.Apply(*CreateReport(1000000, 1000), values);
+    EXPECT_TRUE(values.empty());
+    //half a second later
+    filter.Apply(*CreateReport(1500000, 2000), values);
+    ASSERT_EQ(2u, values.size());
+    EXPECT_DOUBLE_EQ(2000.0, Find(values, 0, 1)->value);
+    EXPECT_DOUBLE_EQ(4000.0, Find(values, 0, 2)->value);
+}
+
+TEST(StatsFilterTest, ForgetsStatsMissingFromReport) {
+    StatsFilter filter(Entries, 1);
+    std::vector<StatsValue> values;
+    filter.Apply(*CreateReport(1000000, 1000), values);
+    //the streams went away with a renegotiation
+    filter.Apply(*webrtc::RTCStatsReport::Create(1500000), values);
+    EXPECT_TRUE(values.empty());
+    //streams with the same ids start over without a rate
+    filter.Apply(*CreateReport(2000000, 3000), values);
+    EXPECT_TRUE(values.empty());
+}
+
+TEST(FilteredStatsCollectorTest, GetValues) {
+    FilteredStatsCollector collector;
+    StatsValue values[2];
+    int64 timestampUs = -1;
+    EXPECT_EQ(0, collector.GetValues(values, 2, &timestampUs));
+    EXPECT_EQ(0, timestampUs);
+
+    //ignored without a filter
+    collector.OnStatsDelivered(CreateReport(1000000, 1000));
+    EXPECT_EQ(0, collector.GetValues(values, 2, &timestampUs));
+
+    collector.SetFilter(std::make_unique<StatsFilter>(Entries, 4));
+    collector.OnStatsDelivered(CreateReport(1000000, 1000));
+    //more values than the array holds
+    EXPECT_EQ(3, collector.GetValues(values, 2, &timestampUs));
+    EXPECT_EQ(1000000, timestampUs);
+    //in the order of the stats ids
+    EXPECT_EQ(2, values[0].entry);
+}
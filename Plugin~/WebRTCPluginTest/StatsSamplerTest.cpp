@@ -0,0 +1,113 @@
+#include "pch.h"
+#include "api/stats/rtcstats_objects.h"
+#include "../WebRTCPlugin/StatsSampler.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    struct Counters
+    {
+        uint64 bytesSent;
+        uint32 framesEncoded;
+        double totalEncodeTime;
+        uint64 bytesReceived;
+        uint32 packetsReceived;
+        int32 packetsLost;
+    };
+
+    rtc::scoped_refptr<webrtc::RTCStatsReport> CreateReport(int64 timestampUs, const Counters& counters)
+    {
+        auto report = webrtc::RTCStatsReport::Create(timestampUs);
+        auto outbound = std::make_unique<webrtc::RTCOutboundRTPStreamStats>("outbound", timestampUs);
+        outbound->bytes_sent = counters.bytesSent;
+        outbound->frames_encoded = counters.framesEncoded;
+        outbound->total_encode_time = counters.totalEncodeTime;
+        report->AddStats(std::move(outbound));
+        auto inbound = std::make_unique<webrtc::RTCInboundRTPStreamStats>("inbound", timestampUs);
+        inbound->bytes_received = counters.bytesReceived;
+        inbound->packets_received = counters.packetsReceived;
+        inbound->packets_lost = counters.packetsLost;
+        inbound->jitter = 0.02;
+        report->AddStats(std::move(inbound));
+        auto pair = std::make_unique<webrtc::RTCIceCandidatePairStats>("pair", timestampUs);
+        pair->current_round_trip_time = 0.05;
+        pair->nominated = true;
+        report->AddStats(std::move(pair));
+        return report;
+    }
+
+    void AddCandidatePair(webrtc::RTCStatsReport* report, const std::string& id, double roundTripTime, bool nominated)
+    {
+        auto pair = std::make_unique<webrtc::RTCIceCandidatePairStats>(id, report->timestamp_us());
+        pair->current_round_trip_time = roundTripTime;
+        pair->nominated = nominated;
+        report->AddStats(std::move(pair));
+    }
+}
+
+TEST(StatsSampleCalculatorTest, ComputesRates) {
+    StatsSampleCalculator calculator;
+    StatsSample sample;
+    EXPECT_FALSE(calculator.Add(*CreateReport(1000000, { 1000, 10, 0.1, 500, 90, 10 }), &sample));
+    //half a second later
+    ASSERT_TRUE(calculator.Add(*CreateReport(1500000, { 2000, 25, 0.4, 1500, 180, 20 }), &sample));
+    EXPECT_EQ(1500000, sample.timestampUs);
+    EXPECT_DOUBLE_EQ(16000.0, sample.sendBitrate);
+    EXPECT_DOUBLE_EQ(16000.0, sample.receiveBitrate);
+    EXPECT_DOUBLE_EQ(30.0, sample.sendFramesPerSecond);
+    EXPECT_DOUBLE_EQ(10.0, sample.packetLossPercent);
+    EXPECT_DOUBLE_EQ(20.0, sample.jitterMs);
+    EXPECT_DOUBLE_EQ(50.0, sample.roundTripTimeMs);
+    EXPECT_DOUBLE_EQ(20.0, sample.encodeMsPerFrame);
+}
+
+TEST(StatsSampleCalculatorTest, ClampsDecreasingCounters) {
+    StatsSampleCalculator calculator;
+    StatsSample sample;
+    calculator.Add(*CreateReport(1000000, { 2000, 25, 0.4, 1500, 180, 20 }), &sample);
+    //a stream was removed
+    ASSERT_TRUE(calculator.Add(*CreateReport(2000000, { 1000, 10, 0.1, 500, 90, 10 }), &sample));
+    EXPECT_EQ(0.0, sample.sendBitrate);
+    EXPECT_EQ(0.0, sample.receiveBitrate);
+    EXPECT_EQ(0.0, sample.packetLossPercent);
+    EXPECT_EQ(0.0, sample.encodeMsPerFrame);
+}
+
+TEST(StatsSampleCalculatorTest, RoundTripTimeOfSelectedPair) {
+    StatsSampleCalculator calculator;
+    StatsSample sample;
+    calculator.Add(*CreateReport(1000000, { 0, 0, 0, 0, 0, 0 }), &sample);
+    auto report = CreateReport(2000000, { 0, 0, 0, 0, 0, 0 });
+    //a pair which lost the nomination and still reports the rtt of its last check
+    AddCandidatePair(report, "stale", 0.5, false);
+    ASSERT_TRUE(calculator.Add(*report, &sample));
+    EXPECT_DOUBLE_EQ(50.0, sample.roundTripTimeMs);
+
+    //the transport names the pair in use, even if it isn't nominated yet
+    report = CreateReport(3000000, { 0, 0, 0, 0, 0, 0 });
+    AddCandidatePair(report, "selected", 0.02, false);
+    auto transport = std::make_unique<webrtc::RTCTransportStats>("transport", 3000000);
+    transport->selected_candidate_pair_id = "selected";
+    report->AddStats(std::move(transport));
+    ASSERT_TRUE(calculator.Add(*report, &sample));
+    EXPECT_DOUBLE_EQ(20.0, sample.roundTripTimeMs);
+}
+
+TEST(StatsSamplerTest, KeepsLatestSamples) {
+    rtc::scoped_refptr<StatsSampler> sampler = new rtc::RefCountedObject<StatsSampler>(3);
+    StatsSample samples[4];
+    EXPECT_EQ(0, sampler->GetSamples(samples, 4));
+    for (int i = 0; i < 5; i++)
+    {
+        const uint64 bytes = 1000 * i;
+        sampler->OnStatsDelivered(CreateReport(1000000 * (i + 1), { bytes, 0, 0, bytes, 0, 0 }));
+    }
+    //four samples from five reports, only three kept
+    ASSERT_EQ(3, sampler->GetSamples(samples, 4));
+    EXPECT_EQ(3000000, samples[0].timestampUs);
+    EXPECT_EQ(5000000, samples[2].timestampUs);
+    ASSERT_EQ(2, sampler->GetSamples(samples, 2));
+    EXPECT_EQ(4000000, samples[0].timestampUs);
+    EXPECT_DOUBLE_EQ(8000.0, samples[1].sendBitrate);
+}
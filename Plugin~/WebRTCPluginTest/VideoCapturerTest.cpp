@@ -1,17 +1,25 @@
 #include "pch.h"
 #include "GraphicsDeviceTestBase.h"
 #include "../WebRTCPlugin/GraphicsDevice/ITexture2D.h"
-#include "../WebRTCPlugin/Codec/EncoderFactory.h"
 #include "../WebRTCPlugin/Codec/IEncoder.h"
 #include "../WebRTCPlugin/NvVideoCapturer.h"
 
 using namespace WebRTC;
 using namespace testing;
 
+class FrameSink : public rtc::VideoSinkInterface<webrtc::VideoFrame>
+{
+public:
+    void OnFrame(const webrtc::VideoFrame& frame) override
+    {
+        frames.push_back(frame);
+    }
+    std::vector<webrtc::VideoFrame> frames;
+};
+
 class VideoCapturerTest : public GraphicsDeviceTestBase
 {
 protected:
-    IEncoder* encoder_ = nullptr;
     const int width_ = 256;
     const int height_ = 256;
     std::unique_ptr<NvVideoCapturer> capturer_;
@@ -20,20 +28,29 @@ protected:
         GraphicsDeviceTestBase::SetUp();
         EXPECT_NE(nullptr, m_device);
 
-        EncoderFactory::GetInstance().Init(width_, height_, m_device, encoderType);
-        encoder_ = EncoderFactory::GetInstance().GetEncoder();
-        EXPECT_NE(nullptr, encoder_);
-
         capturer_ = std::make_unique<NvVideoCapturer>();
+        capturer_->SetSize(width_, height_);
     }
 
     void TearDown() override {
-        EncoderFactory::GetInstance().Shutdown();
         GraphicsDeviceTestBase::TearDown();
     }
 };
 TEST_P(VideoCapturerTest, InitializeAndFinalize) {
-    capturer_->InitializeEncoder(m_device, UnityEncoderHardware);
+    EXPECT_EQ(CodecInitializationResult::NotInitialized, capturer_->GetCodecInitializationResult());
+    EXPECT_TRUE(capturer_->InitializeEncoder(m_device, encoderType));
+    EXPECT_EQ(CodecInitializationResult::Success, capturer_->GetCodecInitializationResult());
+    capturer_->FinalizeEncoder();
+    EXPECT_EQ(CodecInitializationResult::NotInitialized, capturer_->GetCodecInitializationResult());
+}
+
+TEST_P(VideoCapturerTest, CapturersOwnTheirEncoders) {
+    auto other = std::make_unique<NvVideoCapturer>();
+    other->SetSize(width_, height_);
+    EXPECT_TRUE(capturer_->InitializeEncoder(m_device, encoderType));
+    EXPECT_TRUE(other->InitializeEncoder(m_device, encoderType));
+    other->FinalizeEncoder();
+    EXPECT_EQ(CodecInitializationResult::Success, capturer_->GetCodecInitializationResult());
     capturer_->FinalizeEncoder();
 }
 
@@ -41,8 +58,64 @@ TEST_P(VideoCapturerTest, EncodeVideoData) {
     capturer_->InitializeEncoder(m_device, UnityEncoderHardware);
     auto tex = m_device->CreateDefaultTextureV(width_, height_);
     capturer_->SetFrameBuffer(tex->GetEncodeTexturePtrV());
-    capturer_->EncodeVideoData();
+    capturer_->EncodeVideoData(rtc::TimeMicros());
+    capturer_->FinalizeEncoder();
+}
+
+TEST_P(VideoCapturerTest, SetSimulcastLayers) {
+    EXPECT_EQ(1, capturer_->GetSimulcastLayers());
+    capturer_->SetSimulcastLayers(0);
+    EXPECT_EQ(1, capturer_->GetSimulcastLayers());
+    capturer_->SetSimulcastLayers(NvVideoCapturer::MaxSimulcastLayers + 1);
+    EXPECT_EQ(NvVideoCapturer::MaxSimulcastLayers, capturer_->GetSimulcastLayers());
+}
+
+TEST_P(VideoCapturerTest, SetPlayoutDelay) {
+    EXPECT_EQ(-1, capturer_->GetPlayoutDelay().min_ms);
+    EXPECT_EQ(-1, capturer_->GetPlayoutDelay().max_ms);
+    capturer_->SetPlayoutDelay(0, NvVideoCapturer::MaxPlayoutDelayMs);
+    EXPECT_EQ(0, capturer_->GetPlayoutDelay().min_ms);
+    EXPECT_EQ(NvVideoCapturer::MaxPlayoutDelayMs, capturer_->GetPlayoutDelay().max_ms);
+
+    EXPECT_TRUE(NvVideoCapturer::IsValidPlayoutDelay(-1, 100));
+    EXPECT_TRUE(NvVideoCapturer::IsValidPlayoutDelay(200, -1));
+    EXPECT_FALSE(NvVideoCapturer::IsValidPlayoutDelay(200, 100));
+    EXPECT_FALSE(NvVideoCapturer::IsValidPlayoutDelay(0, NvVideoCapturer::MaxPlayoutDelayMs + 1));
+    EXPECT_FALSE(NvVideoCapturer::IsValidPlayoutDelay(-2, 0));
+}
+
+#if !defined(SUPPORT_METAL)
+TEST_P(VideoCapturerTest, EncodeSimulcastLayers) {
+    if (encoderType != UnityEncoderHardware || !m_device->SupportsScaling())
+        return;
+    FrameSink sink;
+    capturer_->AddOrUpdateSink(&sink, rtc::VideoSinkWants());
+    capturer_->SetSimulcastLayers(3);
+    EXPECT_TRUE(capturer_->InitializeEncoder(m_device, encoderType));
+    EXPECT_EQ(CodecInitializationResult::Success, capturer_->GetCodecInitializationResult());
+    auto tex = m_device->CreateDefaultTextureV(width_, height_);
+    capturer_->SetFrameBuffer(tex->GetEncodeTexturePtrV());
+    capturer_->StartEncoder();
+    capturer_->EncodeVideoData(rtc::TimeMicros());
+    ASSERT_EQ(1u, sink.frames.size());
+    auto frameBuffer = static_cast<FrameBuffer*>(sink.frames[0].video_frame_buffer().get());
+    EXPECT_EQ(width_, frameBuffer->width());
+    auto& layers = frameBuffer->SimulcastLayers();
+    ASSERT_EQ(2u, layers.size());
+    EXPECT_EQ(width_ / 4, layers[0]->width());
+    EXPECT_EQ(width_ / 2, layers[1]->width());
+
+    //a disabled layer is no longer encoded but the full resolution frame still is
+    sink.frames.clear();
+    capturer_->SetLayerRate(0, 0);
+    capturer_->EncodeVideoData(rtc::TimeMicros() + rtc::kNumMicrosecsPerSec);
+    ASSERT_EQ(1u, sink.frames.size());
+    frameBuffer = static_cast<FrameBuffer*>(sink.frames[0].video_frame_buffer().get());
+    ASSERT_EQ(1u, frameBuffer->SimulcastLayers().size());
+    EXPECT_EQ(width_ / 2, frameBuffer->SimulcastLayers()[0]->width());
+    capturer_->RemoveSink(&sink);
     capturer_->FinalizeEncoder();
 }
+#endif
 
 INSTANTIATE_TEST_CASE_P(GraphicsDeviceParameters, VideoCapturerTest, ValuesIn(VALUES_TEST_ENV));
@@ -0,0 +1,121 @@
+#include "pch.h"
+#include "../WebRTCPlugin/VideoFrameReceiver.h"
+
+using namespace WebRTC;
+
+namespace
+{
+    webrtc::VideoFrame CreateFrame(int width, int height, uint8 y, int64 timestampUs)
+    {
+        rtc::scoped_refptr<webrtc::I420Buffer> buffer = webrtc::I420Buffer::Create(width, height);
+        //neutral chroma, the luma alone decides the grey level
+        memset(buffer->MutableDataY(), y, buffer->StrideY() * height);
+        memset(buffer->MutableDataU(), 128, buffer->StrideU() * buffer->ChromaHeight());
+        memset(buffer->MutableDataV(), 128, buffer->StrideV() * buffer->ChromaHeight());
+        return webrtc::VideoFrame::Builder()
+            .set_video_frame_buffer(buffer)
+            .set_timestamp_us(timestampUs)
+            .build();
+    }
+}
+
+TEST(TripleBufferTest, ConsumerSeesLatestBuffer) {
+    TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.Update());
+
+    buffer.WriteBuffer() = 1;
+    EXPECT_TRUE(buffer.Publish());
+    buffer.WriteBuffer() = 2;
+    EXPECT_FALSE(buffer.Publish());
+    EXPECT_TRUE(buffer.Update());
+    EXPECT_EQ(2, buffer.ReadBuffer());
+    EXPECT_FALSE(buffer.Update());
+    EXPECT_EQ(2, buffer.ReadBuffer());
+}
+
+TEST(TripleBufferTest, ConcurrentProducerAndConsumer) {
+    TripleBuffer<int> buffer;
+    const int count = 100000;
+    std::thread producer([&buffer]()
+    {
+        for (int i = 1; i <= count; i++)
+        {
+            buffer.WriteBuffer() = i;
+            buffer.Publish();
+        }
+    });
+    int last = 0;
+    while (last < count)
+    {
+        if (buffer.Update())
+        {
+            //buffers are never torn or handed out of order
+            EXPECT_LT(last, buffer.ReadBuffer());
+            last = buffer.ReadBuffer();
+        }
+    }
+    producer.join();
+}
+
+TEST(VideoFrameReceiverTest, ConvertsI420ToRgba) {
+    VideoFrameReceiver receiver;
+    EXPECT_FALSE(receiver.AcquireLatestFrame());
+
+    const int width = 64;
+    const int height = 32;
+    receiver.OnFrame(CreateFrame(width, height, 235, 1000));
+    ASSERT_TRUE(receiver.AcquireLatestFrame());
+    const RgbaFrame& frame = receiver.GetFrame();
+    EXPECT_EQ(width, frame.width);
+    EXPECT_EQ(height, frame.height);
+    EXPECT_EQ(1000, frame.timestampUs);
+    ASSERT_EQ(static_cast<size_t>(width * height * 4), frame.data.size());
+    for (size_t i = 0; i < frame.data.size(); i += 4)
+    {
+        EXPECT_NEAR(255, frame.data[i], 2);
+        EXPECT_NEAR(255, frame.data[i + 1], 2);
+        EXPECT_NEAR(255, frame.data[i + 2], 2);
+        EXPECT_EQ(255, frame.data[i + 3]);
+    }
+    EXPECT_FALSE(receiver.AcquireLatestFrame());
+}
+
+TEST(VideoFrameReceiverTest, SkipsFramesNotConsumed) {
+    VideoFrameReceiver receiver;
+    receiver.OnFrame(CreateFrame(16, 16, 16, 1000));
+    receiver.OnFrame(CreateFrame(32, 32, 16, 2000));
+    receiver.OnFrame(CreateFrame(16, 16, 16, 3000));
+    EXPECT_EQ(3u, receiver.GetReceivedFrameCount());
+    EXPECT_EQ(2u, receiver.GetSkippedFrameCount());
+
+    ASSERT_TRUE(receiver.AcquireLatestFrame());
+    EXPECT_EQ(3000, receiver.GetFrame().timestampUs);
+    EXPECT_EQ(16, receiver.GetFrame().width);
+    //black
+    EXPECT_NEAR(0, receiver.GetFrame().data[0], 2);
+    EXPECT_EQ(255, receiver.GetFrame().data[3]);
+}
+
+TEST(VideoFrameReceiverTest, RotatesFramesUpright) {
+    const int width = 64;
+    const int height = 32;
+    webrtc::VideoFrame frame = CreateFrame(width, height, 16, 1000);
+    //white upper half, a sender turned by 90 degrees shows it on the right
+    rtc::scoped_refptr<webrtc::I420Buffer> buffer = webrtc::I420Buffer::Copy(*frame.video_frame_buffer()->ToI420());
+    memset(buffer->MutableDataY(), 235, buffer->StrideY() * height / 2);
+    frame.set_video_frame_buffer(buffer);
+    frame.set_rotation(webrtc::kVideoRotation_90);
+
+    VideoFrameReceiver receiver;
+    receiver.OnFrame(frame);
+    ASSERT_TRUE(receiver.AcquireLatestFrame());
+    const RgbaFrame& rgba = receiver.GetFrame();
+    EXPECT_EQ(height, rgba.width);
+    EXPECT_EQ(width, rgba.height);
+    ASSERT_EQ(static_cast<size_t>(width * height * 4), rgba.data.size());
+    for (int y = 0; y < rgba.height; y++)
+    {
+        EXPECT_NEAR(0, rgba.data[(y * rgba.width) * 4], 2);
+        EXPECT_NEAR(255, rgba.data[(y * rgba.width + rgba.width - 1) * 4], 2);
+    }
+}
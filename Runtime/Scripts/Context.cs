@@ -27,9 +27,12 @@ namespace Unity.WebRTC
             return v;
         }
 
-        public static Context Create(int id = 0, EncoderType encoderType = EncoderType.Hardware)
+        // shareFactory uses the native threads and peer connection factory of every other context created with it
+        public static Context Create(int id = 0, EncoderType encoderType = EncoderType.Hardware, bool shareFactory = false)
         {
-            var ptr = NativeMethods.ContextCreate(id, encoderType);
+            var ptr = shareFactory ?
+                NativeMethods.ContextCreateWithSharedFactory(id, encoderType) :
+                NativeMethods.ContextCreate(id, encoderType);
             return new Context(ptr, id);
         }
 
@@ -77,6 +80,60 @@ namespace Unity.WebRTC
             return NativeMethods.ContextGetEncoderType(self);
         }
 
+        public void SetBitratePolicy(BitratePolicy policy)
+        {
+            NativeMethods.ContextSetBitratePolicy(self, policy);
+        }
+
+        public void StartStatsSampler(int intervalMs, int sampleCount)
+        {
+            NativeMethods.ContextStartStatsSampler(self, intervalMs, sampleCount);
+        }
+
+        public void StopStatsSampler()
+        {
+            NativeMethods.ContextStopStatsSampler(self);
+        }
+
+        public int GetStatsSamples(IntPtr peerConnection, RTCStatsSample[] samples)
+        {
+            return NativeMethods.ContextGetStatsSamples(self, peerConnection, samples, samples.Length);
+        }
+
+        public VideoDecoderStats GetVideoDecoderStats()
+        {
+            var stats = new VideoDecoderStats();
+            NativeMethods.ContextGetVideoDecoderStats(self, ref stats);
+            return stats;
+        }
+
+        public void ProcessAudio(IntPtr track, float[] data, int channels, int sampleRate)
+        {
+            NativeMethods.ContextProcessAudio(self, track, data, data.Length, sampleRate, channels);
+        }
+
+        public void SetOpusSettings(IntPtr track, OpusSettings settings)
+        {
+            NativeMethods.ContextSetAudioTrackOpusSettings(self, track, ref settings);
+        }
+
+        public void SetAudioPacing(bool enable)
+        {
+            NativeMethods.ContextSetAudioPacing(self, enable);
+        }
+
+        public AudioCaptureStats GetAudioCaptureStats(IntPtr track)
+        {
+            var stats = new AudioCaptureStats();
+            NativeMethods.ContextGetAudioCaptureStats(self, track, ref stats);
+            return stats;
+        }
+
+        public int ReadAudioPlayout(float[] data, int channels, int sampleRate)
+        {
+            return NativeMethods.ContextReadAudioPlayout(self, data, data.Length, sampleRate, channels);
+        }
+
         public IntPtr CreatePeerConnection()
         {
             return NativeMethods.ContextCreatePeerConnection(self);
@@ -102,13 +159,16 @@ namespace Unity.WebRTC
             NativeMethods.ContextDeleteDataChannel(self, ptr);
         }
 
-        // TODO:: Fix API design for multi tracks
         public IntPtr CaptureVideoStream(IntPtr rt, int width, int height)
         {
             return NativeMethods.ContextCreateVideoStream(self, rt, width, height);
         }
 
-        // TODO:: Fix API design for multi tracks
+        public IntPtr CaptureVideoStream(IntPtr rt, int width, int height, int simulcastLayers)
+        {
+            return NativeMethods.ContextCreateSimulcastVideoStream(self, rt, width, height, simulcastLayers);
+        }
+
         public void DeleteVideoStream(IntPtr stream)
         {
             NativeMethods.ContextDeleteVideoStream(self, stream);
@@ -126,6 +186,16 @@ namespace Unity.WebRTC
             NativeMethods.ContextDeleteAudioStream(self, stream);
         }
 
+        public IntPtr CreateVideoReceiver(IntPtr track)
+        {
+            return NativeMethods.ContextCreateVideoReceiver(self, track);
+        }
+
+        public void DeleteVideoReceiver(IntPtr receiver)
+        {
+            NativeMethods.ContextDeleteVideoReceiver(self, receiver);
+        }
+
         public IntPtr GetRenderEventFunc()
         {
             return NativeMethods.GetRenderEventFunc(self);
@@ -136,22 +206,33 @@ namespace Unity.WebRTC
             NativeMethods.StopMediaStreamTrack(self, track);
         }
 
-        internal void InitializeEncoder()
+        public bool SetPlayoutDelay(IntPtr track, int minMs, int maxMs)
+        {
+            return NativeMethods.ContextSetVideoTrackPlayoutDelay(self, track, minMs, maxMs);
+        }
+
+        public bool GetEncoderStats(IntPtr track, int layer, out EncoderStats stats)
+        {
+            stats = new EncoderStats();
+            return NativeMethods.ContextGetEncoderStats(self, track, layer, ref stats);
+        }
+
+        internal void InitializeEncoder(IntPtr track)
         {
             renderFunction = renderFunction == IntPtr.Zero ? GetRenderEventFunc() : renderFunction;
-            VideoEncoderMethods.InitializeEncoder(renderFunction);
+            VideoEncoderMethods.InitializeEncoder(renderFunction, track);
         }
 
-        internal void FinalizeEncoder()
+        internal void FinalizeEncoder(IntPtr track)
         {
             renderFunction = renderFunction == IntPtr.Zero ? GetRenderEventFunc() : renderFunction;
-            VideoEncoderMethods.FinalizeEncoder(renderFunction);
+            VideoEncoderMethods.FinalizeEncoder(renderFunction, track);
         }
 
-        internal void Encode()
+        internal void Encode(IntPtr track)
         {
             renderFunction = renderFunction == IntPtr.Zero ? GetRenderEventFunc() : renderFunction;
-            VideoEncoderMethods.Encode(renderFunction);
+            VideoEncoderMethods.Encode(renderFunction, track);
         }
     }
 }
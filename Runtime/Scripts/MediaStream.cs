@@ -67,7 +67,10 @@ namespace Unity.WebRTC
 
         public void FinalizeEncoder()
         {
-            WebRTC.Context.FinalizeEncoder();
+            foreach (var track in VideoTrackToRts.Keys)
+            {
+                WebRTC.Context.FinalizeEncoder(track.self);
+            }
         }
 
         private void StopTrack(MediaStreamTrack track)
@@ -130,7 +133,7 @@ namespace Unity.WebRTC
             NativeMethods.MediaStreamRemoveTrack(self, track.self);
         }
         //for camera CaptureStream
-        internal MediaStream(RenderTexture[] rts, IntPtr ptr)
+        internal MediaStream(RenderTexture[] rts, IntPtr ptr, int simulcastLayers = 1)
         {
             self = ptr;
             WebRTC.Table.Add(self, this);
@@ -150,6 +153,7 @@ namespace Unity.WebRTC
                 MediaStreamTrack track = new MediaStreamTrack(tracksPtr[i]);
                 track.stopTrack += StopTrack;
                 track.getRts += GetRts;
+                track.simulcastLayers = simulcastLayers;
                 VideoTrackToRts[track] = rts;
             }
         }
@@ -211,14 +215,11 @@ namespace Unity.WebRTC
     public static class CameraExtension
     {
         internal static List<RenderTexture[]> camCopyRts = new List<RenderTexture[]>();
+        internal static Dictionary<RenderTexture[], IntPtr> camCopyTracks = new Dictionary<RenderTexture[], IntPtr>();
         internal static bool started = false;
-        public static MediaStream CaptureStream(this Camera cam, int width, int height, RenderTextureDepth depth = RenderTextureDepth.DEPTH_24)
+        //simulcastLayers > 1 sends several resolutions, each halving the one above it (hardware encoder only)
+        public static MediaStream CaptureStream(this Camera cam, int width, int height, RenderTextureDepth depth = RenderTextureDepth.DEPTH_24, int simulcastLayers = 1)
         {
-            if (camCopyRts.Count > 0)
-            {
-                throw new NotImplementedException("Currently not allowed multiple MediaStream");
-            }
-
             switch (depth)
             {
                 case RenderTextureDepth.DEPTH_16:
@@ -250,18 +251,25 @@ namespace Unity.WebRTC
             });
             started = true;
 
-            var stream = WebRTC.Context.CaptureVideoStream(rts[1].GetNativeTexturePtr(), width, height);
+            var streamPtr = simulcastLayers > 1
+                ? WebRTC.Context.CaptureVideoStream(rts[1].GetNativeTexturePtr(), width, height, simulcastLayers)
+                : WebRTC.Context.CaptureVideoStream(rts[1].GetNativeTexturePtr(), width, height);
+            var stream = new MediaStream(rts, streamPtr, simulcastLayers);
 
-            // TODO::
             // You should initialize encoder after create stream instance.
-            // This specification will change in the future.
-            WebRTC.Context.InitializeEncoder();
+            // Each video track owns its encoder, so the render events are issued per track.
+            foreach (var track in stream.GetVideoTracks())
+            {
+                camCopyTracks[rts] = track.self;
+                WebRTC.Context.InitializeEncoder(track.self);
+            }
 
-            return new MediaStream(rts, stream);
+            return stream;
         }
         public static void RemoveRt(RenderTexture[] rts)
         {
             camCopyRts.Remove(rts);
+            camCopyTracks.Remove(rts);
             if (camCopyRts.Count == 0)
             {
                 started = false;
@@ -273,18 +281,73 @@ namespace Unity.WebRTC
     public static class Audio
     {
         private static bool started = false;
+        private static int sampleRate = 48000;
         public static MediaStream CaptureStream()
         {
             started = true;
+            // OnAudioFilterRead runs on the audio thread, which can't read AudioSettings
+            sampleRate = AudioSettings.outputSampleRate;
             return new MediaStream(WebRTC.Context.CreateAudioStream());
         }
+        // samples of OnAudioFilterRead, at AudioSettings.outputSampleRate
         public static void Update(float[] audioData, int channels)
+        {
+            Update(audioData, channels, sampleRate);
+        }
+        // interleaved samples of up to 8 channels, they are converted in the plugin and sent on every audio track.
+        // The sample rate has to be a multiple of 100Hz, the audio of titles running at 22050 or 11025Hz is dropped.
+        public static void Update(float[] audioData, int channels, int sampleRate)
+        {
+            if (started)
+            {
+                NativeMethods.ProcessAudio(audioData, audioData.Length, sampleRate, channels);
+            }
+        }
+        public static void Update(MediaStreamTrack track, float[] audioData, int channels)
+        {
+            Update(track, audioData, channels, sampleRate);
+        }
+        // sends to a single audio track, the other audio tracks are left untouched.
+        // The same sample rates as Update(audioData, channels, sampleRate) are supported.
+        public static void Update(MediaStreamTrack track, float[] audioData, int channels, int sampleRate)
         {
             if (started)
             {
-                NativeMethods.ProcessAudio(audioData, audioData.Length);
+                WebRTC.Context.ProcessAudio(track.self, audioData, channels, sampleRate);
             }
         }
+        // the encoder settings are taken into account when the next remote description is set
+        public static void SetOpusSettings(MediaStreamTrack track, OpusSettings settings)
+        {
+            WebRTC.Context.SetOpusSettings(track.self, settings);
+        }
+        // settings of the audio tracks which have none of their own
+        public static void SetOpusSettings(OpusSettings settings)
+        {
+            WebRTC.Context.SetOpusSettings(IntPtr.Zero, settings);
+        }
+        // paces the streams captured afterwards on a steady clock and compensates the drift of Unity's
+        // audio clock, at the cost of about 30ms of latency. Off by default.
+        public static void SetPacing(bool enable)
+        {
+            WebRTC.Context.SetAudioPacing(enable);
+        }
+        public static AudioCaptureStats GetCaptureStats(MediaStreamTrack track)
+        {
+            return WebRTC.Context.GetAudioCaptureStats(track.self);
+        }
+        // fills data with remote audio at AudioSettings.outputSampleRate, to be called from OnAudioFilterRead
+        // after CaptureStream, which reads the rate on the main thread.
+        // returns the number of samples received, the rest is silence
+        public static int ReadPlayout(float[] data, int channels)
+        {
+            return ReadPlayout(data, channels, sampleRate);
+        }
+        // the sample rate has to be a multiple of 100Hz like in Update
+        public static int ReadPlayout(float[] data, int channels, int sampleRate)
+        {
+            return WebRTC.Context.ReadAudioPlayout(data, channels, sampleRate);
+        }
         public static void Stop()
         {
             if (started)
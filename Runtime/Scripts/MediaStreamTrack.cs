@@ -13,6 +13,8 @@ namespace Unity.WebRTC
         private TrackState readyState;
         internal Action<MediaStreamTrack> stopTrack;
         internal Func<MediaStreamTrack, RenderTexture[]> getRts;
+        //number of resolutions the video track is encoded at, see CameraExtension.CaptureStream
+        internal int simulcastLayers = 1;
 
         public bool Enabled
         {
@@ -48,6 +50,24 @@ namespace Unity.WebRTC
         {
             stopTrack(this);
         }
+
+        //Asks the remote peers to render this local video track within minMs to maxMs of its capture,
+        //minMs = maxMs = 0 renders as soon as a frame is decoded. -1 leaves the bound to the receiver.
+        //The bounds go up to 40950ms, minMs can't exceed maxMs.
+        public void SetPlayoutDelay(int minMs, int maxMs)
+        {
+            if (!WebRTC.Context.SetPlayoutDelay(self, minMs, maxMs))
+            {
+                throw new ArgumentOutOfRangeException(nameof(minMs), "minMs and maxMs must be between -1 and 40950 and minMs can't exceed maxMs");
+            }
+        }
+
+        //Counters of the encoder of a local video track, layer 0 is the lowest resolution simulcast layer.
+        //Returns false if the track has no encoder for the layer yet.
+        public bool GetEncoderStats(int layer, out EncoderStats stats)
+        {
+            return WebRTC.Context.GetEncoderStats(self, layer, out stats);
+        }
     }
 
     public enum TrackKind
@@ -84,6 +104,12 @@ namespace Unity.WebRTC
         {
             self = ptr;
         }
+
+        //Minimum time the received media is buffered before playout, null restores the default
+        public void SetJitterBufferMinimumDelay(double? delaySeconds)
+        {
+            NativeMethods.RtpTransceiverInterfaceSetJitterBufferMinimumDelay(self, delaySeconds ?? -1);
+        }
     }
 
 }
@@ -5,9 +5,19 @@ namespace Unity.WebRTC
 {
     public delegate void DelegateOnOpen();
     public delegate void DelegateOnClose();
+    public delegate void DelegateOnBufferedAmountLow();
     public delegate void DelegateOnMessage(byte[] bytes);
     public delegate void DelegateOnDataChannel(RTCDataChannel channel);
 
+    // A send buffer in native memory, acquired with RTCDataChannel.AcquireBuffer
+    public struct RTCDataChannelBuffer
+    {
+        internal IntPtr self;
+        // the message is written here, e.g. with Marshal.Copy
+        public IntPtr Data { get; internal set; }
+        public int Capacity { get; internal set; }
+    }
+
     public class RTCDataChannel : IDisposable
     {
         private IntPtr self;
@@ -15,10 +25,14 @@ namespace Unity.WebRTC
         private DelegateOnMessage onMessage;
         private DelegateOnOpen onOpen;
         private DelegateOnClose onClose;
+        private DelegateOnBufferedAmountLow onBufferedAmountLow;
+        private ulong bufferedAmountLowThreshold;
+        private ulong bufferedAmountHighThreshold;
 
         private DelegateNativeOnMessage selfOnMessage;
         private DelegateNativeOnOpen selfOnOpen;
         private DelegateNativeOnClose selfOnClose;
+        private DelegateNativeOnBufferedAmountLow selfOnBufferedAmountLow;
         private int id;
         private bool disposed;
 
@@ -55,12 +69,63 @@ namespace Unity.WebRTC
             }
         }
 
+        // called when BufferedAmount falls to BufferedAmountLowThreshold
+        public DelegateOnBufferedAmountLow OnBufferedAmountLow
+        {
+            get { return onBufferedAmountLow; }
+            set
+            {
+                onBufferedAmountLow = value;
+                selfOnBufferedAmountLow = new DelegateNativeOnBufferedAmountLow(DataChannelNativeOnBufferedAmountLow);
+                NativeMethods.DataChannelRegisterOnBufferedAmountLow(self, selfOnBufferedAmountLow);
+            }
+        }
+
+        // bytes queued by Send which haven't been sent yet
+        public ulong BufferedAmount
+        {
+            get => NativeMethods.DataChannelGetBufferedAmount(self);
+        }
+
+        public ulong BufferedAmountLowThreshold
+        {
+            get { return bufferedAmountLowThreshold; }
+            set
+            {
+                bufferedAmountLowThreshold = value;
+                NativeMethods.DataChannelSetBufferedAmountThresholds(self, bufferedAmountLowThreshold, bufferedAmountHighThreshold);
+            }
+        }
+
+        // bytes of chunked messages which haven't been handed to BufferedAmount yet
+        public ulong PendingChunkedAmount
+        {
+            get => NativeMethods.DataChannelGetPendingChunkedSize(self);
+        }
+
+        // TrySend doesn't let BufferedAmount grow past this, 0 means no limit
+        public ulong BufferedAmountHighThreshold
+        {
+            get { return bufferedAmountHighThreshold; }
+            set
+            {
+                bufferedAmountHighThreshold = value;
+                NativeMethods.DataChannelSetBufferedAmountThresholds(self, bufferedAmountLowThreshold, bufferedAmountHighThreshold);
+            }
+        }
+
         public int Id
         {
             get => NativeMethods.DataChannelGetID(self);
         }
         public string Label { get; private set; }
 
+        // size of the next message queued for ReceiveMessages, -1 if there is none
+        public int NextMessageSize
+        {
+            get => NativeMethods.DataChannelGetNextMessageSize(self);
+        }
+
         [AOT.MonoPInvokeCallback(typeof(DelegateNativeOnMessage))]
         static void DataChannelNativeOnMessage(IntPtr ptr, byte[] msg, int len)
         {
@@ -93,6 +158,19 @@ namespace Unity.WebRTC
                 channel.onClose();
             }, null);
         }
+        [AOT.MonoPInvokeCallback(typeof(DelegateNativeOnBufferedAmountLow))]
+        static void DataChannelNativeOnBufferedAmountLow(IntPtr ptr)
+        {
+            WebRTC.SyncContext.Post(_ =>
+            {
+                if (null == WebRTC.Table)
+                    return;
+
+                var channel = WebRTC.Table[ptr] as RTCDataChannel;
+                channel.onBufferedAmountLow();
+            }, null);
+        }
+
         internal RTCDataChannel(IntPtr ptr, RTCPeerConnection peerConnection)
         {
             self = ptr;
@@ -134,6 +212,79 @@ namespace Unity.WebRTC
             NativeMethods.DataChannelSendBinary(self, msg, msg.Length);
         }
 
+        // Returns false without sending if the message would take BufferedAmount past BufferedAmountHighThreshold
+        public bool TrySend(byte[] msg)
+        {
+            return NativeMethods.DataChannelTrySendBinary(self, msg, msg.Length);
+        }
+
+        // Returns true once each time BufferedAmount fell to BufferedAmountLowThreshold,
+        // an alternative to OnBufferedAmountLow for senders which poll every frame
+        public bool PollBufferedAmountLow()
+        {
+            return NativeMethods.DataChannelPollBufferedAmountLow(self);
+        }
+
+        // Sends count messages packed in data with a single call, message i starts at offsets[i]
+        // and ends where the next one starts, the last one ends at size.
+        // Returns the number of messages sent, it stops at the first one which can't be sent.
+        public int Send(byte[] data, int size, int[] offsets, int count)
+        {
+            if (size < 0 || size > data.Length)
+                throw new ArgumentOutOfRangeException(nameof(size));
+            if (count < 0 || count > offsets.Length)
+                throw new ArgumentOutOfRangeException(nameof(count));
+            return NativeMethods.DataChannelSendBatch(self, data, size, offsets, count);
+        }
+
+        // The buffer belongs to the caller until it is passed to Send or ReleaseBuffer.
+        public RTCDataChannelBuffer AcquireBuffer(int capacity)
+        {
+            if (capacity < 0)
+                throw new ArgumentOutOfRangeException(nameof(capacity));
+            IntPtr data = IntPtr.Zero;
+            var buffer = NativeMethods.DataChannelAcquireBuffer(self, capacity, ref data);
+            return new RTCDataChannelBuffer { self = buffer, Data = data, Capacity = capacity };
+        }
+
+        // Sends the first size bytes of buffer without copying them, the buffer goes back to the
+        // channel and must not be used anymore.
+        public bool Send(RTCDataChannelBuffer buffer, int size)
+        {
+            return NativeMethods.DataChannelSendBuffer(self, buffer.self, size);
+        }
+
+        public void ReleaseBuffer(RTCDataChannelBuffer buffer)
+        {
+            NativeMethods.DataChannelReleaseBuffer(self, buffer.self);
+        }
+
+        // Binary messages larger than chunkSize bytes are split into chunks and reassembled on the
+        // other end, which has to enable chunking too before any message is sent.
+        // Chunks are sent a few at a time, so messages sent later may arrive before a large one.
+        public bool EnableChunking(int chunkSize)
+        {
+            if (chunkSize <= 0)
+                throw new ArgumentOutOfRangeException(nameof(chunkSize));
+            return NativeMethods.DataChannelEnableChunking(self, chunkSize);
+        }
+
+        // Received messages are queued in a buffer of capacity bytes until ReceiveMessages is called,
+        // instead of being passed to OnMessage. It can't be disabled once enabled.
+        public bool EnableReceiveQueue(int capacity)
+        {
+            if (capacity <= 0)
+                throw new ArgumentOutOfRangeException(nameof(capacity));
+            return NativeMethods.DataChannelEnableReceiveQueue(self, capacity);
+        }
+
+        // Copies the queued messages back to back into data and their sizes into sizes, and returns
+        // the number of messages. It stops at the first message larger than the space left in data.
+        public int ReceiveMessages(byte[] data, int[] sizes)
+        {
+            return NativeMethods.DataChannelReceiveMessages(self, data, data.Length, sizes, sizes.Length);
+        }
+
         public void Close()
         {
             if (self != IntPtr.Zero)
@@ -245,6 +245,10 @@ namespace Unity.WebRTC
 
         public RTCRtpSender AddTrack(MediaStreamTrack track)
         {
+            if (track.simulcastLayers > 1)
+            {
+                return new RTCRtpSender(NativeMethods.PeerConnectionAddSimulcastTrack(self, track.self, track.simulcastLayers));
+            }
             return new RTCRtpSender(NativeMethods.PeerConnectionAddTrack(self, track.self));
         }
         public void RemoveTrack(RTCRtpSender sender)
@@ -316,6 +320,34 @@ namespace Unity.WebRTC
             NativeMethods.PeerConnectionCollectStats(self);
         }
 
+        // Copies the samples taken by the stats sampler, oldest first, and returns how many were copied.
+        // See WebRTC.StartStatsSampler
+        public int GetStatsSamples(RTCStatsSample[] samples)
+        {
+            return WebRTC.Context.GetStatsSamples(self, samples);
+        }
+
+        // Selects the stats collected by CollectFilteredStats
+        public void SetStatsFilter(RTCStatsFilterEntry[] entries)
+        {
+            NativeMethods.PeerConnectionSetStatsFilter(self, entries, entries.Length);
+        }
+
+        // Collects the stats selected by SetStatsFilter, which is much cheaper than CollectStats
+        // as the report isn't serialized. The values are read with GetFilteredStats once delivered.
+        public void CollectFilteredStats()
+        {
+            NativeMethods.PeerConnectionCollectFilteredStats(self);
+        }
+
+        // Copies the values of the latest filtered report into values and returns how many there are,
+        // which may be more than values can hold. reportTimestampUs is 0 until a report was delivered.
+        public int GetFilteredStats(RTCStatsValue[] values, out long reportTimestampUs)
+        {
+            reportTimestampUs = 0;
+            return NativeMethods.PeerConnectionGetFilteredStats(self, values, values.Length, ref reportTimestampUs);
+        }
+
         public RTCSessionDescription GetLocalDescription()
         {
             RTCSessionDescription desc = default;
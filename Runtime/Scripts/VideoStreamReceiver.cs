@@ -0,0 +1,73 @@
+﻿using System;
+using UnityEngine;
+
+namespace Unity.WebRTC
+{
+    //Uploads the decoded frames of a remote video track to a Texture2D.
+    //The frames are converted to RGBA32 on the decoder thread, Update only copies the newest one.
+    //Rows are top to bottom, flip the texture coordinates when drawing it.
+    public class VideoStreamReceiver : IDisposable
+    {
+        private IntPtr self;
+        private Texture2D texture;
+        private bool disposed;
+
+        public Texture2D Texture { get { return texture; } }
+
+        public VideoStreamReceiver(MediaStreamTrack track)
+        {
+            if (track.Kind != TrackKind.Video)
+            {
+                throw new ArgumentException("The track is not a video track", nameof(track));
+            }
+            self = WebRTC.Context.CreateVideoReceiver(track.self);
+        }
+
+        ~VideoStreamReceiver()
+        {
+            this.Dispose();
+        }
+
+        public void Dispose()
+        {
+            if (this.disposed)
+            {
+                return;
+            }
+            if (self != IntPtr.Zero && !WebRTC.Context.IsNull)
+            {
+                WebRTC.Context.DeleteVideoReceiver(self);
+                self = IntPtr.Zero;
+            }
+            this.disposed = true;
+            GC.SuppressFinalize(this);
+        }
+
+        //Call it once per frame on the main thread, returns true if the texture has been updated.
+        public bool Update()
+        {
+            if (self == IntPtr.Zero)
+            {
+                return false;
+            }
+            int width = 0;
+            int height = 0;
+            IntPtr pixels = NativeMethods.VideoReceiverAcquireFrame(self, ref width, ref height);
+            if (pixels == IntPtr.Zero)
+            {
+                return false;
+            }
+            if (texture == null || texture.width != width || texture.height != height)
+            {
+                if (texture != null)
+                {
+                    UnityEngine.Object.Destroy(texture);
+                }
+                texture = new Texture2D(width, height, TextureFormat.RGBA32, false);
+            }
+            texture.LoadRawTextureData(pixels, width * height * 4);
+            texture.Apply(false);
+            return true;
+        }
+    }
+}
@@ -4,6 +4,7 @@ using UnityEngine;
 using System.Collections.Concurrent;
 using System.Threading;
 using System.Collections;
+using UnityEngine.Rendering;
 
 namespace Unity.WebRTC
 {
@@ -13,6 +14,149 @@ namespace Unity.WebRTC
         Hardware = 1
     }
 
+    //Totals over every remote video track decoded by the context
+    [StructLayout(LayoutKind.Sequential)]
+    public struct VideoDecoderStats
+    {
+        public ulong decodedFrames;
+        public ulong hardwareDecodedFrames;
+        public ulong fallbackCount;
+        public long totalDecodeTimeUs;
+        public long maxDecodeTimeUs;
+    }
+
+    //A member of the stats objects to collect with RTCPeerConnection.CollectFilteredStats,
+    //e.g. type "outbound-rtp" and member "bytesSent"
+    [StructLayout(LayoutKind.Sequential)]
+    public struct RTCStatsFilterEntry
+    {
+        [MarshalAs(UnmanagedType.LPStr)]
+        public string type;
+        [MarshalAs(UnmanagedType.LPStr)]
+        public string member;
+        //the change per second since the previous collection instead of the value, e.g. bytesSent gives a bitrate
+        [MarshalAs(UnmanagedType.U1)]
+        public bool perSecond;
+    }
+
+    //A value collected with a stats filter, one per stats object which has the member
+    [StructLayout(LayoutKind.Sequential)]
+    public struct RTCStatsValue
+    {
+        //index of the entry in the filter
+        public int entry;
+        //ssrc of RTP stream stats, 0 for the other types
+        public uint ssrc;
+        public long timestampUs;
+        public double value;
+    }
+
+    //Rates of a peer connection between two consecutive samples of the stats sampler,
+    //summed over its RTP streams
+    [StructLayout(LayoutKind.Sequential)]
+    public struct RTCStatsSample
+    {
+        public long timestampUs;
+        public double sendBitrate;
+        public double receiveBitrate;
+        public double sendFramesPerSecond;
+        public double receiveFramesPerSecond;
+        public double packetLossPercent;
+        //largest jitter of the inbound streams
+        public double jitterMs;
+        public double roundTripTimeMs;
+        public double encodeMsPerFrame;
+    }
+
+    //Encoder settings of a local audio track, applied when the next remote description is set
+    [StructLayout(LayoutKind.Sequential)]
+    public struct OpusSettings
+    {
+        //target bitrate in bps, 0 keeps the negotiated one
+        public int bitrate;
+        //10, 20, 40 or 60, 0 keeps the negotiated one
+        public int frameSizeMs;
+        [MarshalAs(UnmanagedType.U1)]
+        public bool inbandFec;
+        [MarshalAs(UnmanagedType.U1)]
+        public bool dtx;
+        [MarshalAs(UnmanagedType.U1)]
+        public bool stereo;
+        //0 to 10, lower saves CPU at the cost of quality, -1 keeps the encoder default
+        public int complexity;
+
+        public static OpusSettings Default
+        {
+            get { return new OpusSettings { inbandFec = true, complexity = -1 }; }
+        }
+    }
+
+    //Capture buffer of a local audio track, filled by Audio.Update and drained on a steady 10ms clock
+    [StructLayout(LayoutKind.Sequential)]
+    public struct AudioCaptureStats
+    {
+        public double fillLevelMs;
+        public double targetFillLevelMs;
+        //how much faster than real time the buffered audio is consumed to make up for the drift of the audio clock
+        public double rateAdjustmentPpm;
+        public ulong underrunSamples;
+        public ulong overrunSamples;
+    }
+
+    //Counters of the encoder of a local video track since it was initialized
+    [StructLayout(LayoutKind.Sequential)]
+    public struct EncoderStats
+    {
+        public ulong framesSubmitted;
+        public ulong framesEncoded;
+        //submitted while the encoder was still busy with the previous frame in the same buffer, or rejected
+        public ulong framesDropped;
+        public ulong forcedIdrFrames;
+        public ulong reconfigures;
+        //copy of the RenderTexture into the encoder input
+        public double averageCopyTimeUs;
+        public double p99CopyTimeUs;
+        public double averageEncodeTimeUs;
+        public double p99EncodeTimeUs;
+    }
+
+    //How the bitrates requested by the peer connections sending the same video track are merged
+    //into the target of the single hardware encode
+    public enum BitratePolicy
+    {
+        Latest = 0,
+        Minimum = 1,
+        Median = 2,
+        PerLayer = 3
+    }
+
+    //Severity of the messages of the native plugin, the messages below the level set with WebRTC.SetLogLevel are skipped
+    public enum LogLevel
+    {
+        Verbose = 0,
+        Info = 1,
+        Warning = 2,
+        Error = 3,
+        None = 4
+    }
+
+    //Priority of the native thread which sends and receives the packets, see WebRTC.SetNetworkThreadPriority
+    public enum NetworkThreadPriority
+    {
+        Normal = 0,
+        High = 1,
+        Highest = 2
+    }
+
+    [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+    internal struct LogRecord
+    {
+        public LogLevel level;
+        public long timestampUs;
+        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 256)]
+        public string message;
+    }
+
     public struct RTCIceCandidate​
     {
         [MarshalAs(UnmanagedType.LPStr)]
@@ -185,6 +329,11 @@ namespace Unity.WebRTC
     {
         public RTCIceServer[] iceServers;
         public RTCIceTransportPolicy iceTransportPolicy;
+        //receive side audio buffering, only applied when the peer connection is created.
+        //0 keeps the webrtc default.
+        public int audioJitterBufferMaxPackets;
+        public int audioJitterBufferMinDelayMs;
+        public bool audioJitterBufferFastAccelerate;
     }
 
     public enum CodecInitializationResult
@@ -221,10 +370,11 @@ namespace Unity.WebRTC
         private static Context s_context;
         private static SynchronizationContext s_syncContext;
         private static Material flipMat;
+        private static readonly LogRecord[] s_logRecords = new LogRecord[64];
+        private static ulong s_droppedLogCount;
 
         public static void Initialize(EncoderType type = EncoderType.Hardware)
         {
-            NativeMethods.RegisterDebugLog(DebugLog);
             s_context = Context.Create(encoderType:type);
             NativeMethods.SetCurrentContext(s_context.self);
             s_syncContext = SynchronizationContext.Current;
@@ -240,14 +390,19 @@ namespace Unity.WebRTC
             {
                 // Wait until all frame rendering is done
                 yield return new WaitForEndOfFrame();
+                FlushLog();
                 if (CameraExtension.started)
                 {
                     //Blit is for DirectX Rendering API Only
                     foreach (var rts in CameraExtension.camCopyRts)
                     {
                         Graphics.Blit(rts[0], rts[1], flipMat);
+                        IntPtr track;
+                        if (CameraExtension.camCopyTracks.TryGetValue(rts, out track))
+                        {
+                            Context.Encode(track);
+                        }
                     }
-                    Context.Encode();
                 }
             }
         }
@@ -256,7 +411,7 @@ namespace Unity.WebRTC
         {
             s_context.Dispose();
             s_context = null;
-            NativeMethods.RegisterDebugLog(null);
+            FlushLog();
         }
 
         public static EncoderType GetEncoderType()
@@ -264,6 +419,91 @@ namespace Unity.WebRTC
             return s_context.GetEncoderType();
         }
 
+        public static void SetBitratePolicy(BitratePolicy policy)
+        {
+            s_context.SetBitratePolicy(policy);
+        }
+
+        public static VideoDecoderStats GetVideoDecoderStats()
+        {
+            return s_context.GetVideoDecoderStats();
+        }
+
+        // Collects the stats of every peer connection on a background thread each intervalMs, and keeps
+        // the latest sampleCount samples of each, see RTCPeerConnection.GetStatsSamples
+        public static void StartStatsSampler(int intervalMs, int sampleCount)
+        {
+            s_context.StartStatsSampler(intervalMs, sampleCount);
+        }
+
+        public static void StopStatsSampler()
+        {
+            s_context.StopStatsSampler();
+        }
+
+        // Applies to the contexts created afterwards, call it before Initialize.
+        // Raising the priority may need privileges on Linux and macOS, a warning is logged when it fails
+        public static void SetNetworkThreadPriority(NetworkThreadPriority priority)
+        {
+            NativeMethods.SetNetworkThreadPriority(priority);
+        }
+
+        // Messages below the level are skipped by the native plugin, the default is Warning
+        // in release builds of the plugin
+        public static void SetLogLevel(LogLevel level)
+        {
+            NativeMethods.SetLogLevel(level);
+        }
+
+        // Writes the messages logged by the native plugin from any thread to the console,
+        // Update calls it every frame
+        public static void FlushLog()
+        {
+            int count;
+            while ((count = NativeMethods.DrainLog(s_logRecords, s_logRecords.Length)) > 0)
+            {
+                for (int i = 0; i < count; i++)
+                {
+                    switch (s_logRecords[i].level)
+                    {
+                        case LogLevel.Error:
+                            Debug.LogError(s_logRecords[i].message);
+                            break;
+                        case LogLevel.Warning:
+                            Debug.LogWarning(s_logRecords[i].message);
+                            break;
+                        default:
+                            Debug.Log(s_logRecords[i].message);
+                            break;
+                    }
+                }
+            }
+            ulong dropped = NativeMethods.GetDroppedLogCount();
+            if (dropped != s_droppedLogCount)
+            {
+                Debug.LogWarning("webrtc Warning: " + (dropped - s_droppedLogCount) + " log message(s) dropped");
+                s_droppedLogCount = dropped;
+            }
+        }
+
+        // Records the timing of each step of the video pipeline, off by default
+        public static void SetFrameTraceEnabled(bool enabled)
+        {
+            NativeMethods.SetFrameTraceEnabled(enabled);
+        }
+
+        // Returns the steps recorded during the last windowMs as Chrome trace JSON,
+        // it can be loaded in chrome://tracing or Perfetto
+        public static string DumpFrameTrace(int windowMs)
+        {
+            int len = 0;
+            IntPtr ptr = IntPtr.Zero;
+            NativeMethods.DumpFrameTrace(windowMs * 1000L, ref ptr, ref len);
+            var json = Marshal.PtrToStringAnsi(ptr, len);
+            Marshal.FreeCoTaskMem(ptr);
+            return json;
+        }
+
         internal static string GetModuleName()
         {
             return System.IO.Path.GetFileName(Lib);
@@ -287,12 +527,6 @@ namespace Unity.WebRTC
             return RenderTextureFormat.Default;
         }
 
-        [AOT.MonoPInvokeCallback(typeof(DelegateDebugLog))]
-        static void DebugLog(string str)
-        {
-            Debug.Log(str);
-        }
-
         internal static Context Context { get { return s_context; } }
         internal static SynchronizationContext SyncContext { get { return s_syncContext; } }
 
@@ -324,8 +558,6 @@ namespace Unity.WebRTC
         }
     }
 
-    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
-    internal delegate void DelegateDebugLog([MarshalAs(UnmanagedType.LPStr)] string str);
     [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
     internal delegate void DelegateCreateSDSuccess(IntPtr ptr, RTCSdpType type, [MarshalAs(UnmanagedType.LPStr)] string sdp);
     [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
@@ -355,20 +587,41 @@ namespace Unity.WebRTC
     internal delegate void DelegateNativeOnOpen(IntPtr ptr);
     [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
     internal delegate void DelegateNativeOnClose(IntPtr ptr);
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    internal delegate void DelegateNativeOnBufferedAmountLow(IntPtr ptr);
 
     internal static class NativeMethods
     {
         [DllImport(WebRTC.Lib)]
         public static extern void StopMediaStreamTrack(IntPtr context, IntPtr track);
         [DllImport(WebRTC.Lib)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ContextSetVideoTrackPlayoutDelay(IntPtr context, IntPtr track, int minMs, int maxMs);
+        [DllImport(WebRTC.Lib)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ContextGetEncoderStats(IntPtr context, IntPtr track, int layer, ref EncoderStats stats);
+        [DllImport(WebRTC.Lib)]
         public static extern CodecInitializationResult ContextGetCodecInitializationResult(IntPtr context);
         [DllImport(WebRTC.Lib)]
+        [return: MarshalAs(UnmanagedType.U1)]
         public static extern bool GetHardwareEncoderSupport();
         [DllImport(WebRTC.Lib)]
-        public static extern void RegisterDebugLog(DelegateDebugLog func);
+        public static extern void SetLogLevel(LogLevel level);
+        [DllImport(WebRTC.Lib)]
+        public static extern int DrainLog([Out] LogRecord[] records, int capacity);
+        [DllImport(WebRTC.Lib)]
+        public static extern ulong GetDroppedLogCount();
+        [DllImport(WebRTC.Lib)]
+        public static extern void SetFrameTraceEnabled([MarshalAs(UnmanagedType.U1)] bool enabled);
+        [DllImport(WebRTC.Lib)]
+        public static extern void DumpFrameTrace(long windowUs, ref IntPtr json, ref int len);
+        [DllImport(WebRTC.Lib)]
+        public static extern void SetNetworkThreadPriority(NetworkThreadPriority priority);
         [DllImport(WebRTC.Lib)]
         public static extern IntPtr ContextCreate(int uid, EncoderType encoderType);
         [DllImport(WebRTC.Lib)]
+        public static extern IntPtr ContextCreateWithSharedFactory(int uid, EncoderType encoderType);
+        [DllImport(WebRTC.Lib)]
         public static extern void ContextDestroy(int uid);
         [DllImport(WebRTC.Lib)]
         public static extern IntPtr ContextCreatePeerConnection(IntPtr ptr);
@@ -405,15 +658,23 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern void PeerConnectionCollectStats(IntPtr ptr);
         [DllImport(WebRTC.Lib)]
+        public static extern void PeerConnectionSetStatsFilter(IntPtr ptr, RTCStatsFilterEntry[] entries, int count);
+        [DllImport(WebRTC.Lib)]
+        public static extern void PeerConnectionCollectFilteredStats(IntPtr ptr);
+        [DllImport(WebRTC.Lib)]
+        public static extern int PeerConnectionGetFilteredStats(IntPtr ptr, [Out] RTCStatsValue[] values, int capacity, ref long reportTimestampUs);
+        [DllImport(WebRTC.Lib)]
         public static extern void PeerConnectionGetLocalDescription(IntPtr ptr, ref RTCSessionDescription desc);
         [DllImport(WebRTC.Lib)]
         public static extern void PeerConnectionSetRemoteDescription(IntPtr ptr, ref RTCSessionDescription desc);
         [DllImport(WebRTC.Lib)]
         public static extern IntPtr PeerConnectionAddTrack(IntPtr pc, IntPtr track);
         [DllImport(WebRTC.Lib)]
+        public static extern IntPtr PeerConnectionAddSimulcastTrack(IntPtr pc, IntPtr track, int simulcastLayers);
+        [DllImport(WebRTC.Lib)]
         public static extern void PeerConnectionRemoveTrack(IntPtr pc, IntPtr sender);
         [DllImport(WebRTC.Lib)]
-        public static extern bool PeerConnectionAddIceCandidate(IntPtr ptr, ref RTCIceCandidate​ candidate);
+        public static extern void PeerConnectionAddIceCandidate(IntPtr ptr, ref RTCIceCandidate​ candidate);
         [DllImport(WebRTC.Lib)]
         public static extern RTCPeerConnectionState PeerConnectionState(IntPtr ptr);
         [DllImport(WebRTC.Lib)]
@@ -427,6 +688,8 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern IntPtr RtpTransceiverInterfaceGetTrack(IntPtr rtpTransceiverInterface);
         [DllImport(WebRTC.Lib)]
+        public static extern void RtpTransceiverInterfaceSetJitterBufferMinimumDelay(IntPtr rtpTransceiverInterface, double delaySeconds);
+        [DllImport(WebRTC.Lib)]
         public static extern int DataChannelGetID(IntPtr ptr);
         [DllImport(WebRTC.Lib)]
         public static extern IntPtr DataChannelGetLabel(IntPtr ptr);
@@ -435,6 +698,37 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern void DataChannelSendBinary(IntPtr ptr, [MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 2)] byte[] bytes, int size);
         [DllImport(WebRTC.Lib)]
+        public static extern int DataChannelSendBatch(IntPtr ptr, byte[] data, int size, int[] offsets, int count);
+        [DllImport(WebRTC.Lib)]
+        public static extern IntPtr DataChannelAcquireBuffer(IntPtr ptr, int capacity, ref IntPtr data);
+        [DllImport(WebRTC.Lib)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool DataChannelSendBuffer(IntPtr ptr, IntPtr buffer, int size);
+        [DllImport(WebRTC.Lib)]
+        public static extern void DataChannelReleaseBuffer(IntPtr ptr, IntPtr buffer);
+        [DllImport(WebRTC.Lib)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool DataChannelTrySendBinary(IntPtr ptr, [MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 2)] byte[] bytes, int size);
+        [DllImport(WebRTC.Lib)]
+        public static extern ulong DataChannelGetBufferedAmount(IntPtr ptr);
+        [DllImport(WebRTC.Lib)]
+        public static extern void DataChannelSetBufferedAmountThresholds(IntPtr ptr, ulong low, ulong high);
+        [DllImport(WebRTC.Lib)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool DataChannelPollBufferedAmountLow(IntPtr ptr);
+        [DllImport(WebRTC.Lib)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool DataChannelEnableChunking(IntPtr ptr, int chunkSize);
+        [DllImport(WebRTC.Lib)]
+        public static extern ulong DataChannelGetPendingChunkedSize(IntPtr ptr);
+        [DllImport(WebRTC.Lib)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool DataChannelEnableReceiveQueue(IntPtr ptr, int capacity);
+        [DllImport(WebRTC.Lib)]
+        public static extern int DataChannelReceiveMessages(IntPtr ptr, byte[] data, int size, int[] sizes, int count);
+        [DllImport(WebRTC.Lib)]
+        public static extern int DataChannelGetNextMessageSize(IntPtr ptr);
+        [DllImport(WebRTC.Lib)]
         public static extern void DataChannelClose(IntPtr ptr);
         [DllImport(WebRTC.Lib)]
         public static extern void DataChannelRegisterOnMessage(IntPtr ptr, DelegateNativeOnMessage callback);
@@ -443,16 +737,36 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern void DataChannelRegisterOnClose(IntPtr ptr, DelegateNativeOnClose callback);
         [DllImport(WebRTC.Lib)]
+        public static extern void DataChannelRegisterOnBufferedAmountLow(IntPtr ptr, DelegateNativeOnBufferedAmountLow callback);
+        [DllImport(WebRTC.Lib)]
         public static extern IntPtr ContextCreateVideoStream(IntPtr context, IntPtr rt, int width, int height);
         [DllImport(WebRTC.Lib)]
+        public static extern IntPtr ContextCreateSimulcastVideoStream(IntPtr context, IntPtr rt, int width, int height, int simulcastLayers);
+        [DllImport(WebRTC.Lib)]
         public static extern IntPtr ContextCreateAudioStream(IntPtr context);
         [DllImport(WebRTC.Lib)]
+        public static extern IntPtr ContextCreateVideoReceiver(IntPtr context, IntPtr track);
+        [DllImport(WebRTC.Lib)]
+        public static extern void ContextDeleteVideoReceiver(IntPtr context, IntPtr receiver);
+        [DllImport(WebRTC.Lib)]
+        public static extern IntPtr VideoReceiverAcquireFrame(IntPtr receiver, ref int width, ref int height);
+        [DllImport(WebRTC.Lib)]
         public static extern IntPtr ContextDeleteVideoStream(IntPtr context, IntPtr stream);
         [DllImport(WebRTC.Lib)]
         public static extern IntPtr ContextDeleteAudioStream(IntPtr context, IntPtr stream);
         [DllImport(WebRTC.Lib)]
         public static extern EncoderType ContextGetEncoderType(IntPtr context);
         [DllImport(WebRTC.Lib)]
+        public static extern void ContextSetBitratePolicy(IntPtr context, BitratePolicy policy);
+        [DllImport(WebRTC.Lib)]
+        public static extern void ContextGetVideoDecoderStats(IntPtr context, ref VideoDecoderStats stats);
+        [DllImport(WebRTC.Lib)]
+        public static extern void ContextStartStatsSampler(IntPtr context, int intervalMs, int sampleCount);
+        [DllImport(WebRTC.Lib)]
+        public static extern void ContextStopStatsSampler(IntPtr context);
+        [DllImport(WebRTC.Lib)]
+        public static extern int ContextGetStatsSamples(IntPtr context, IntPtr peerConnection, [Out] RTCStatsSample[] samples, int capacity);
+        [DllImport(WebRTC.Lib)]
         public static extern void MediaStreamAddTrack(IntPtr stream, IntPtr track);
         [DllImport(WebRTC.Lib)]
         public static extern void MediaStreamRemoveTrack(IntPtr stream, IntPtr track);
@@ -469,15 +783,27 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern IntPtr MediaStreamTrackGetID(IntPtr track);
         [DllImport(WebRTC.Lib)]
+        [return: MarshalAs(UnmanagedType.U1)]
         public static extern bool MediaStreamTrackGetEnabled(IntPtr track);
         [DllImport(WebRTC.Lib)]
-        public static extern void MediaStreamTrackSetEnabled(IntPtr track, bool enabled);
+        public static extern void MediaStreamTrackSetEnabled(IntPtr track, [MarshalAs(UnmanagedType.U1)] bool enabled);
         [DllImport(WebRTC.Lib)]
         public static extern void SetCurrentContext(IntPtr context);
         [DllImport(WebRTC.Lib)]
         public static extern IntPtr GetRenderEventFunc(IntPtr context);
         [DllImport(WebRTC.Lib)]
-        public static extern void ProcessAudio(float[] data, int size);
+        public static extern void ProcessAudio(float[] data, int size, int sampleRate, int channels);
+        [DllImport(WebRTC.Lib)]
+        public static extern void ContextProcessAudio(IntPtr context, IntPtr track, float[] data, int size, int sampleRate, int channels);
+        [DllImport(WebRTC.Lib)]
+        public static extern void ContextSetAudioTrackOpusSettings(IntPtr context, IntPtr track, ref OpusSettings settings);
+        [DllImport(WebRTC.Lib)]
+        public static extern void ContextSetAudioPacing(IntPtr context, [MarshalAs(UnmanagedType.U1)] bool enable);
+        [DllImport(WebRTC.Lib)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ContextGetAudioCaptureStats(IntPtr context, IntPtr track, ref AudioCaptureStats stats);
+        [DllImport(WebRTC.Lib)]
+        public static extern int ContextReadAudioPlayout(IntPtr context, float[] data, int size, int sampleRate, int channels);
     }
 
     internal static class VideoEncoderMethods
@@ -489,17 +815,28 @@ namespace Unity.WebRTC
             Finalize = 2,
         }
 
-        public static void InitializeEncoder(IntPtr callback)
+        // The render event carries the native track pointer so that each video track is encoded by its own encoder.
+        // IntPtr.Zero targets every video track of the context.
+        static readonly CommandBuffer s_commandBuffer = new CommandBuffer { name = "WebRTC VideoEncoder" };
+
+        static void IssuePluginEvent(IntPtr callback, VideoStreamRenderEventId eventId, IntPtr track)
+        {
+            s_commandBuffer.Clear();
+            s_commandBuffer.IssuePluginEventAndData(callback, (int)eventId, track);
+            Graphics.ExecuteCommandBuffer(s_commandBuffer);
+        }
+
+        public static void InitializeEncoder(IntPtr callback, IntPtr track)
         {
-            GL.IssuePluginEvent(callback, (int)VideoStreamRenderEventId.Initialize);
+            IssuePluginEvent(callback, VideoStreamRenderEventId.Initialize, track);
         }
-        public static void Encode(IntPtr callback)
+        public static void Encode(IntPtr callback, IntPtr track)
         {
-            GL.IssuePluginEvent(callback, (int)VideoStreamRenderEventId.Encode);
+            IssuePluginEvent(callback, VideoStreamRenderEventId.Encode, track);
         }
-        public static void FinalizeEncoder(IntPtr callback)
+        public static void FinalizeEncoder(IntPtr callback, IntPtr track)
         {
-            GL.IssuePluginEvent(callback, (int)VideoStreamRenderEventId.Finalize);
+            IssuePluginEvent(callback, VideoStreamRenderEventId.Finalize, track);
         }
     }
 }
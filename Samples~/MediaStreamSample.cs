@@ -266,7 +266,7 @@ public class MediaStreamSample : MonoBehaviour
     
     private void OnAudioFilterRead(float[] data, int channels)
     {
-        Audio.Update(data, data.Length);
+        Audio.Update(data, channels);
     }
 
     private void OnSetLocalSuccess(RTCPeerConnection pc)
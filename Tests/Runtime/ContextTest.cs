@@ -4,24 +4,6 @@ namespace Unity.WebRTC.RuntimeTest
 {
     class ContextTest
     {
-        [AOT.MonoPInvokeCallback(typeof(DelegateDebugLog))]
-        static void DebugLog(string str)
-        {
-            UnityEngine.Debug.Log(str);
-        }
-
-        [SetUp]
-        public void SetUp()
-        {
-            NativeMethods.RegisterDebugLog(DebugLog);
-        }
-
-        [TearDown]
-        public void TearDown()
-        {
-            NativeMethods.RegisterDebugLog(null);
-        }
-
         [Test]
         [Category("Context")]
         public void Context_CreateAndDelete()
@@ -71,5 +53,19 @@ namespace Unity.WebRTC.RuntimeTest
             context.DeletePeerConnection(peerPtr);
             context.Dispose();
         }
+
+        [Test]
+        [Category("Context")]
+        public void Context_ShareFactory()
+        {
+            var context1 = Context.Create(1, shareFactory: true);
+            var context2 = Context.Create(2, shareFactory: true);
+            var peerPtr1 = context1.CreatePeerConnection();
+            context1.DeletePeerConnection(peerPtr1);
+            context1.Dispose();
+            var peerPtr2 = context2.CreatePeerConnection();
+            context2.DeletePeerConnection(peerPtr2);
+            context2.Dispose();
+        }
     }
 }
@@ -32,6 +32,11 @@ namespace Unity.WebRTC.RuntimeTest
 
             // It is return -1 when channel is not connected.
             Assert.AreEqual(channel1.Id, -1);
+            Assert.AreEqual(0, channel1.BufferedAmount);
+            channel1.BufferedAmountLowThreshold = 1024;
+            channel1.BufferedAmountHighThreshold = 65536;
+            Assert.AreEqual(1024, channel1.BufferedAmountLowThreshold);
+            Assert.False(channel1.PollBufferedAmountLow());
 
             channel1.Close();
             peer.Close();
@@ -104,6 +109,50 @@ namespace Unity.WebRTC.RuntimeTest
             Assert.True(op11.IsCompleted);
             Assert.AreEqual(message3, message4);
 
+            var received = new System.Collections.Generic.List<byte[]>();
+            channel2.OnMessage = bytes => { received.Add(bytes); };
+            byte[] batch = {1, 2, 3, 4, 5, 6};
+            int[] offsets = {0, 1, 3};
+            Assert.AreEqual(3, channel1.Send(batch, batch.Length, offsets, offsets.Length));
+
+            var buffer = channel1.AcquireBuffer(message3.Length);
+            System.Runtime.InteropServices.Marshal.Copy(message3, 0, buffer.Data, message3.Length);
+            Assert.True(channel1.Send(buffer, message3.Length));
+            var op12 = new WaitUntilWithTimeout(() => received.Count == 4, 5000);
+            yield return op12;
+            Assert.True(op12.IsCompleted);
+            Assert.AreEqual(new byte[] {1}, received[0]);
+            Assert.AreEqual(new byte[] {2, 3}, received[1]);
+            Assert.AreEqual(new byte[] {4, 5, 6}, received[2]);
+            Assert.AreEqual(message3, received[3]);
+
+            Assert.True(channel2.EnableReceiveQueue(1024));
+            Assert.AreEqual(-1, channel2.NextMessageSize);
+            Assert.AreEqual(3, channel1.Send(batch, batch.Length, offsets, offsets.Length));
+            var op13 = new WaitUntilWithTimeout(() => channel2.NextMessageSize == 1, 5000);
+            yield return op13;
+            Assert.True(op13.IsCompleted);
+            var data = new byte[16];
+            var sizes = new int[8];
+            int count = 0;
+            var op14 = new WaitUntilWithTimeout(() => (count += channel2.ReceiveMessages(data, sizes)) == 3, 5000);
+            yield return op14;
+            Assert.True(op14.IsCompleted);
+            Assert.AreEqual(4, received.Count);
+
+            Assert.True(channel1.EnableChunking(16 * 1024));
+            Assert.True(channel2.EnableChunking(16 * 1024));
+            var large = new byte[1024 * 1024];
+            for (int i = 0; i < large.Length; i++)
+                large[i] = (byte)i;
+            channel1.Send(large);
+            var op15 = new WaitUntilWithTimeout(() => channel2.NextMessageSize == large.Length, 5000);
+            yield return op15;
+            Assert.True(op15.IsCompleted);
+            var reassembled = new byte[large.Length];
+            Assert.AreEqual(1, channel2.ReceiveMessages(reassembled, sizes));
+            Assert.AreEqual(large, reassembled);
+
             channel1.Close();
             channel2.Close();
 
@@ -51,6 +51,45 @@ namespace Unity.WebRTC.RuntimeTest
             audioStream.Dispose();
         }
 
+        [Test]
+        public void MediaStreamTest_AudioCaptureStats()
+        {
+            var audioStream = Audio.CaptureStream();
+            var track = audioStream.GetAudioTracks()[0];
+            Audio.Update(track, new float[2048], 2, 48000);
+            var stats = Audio.GetCaptureStats(track);
+            Assert.AreEqual(30.0, stats.targetFillLevelMs);
+            Assert.AreEqual(0, stats.overrunSamples);
+            audioStream.Dispose();
+        }
+
+        [Test]
+        public void MediaStreamTest_PacedAudioCapture()
+        {
+            Audio.SetPacing(true);
+            var audioStream = Audio.CaptureStream();
+            Audio.SetPacing(false);
+            var track = audioStream.GetAudioTracks()[0];
+            Audio.Update(track, new float[2048], 2, 48000);
+            var stats = Audio.GetCaptureStats(track);
+            Assert.AreEqual(0, stats.overrunSamples);
+            audioStream.Dispose();
+        }
+
+        [Test]
+        public void MediaStreamTest_SetOpusSettings()
+        {
+            var audioStream = Audio.CaptureStream();
+            var track = audioStream.GetAudioTracks()[0];
+            var settings = OpusSettings.Default;
+            settings.bitrate = 24000;
+            settings.frameSizeMs = 10;
+            settings.complexity = 3;
+            Audio.SetOpusSettings(track, settings);
+            Audio.SetOpusSettings(OpusSettings.Default);
+            audioStream.Dispose();
+        }
+
 
         [UnityTest]
         [Timeout(5000)]
@@ -1,5 +1,6 @@
 using System;
 using System.Collections;
+using System.Runtime.InteropServices;
 using NUnit.Framework;
 using UnityEditor;
 using UnityEngine;
@@ -30,24 +31,6 @@ namespace Unity.WebRTC.RuntimeTest
             return renderTexture;
         }
 
-        [AOT.MonoPInvokeCallback(typeof(DelegateDebugLog))]
-        protected static void DebugLog(string str)
-        {
-            Debug.Log(str);
-        }
-
-        [SetUp]
-        public void Init()
-        {
-            NativeMethods.RegisterDebugLog(DebugLog);
-        }
-
-        [TearDown]
-        public void CleanUp()
-        {
-            NativeMethods.RegisterDebugLog(null);
-        }
-
         [OneTimeSetUp]
         public void OneTimeInit()
         {
@@ -105,6 +88,33 @@ namespace Unity.WebRTC.RuntimeTest
             UnityEngine.Object.DestroyImmediate(renderTexture);
         }
 
+        [Test]
+        public void CreateAndDeleteVideoReceiver()
+        {
+            var context = NativeMethods.ContextCreate(0, encoderType);
+            const int width = 1280;
+            const int height = 720;
+            var renderTexture = CreateRenderTexture(width, height);
+            var stream =
+                NativeMethods.ContextCreateVideoStream(context, renderTexture.GetNativeTexturePtr(), width, height);
+            int trackSize = 0;
+            IntPtr trackNativePtr = NativeMethods.MediaStreamGetVideoTracks(stream, ref trackSize);
+            IntPtr[] tracksPtr = new IntPtr[trackSize];
+            System.Runtime.InteropServices.Marshal.Copy(trackNativePtr, tracksPtr, 0, trackSize);
+            System.Runtime.InteropServices.Marshal.FreeCoTaskMem(trackNativePtr);
+
+            var receiver = NativeMethods.ContextCreateVideoReceiver(context, tracksPtr[0]);
+            Assert.AreNotEqual(IntPtr.Zero, receiver);
+            int frameWidth = 0;
+            int frameHeight = 0;
+            Assert.AreEqual(IntPtr.Zero, NativeMethods.VideoReceiverAcquireFrame(receiver, ref frameWidth, ref frameHeight));
+            NativeMethods.ContextDeleteVideoReceiver(context, receiver);
+            NativeMethods.ContextDeleteVideoStream(context, stream);
+            NativeMethods.ContextDestroy(0);
+
+            UnityEngine.Object.DestroyImmediate(renderTexture);
+        }
+
         [Test]
         public void MediaStreamGetAudioTracks()
         {
@@ -137,6 +147,27 @@ namespace Unity.WebRTC.RuntimeTest
             NativeMethods.ContextDestroy(0);
         }
 
+        [Test]
+        public void ProcessAudioPerTrack()
+        {
+            var context = NativeMethods.ContextCreate(0, encoderType);
+            var stream1 = NativeMethods.ContextCreateAudioStream(context);
+            var stream2 = NativeMethods.ContextCreateAudioStream(context);
+            Assert.AreNotEqual(stream1, stream2);
+            int trackSize = 0;
+            IntPtr trackNativePtr = NativeMethods.MediaStreamGetAudioTracks(stream1, ref trackSize);
+            IntPtr[] tracksPtr = new IntPtr[trackSize];
+            System.Runtime.InteropServices.Marshal.Copy(trackNativePtr, tracksPtr, 0, trackSize);
+            System.Runtime.InteropServices.Marshal.FreeCoTaskMem(trackNativePtr);
+
+            var data = new float[2048];
+            NativeMethods.ContextProcessAudio(context, tracksPtr[0], data, data.Length, 44100, 2);
+            NativeMethods.ContextProcessAudio(context, IntPtr.Zero, data, data.Length, 48000, 6);
+            NativeMethods.ContextDeleteAudioStream(context, stream1);
+            NativeMethods.ContextDeleteAudioStream(context, stream2);
+            NativeMethods.ContextDestroy(0);
+        }
+
 
         [Test]
         public void CallGetRenderEventFunc()
@@ -158,14 +189,19 @@ namespace Unity.WebRTC.RuntimeTest
             var stream =
                 NativeMethods.ContextCreateVideoStream(context, renderTexture.GetNativeTexturePtr(), width, height);
             var callback = NativeMethods.GetRenderEventFunc(context);
+            int trackSize = 0;
+            var tracksPtr = NativeMethods.MediaStreamGetVideoTracks(stream, ref trackSize);
+            var tracks = new IntPtr[trackSize];
+            Marshal.Copy(tracksPtr, tracks, 0, trackSize);
+            Marshal.FreeCoTaskMem(tracksPtr);
+            Assert.AreEqual(1, trackSize);
 
-            // TODO::
             // note:: You must call `InitializeEncoder` method after `NativeMethods.ContextCaptureVideoStream`
-            VideoEncoderMethods.InitializeEncoder(callback);
+            VideoEncoderMethods.InitializeEncoder(callback, tracks[0]);
             yield return new WaitForSeconds(1.0f);
-            VideoEncoderMethods.Encode(callback);
+            VideoEncoderMethods.Encode(callback, tracks[0]);
             yield return new WaitForSeconds(1.0f);
-            VideoEncoderMethods.FinalizeEncoder(callback);
+            VideoEncoderMethods.FinalizeEncoder(callback, tracks[0]);
             yield return new WaitForSeconds(1.0f);
 
             NativeMethods.ContextDeleteVideoStream(context, stream);
@@ -61,6 +61,24 @@ namespace Unity.WebRTC.RuntimeTest
             peer.Close();
         }
 
+        [Test]
+        [Category("PeerConnection")]
+        public void PeerConnection_ConstructWithLowLatencyConfig()
+        {
+            var config = GetConfiguration();
+            config.audioJitterBufferMaxPackets = 10;
+            config.audioJitterBufferMinDelayMs = 20;
+            config.audioJitterBufferFastAccelerate = true;
+            var peer = new RTCPeerConnection(ref config);
+
+            var config2 = peer.GetConfiguration();
+            Assert.AreEqual(config.audioJitterBufferMaxPackets, config2.audioJitterBufferMaxPackets);
+            Assert.AreEqual(config.audioJitterBufferMinDelayMs, config2.audioJitterBufferMinDelayMs);
+            Assert.AreEqual(config.audioJitterBufferFastAccelerate, config2.audioJitterBufferFastAccelerate);
+
+            peer.Close();
+        }
+
         [Test]
         [Category("PeerConnection")]
         public void PeerConnection_SetConfiguration()
@@ -88,6 +106,56 @@ namespace Unity.WebRTC.RuntimeTest
             peer.Close();
         }
 
+        [UnityTest]
+        [Category("PeerConnection")]
+        public IEnumerator PeerConnection_CollectFilteredStats()
+        {
+            var config = GetConfiguration();
+            var peer = new RTCPeerConnection(ref config);
+            peer.SetStatsFilter(new[]
+            {
+                new RTCStatsFilterEntry {type = "peer-connection", member = "dataChannelsOpened"},
+                new RTCStatsFilterEntry {type = "outbound-rtp", member = "bytesSent", perSecond = true}
+            });
+            peer.CollectFilteredStats();
+
+            var values = new RTCStatsValue[4];
+            long timestampUs = 0;
+            int count = 0;
+            var op = new WaitUntilWithTimeout(() =>
+            {
+                count = peer.GetFilteredStats(values, out timestampUs);
+                return timestampUs != 0;
+            }, 5000);
+            yield return op;
+            Assert.True(op.IsCompleted);
+            Assert.AreEqual(1, count);
+            Assert.AreEqual(0, values[0].entry);
+            Assert.AreEqual(0.0, values[0].value);
+
+            peer.Close();
+        }
+
+        [UnityTest]
+        [Category("PeerConnection")]
+        public IEnumerator PeerConnection_GetStatsSamples()
+        {
+            var config = GetConfiguration();
+            var peer = new RTCPeerConnection(ref config);
+            var samples = new RTCStatsSample[4];
+            Assert.AreEqual(0, peer.GetStatsSamples(samples));
+
+            WebRTC.StartStatsSampler(100, samples.Length);
+            var op = new WaitUntilWithTimeout(() => peer.GetStatsSamples(samples) > 0, 5000);
+            yield return op;
+            Assert.True(op.IsCompleted);
+            Assert.AreNotEqual(0, samples[0].timestampUs);
+            Assert.AreEqual(0.0, samples[0].sendBitrate);
+            WebRTC.StopStatsSampler();
+
+            peer.Close();
+        }
+
         [UnityTest]
         [Category("PeerConnection")]
 